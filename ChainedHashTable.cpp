@@ -0,0 +1,264 @@
+/*
+// ChainedHashTable.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Separate chaining through 4-entry home buckets and pooled overflow blocks.
+*/
+
+#include "ChainedHashTable.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+namespace std {
+
+   ChainedHashTable::ChainedHashTable(size_t initCapacity, double maxLoad)
+       : maxLoad(maxLoad > 0 ? maxLoad : DEFAULT_MAX_LOAD) {
+      const size_t bucketCount = (initCapacity + SLOTS - 1) / SLOTS;
+      buckets.resize(std::bit_ceil(std::max(bucketCount, MIN_BUCKETS)));
+      floorBuckets = buckets.size();
+   }
+
+   uint64_t ChainedHashTable::hashOf(std::string_view key) {
+      return std::hash<std::string_view>{}(key);
+   }
+
+   // Top 16 bits, independent of the low bits that pick the bucket
+   uint16_t ChainedHashTable::tagOf(uint64_t hash) {
+      return static_cast<uint16_t>(hash >> 48);
+   }
+
+   size_t ChainedHashTable::bucketOf(uint64_t hash) const {
+      return hash & (buckets.size() - 1);
+   }
+
+   // The home bucket itself for NONE, otherwise an overflow block of its chain
+   ChainedHashTable::Group& ChainedHashTable::groupAt(size_t bucket, uint32_t block) {
+      return block == NONE ? buckets[bucket] : blocks[block];
+   }
+
+   const ChainedHashTable::Group& ChainedHashTable::groupAt(size_t bucket, uint32_t block) const {
+      return block == NONE ? buckets[bucket] : blocks[block];
+   }
+
+   bool ChainedHashTable::find(std::string_view key, uint64_t hash, uint32_t& block, size_t& slot) const {
+      const uint16_t tag = tagOf(hash);
+      const size_t bucket = bucketOf(hash);
+      for (uint32_t at = NONE;;) {
+         const Group& group = groupAt(bucket, at);
+         for (size_t s = 0; s < group.count; ++s) {
+            if (group.tags[s] != tag) continue;
+            const Entry& entry = keyStore[group.entries[s]];
+            if (entry.hash == hash && entry.key == key) {
+               block = at;
+               slot = s;
+               return true;
+            }
+         }
+         if (group.next == NONE) return false;
+         at = group.next;
+      }
+   }
+
+   /*
+    * Add an entry at the end of bucket's chain.  When the last group is full
+    * a block is linked on, reusing a freed one from the pool if there is one.
+    */
+   void ChainedHashTable::append(size_t bucket, uint32_t entry, size_t value, uint16_t tag) {
+      uint32_t last = NONE;
+      while (groupAt(bucket, last).next != NONE) last = groupAt(bucket, last).next;
+      if (groupAt(bucket, last).count == SLOTS) {
+         uint32_t fresh;
+         if (!freeBlocks.empty()) {
+            fresh = freeBlocks.back();
+            freeBlocks.pop_back();
+            blocks[fresh] = Group{};
+         } else {
+            fresh = static_cast<uint32_t>(blocks.size());
+            blocks.emplace_back(); // may move the pool, so groups are looked up again below
+         }
+         ++m_blocksInUse;
+         groupAt(bucket, last).next = fresh;
+         last = fresh;
+      }
+      Group& group = groupAt(bucket, last);
+      group.tags[group.count] = tag;
+      group.entries[group.count] = entry;
+      group.values[group.count] = value;
+      ++group.count;
+   }
+
+   /*
+    * Rebuild into bucketCount buckets from the stored hashes (no key is
+    * rehashed).  The pool and the key store are rebuilt too, so blocks and
+    * key slots freed by removes are given back.
+    */
+   void ChainedHashTable::rehashTo(size_t bucketCount) {
+      std::vector<Group> oldBuckets = std::move(buckets);
+      std::vector<Group> oldBlocks = std::move(blocks);
+      std::vector<Entry> oldKeys = std::move(keyStore);
+      buckets.assign(bucketCount, Group{});
+      blocks = {};
+      freeBlocks = {};
+      keyStore = {};
+      freeEntries = {};
+      m_blocksInUse = 0;
+      keyStore.reserve(m_size);
+
+      for (const Group& home : oldBuckets) {
+         for (const Group* group = &home;; group = &oldBlocks[group->next]) {
+            for (size_t s = 0; s < group->count; ++s) {
+               const uint32_t entry = static_cast<uint32_t>(keyStore.size());
+               keyStore.push_back(std::move(oldKeys[group->entries[s]]));
+               append(bucketOf(keyStore.back().hash), entry, group->values[s], group->tags[s]);
+            }
+            if (group->next == NONE) break;
+         }
+      }
+      ++m_resizes;
+   }
+
+   /*
+    * Insert a key-value pair.  Rejects duplicates.  Doubles the bucket count
+    * first if the new entry would take the table past maxLoad.
+    */
+   bool ChainedHashTable::insert(std::string_view key, const size_t& value) {
+      const uint64_t hash = hashOf(key);
+      uint32_t block = NONE;
+      size_t slot = 0;
+      if (find(key, hash, block, slot)) return false;
+
+      while (static_cast<double>(m_size + 1) > static_cast<double>(capacity()) * maxLoad) {
+         rehashTo(buckets.size() * 2);
+      }
+      uint32_t entry;
+      if (!freeEntries.empty()) {
+         entry = freeEntries.back();
+         freeEntries.pop_back();
+         keyStore[entry].key.assign(key);
+         keyStore[entry].hash = hash;
+      } else {
+         entry = static_cast<uint32_t>(keyStore.size());
+         keyStore.push_back(Entry{std::string(key), hash});
+      }
+      append(bucketOf(hash), entry, value, tagOf(hash));
+      ++m_size;
+      return true;
+   }
+
+   /*
+    * Remove key by moving the last entry of its chain into its slot; a block
+    * left empty goes back to the pool.  Halves the bucket count once the
+    * table is under a quarter of maxLoad.
+    */
+   bool ChainedHashTable::remove(std::string_view key) {
+      const uint64_t hash = hashOf(key);
+      uint32_t block = NONE;
+      size_t slot = 0;
+      if (!find(key, hash, block, slot)) return false;
+
+      const size_t bucket = bucketOf(hash);
+      uint32_t last = NONE, beforeLast = NONE;
+      while (groupAt(bucket, last).next != NONE) {
+         beforeLast = last;
+         last = groupAt(bucket, last).next;
+      }
+      Group& hole = groupAt(bucket, block);
+      Group& tail = groupAt(bucket, last);
+      const uint32_t entry = hole.entries[slot];
+      const size_t end = tail.count - 1u;
+      hole.tags[slot] = tail.tags[end];
+      hole.entries[slot] = tail.entries[end];
+      hole.values[slot] = tail.values[end];
+      --tail.count;
+      if (tail.count == 0 && last != NONE) {
+         groupAt(bucket, beforeLast).next = NONE;
+         freeBlocks.push_back(last);
+         --m_blocksInUse;
+      }
+
+      keyStore[entry].key.clear();
+      freeEntries.push_back(entry);
+      --m_size;
+      if (buckets.size() > floorBuckets &&
+          static_cast<double>(m_size) < static_cast<double>(capacity()) * maxLoad / 4) {
+         rehashTo(buckets.size() / 2);
+      }
+      return true;
+   }
+
+   bool ChainedHashTable::contains(std::string_view key) const {
+      return get(key).has_value();
+   }
+
+   std::optional<size_t> ChainedHashTable::get(std::string_view key) const {
+      const uint64_t hash = hashOf(key);
+      uint32_t block = NONE;
+      size_t slot = 0;
+      if (!find(key, hash, block, slot)) return std::nullopt;
+      return groupAt(bucketOf(hash), block).values[slot];
+   }
+
+   /*
+    * Reference to the value for key, inserting 0 if absent.  Any later insert
+    * or remove may move entries, which invalidates the reference.
+    */
+   size_t& ChainedHashTable::operator[](std::string_view key) {
+      const uint64_t hash = hashOf(key);
+      uint32_t block = NONE;
+      size_t slot = 0;
+      if (!find(key, hash, block, slot)) {
+         insert(key, 0);
+         find(key, hash, block, slot);
+      }
+      return groupAt(bucketOf(hash), block).values[slot];
+   }
+
+   // Size for count entries at maxLoad; the table will not shrink below this
+   void ChainedHashTable::reserve(size_t count) {
+      const double slotsNeeded = std::ceil(static_cast<double>(count) / maxLoad);
+      const size_t bucketCount = std::bit_ceil(std::max((static_cast<size_t>(slotsNeeded) + SLOTS - 1) / SLOTS, MIN_BUCKETS));
+      floorBuckets = std::max(floorBuckets, bucketCount);
+      if (bucketCount > buckets.size()) rehashTo(bucketCount);
+      keyStore.reserve(count);
+   }
+
+   std::vector<std::string> ChainedHashTable::keys() const {
+      std::vector<std::string> result;
+      result.reserve(m_size);
+      for (const Group& home : buckets) {
+         for (const Group* group = &home;; group = &blocks[group->next]) {
+            for (size_t s = 0; s < group->count; ++s) result.push_back(keyStore[group->entries[s]].key);
+            if (group->next == NONE) break;
+         }
+      }
+      return result;
+   }
+
+   double ChainedHashTable::alpha() const {
+      return static_cast<double>(m_size) / static_cast<double>(capacity());
+   }
+
+   size_t ChainedHashTable::capacity() const {
+      return buckets.size() * SLOTS;
+   }
+
+   size_t ChainedHashTable::size() const {
+      return m_size;
+   }
+
+   size_t ChainedHashTable::overflowBlocks() const {
+      return m_blocksInUse;
+   }
+
+   size_t ChainedHashTable::resizes() const {
+      return m_resizes;
+   }
+
+}
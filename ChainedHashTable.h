@@ -0,0 +1,108 @@
+/*
+// ChainedHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Separate-chaining hash table: an alternative to HashTable's open addressing
+// for heavy delete churn and sizes that rise and fall.  Each home bucket is a
+// 64-byte group holding up to SLOTS entries inline (16-bit hash tag, index
+// into a separate key store, and the value).  A full bucket spills into
+// overflow blocks of the same shape, taken from one pooled vector and linked
+// by index, so a chain is a few cache lines rather than a node per entry.
+// A chain is kept dense: every group but its last is full.  remove() moves
+// the chain's last entry into the hole and returns an emptied block to the
+// pool, so there are no tombstones and a lookup never walks past empty slots.
+// The table grows once it holds maxLoad entries per inline slot (1.0 by
+// default, twice HashTable's 0.5) and halves once under a quarter of that,
+// though never below the size given to the constructor or reserve().  Each
+// resize also rebuilds the key store without its removed keys.
+// Unlike HashTable, every value (including 9999) is accepted.
+// Actionable members include:
+// - insert / remove / contains / get / operator[] - same meaning as on HashTable
+// - reserve - size the table for a number of entries up front
+// - alpha / capacity / size - entries per inline slot, inline slot count, entry count
+// - overflowBlocks / resizes - pooled blocks in use, and resize count
+*/
+#ifndef PROJECT4_HASHTABLE_CHAINEDHASHTABLE_H
+#define PROJECT4_HASHTABLE_CHAINEDHASHTABLE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    class ChainedHashTable {
+    public:
+        static constexpr size_t SLOTS = 4;
+        static constexpr double DEFAULT_MAX_LOAD = 1.0;
+
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX; // no block: the home bucket, or the end of a chain
+        static constexpr size_t MIN_BUCKETS = 2;
+
+        // One cache line, used both as a home bucket and as an overflow block;
+        // slots [0, count) are in use
+        struct alignas(64) Group {
+            size_t values[SLOTS] = {};
+            uint32_t entries[SLOTS] = {};
+            uint16_t tags[SLOTS] = {};
+            uint32_t next = NONE; // overflow block, or NONE at the end of the chain
+            uint8_t count = 0;
+        };
+
+        struct Entry {
+            std::string key;
+            uint64_t hash = 0;
+        };
+
+        std::vector<Group> buckets;
+        std::vector<Group> blocks;       // overflow pool
+        std::vector<uint32_t> freeBlocks;
+        std::vector<Entry> keyStore;
+        std::vector<uint32_t> freeEntries;
+
+        double maxLoad;
+        size_t floorBuckets;             // shrinking stops here
+        size_t m_size = 0;
+        size_t m_blocksInUse = 0;
+        size_t m_resizes = 0;
+
+        static uint64_t hashOf(std::string_view key);
+        static uint16_t tagOf(uint64_t hash);
+
+        size_t bucketOf(uint64_t hash) const;
+        Group& groupAt(size_t bucket, uint32_t block);
+        const Group& groupAt(size_t bucket, uint32_t block) const;
+        bool find(std::string_view key, uint64_t hash, uint32_t& block, size_t& slot) const;
+        void append(size_t bucket, uint32_t entry, size_t value, uint16_t tag);
+        void rehashTo(size_t bucketCount);
+
+    public:
+        explicit ChainedHashTable(size_t initCapacity = 8, double maxLoad = DEFAULT_MAX_LOAD);
+
+        bool insert(std::string_view key, const size_t& value);
+        bool remove(std::string_view key);
+        bool contains(std::string_view key) const;
+        std::optional<size_t> get(std::string_view key) const;
+        size_t& operator[](std::string_view key);
+
+        void reserve(size_t count);
+        std::vector<std::string> keys() const;
+
+        double alpha() const;
+        size_t capacity() const;
+        size_t size() const;
+
+        size_t overflowBlocks() const;
+        size_t resizes() const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_CHAINEDHASHTABLE_H
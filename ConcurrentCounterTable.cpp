@@ -0,0 +1,159 @@
+/*
+// ConcurrentCounterTable.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Linear-probing counter table with CAS slot claims and atomic counts.
+*/
+
+#include "ConcurrentCounterTable.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <thread>
+
+namespace std {
+
+   // Power-of-two slot count with expectedKeys at most MAX_LOAD full
+   ConcurrentCounterTable::ConcurrentCounterTable(size_t expectedKeys) {
+      size_t wanted = static_cast<size_t>(static_cast<double>(expectedKeys) / MAX_LOAD) + 1;
+      m_capacity = std::bit_ceil(std::max<size_t>(wanted, 8));
+      m_maxKeys = static_cast<size_t>(static_cast<double>(m_capacity) * MAX_LOAD);
+      slots = std::make_unique<Slot[]>(m_capacity);
+   }
+
+   uint64_t ConcurrentCounterTable::hashOf(std::string_view key) {
+      return std::hash<std::string_view>{}(key);
+   }
+
+   /*
+    * Published slot holding key, or nullptr.  Probing stops at the first
+    * EMPTY slot: keys are never removed, so a key's slot always comes before
+    * it.  A BUSY slot might be this key being claimed; it is not published
+    * yet, so it is skipped as a mismatch.
+    */
+   const ConcurrentCounterTable::Slot* ConcurrentCounterTable::find(std::string_view key, uint64_t hash) const {
+      const size_t mask = m_capacity - 1;
+      for (size_t i = 0, index = hash & mask; i < m_capacity; ++i, index = (index + 1) & mask) {
+         const Slot& slot = slots[index];
+         SlotState state = slot.state.load(std::memory_order_acquire);
+         if (state == SlotState::EMPTY) return nullptr;
+         if (state == SlotState::READY && slot.hash == hash && slot.key == key) return &slot;
+      }
+      return nullptr;
+   }
+
+   /*
+    * Add by to key's count.  A thread that reaches an EMPTY slot reserves
+    * room under m_maxKeys, then races to claim the slot; the loser gives the
+    * reservation back and looks at the slot again, since the winner may have
+    * been claiming it for the same key.  A BUSY slot is waited on for the
+    * same reason.  Returns false only when a new key does not fit.
+    */
+   bool ConcurrentCounterTable::add(std::string_view key, uint64_t hash, size_t by) {
+      const size_t mask = m_capacity - 1;
+      size_t index = hash & mask;
+      for (size_t i = 0; i < m_capacity;) {
+         Slot& slot = slots[index];
+         SlotState state = slot.state.load(std::memory_order_acquire);
+         if (state == SlotState::EMPTY) {
+            if (m_size.fetch_add(1, std::memory_order_relaxed) >= m_maxKeys) {
+               m_size.fetch_sub(1, std::memory_order_relaxed);
+               return false;
+            }
+            if (slot.state.compare_exchange_strong(state, SlotState::BUSY, std::memory_order_acquire)) {
+               slot.hash = hash;
+               slot.key.assign(key);
+               slot.count.store(by, std::memory_order_relaxed);
+               slot.state.store(SlotState::READY, std::memory_order_release);
+               return true;
+            }
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+            continue; // state now holds what the winner wrote
+         }
+         if (state == SlotState::BUSY) {
+            std::this_thread::yield();
+            continue;
+         }
+         if (slot.hash == hash && slot.key == key) {
+            slot.count.fetch_add(by, std::memory_order_relaxed);
+            return true;
+         }
+         ++i;
+         index = (index + 1) & mask;
+      }
+      return false;
+   }
+
+   bool ConcurrentCounterTable::increment(std::string_view key, size_t by) {
+      return add(key, hashOf(key), by);
+   }
+
+   /*
+    * Add every count of a thread-local table.  Entries are taken MERGE_GROUP
+    * at a time: each entry's home slot is prefetched as it is hashed, then
+    * the group is applied in slot order, so neighbouring keys share lines
+    * and the misses of a whole group overlap.  Returns false if some new key
+    * did not fit; every other entry is still added.
+    */
+   bool ConcurrentCounterTable::merge(const HashTable& local) {
+      struct Pending {
+         std::string_view key;
+         uint64_t hash;
+         size_t count;
+      };
+      std::array<Pending, MERGE_GROUP> group;
+      size_t pending = 0;
+      bool ok = true;
+      const size_t mask = m_capacity - 1;
+
+      auto flush = [&] {
+         std::sort(group.begin(), group.begin() + pending,
+                   [mask](const Pending& a, const Pending& b) { return (a.hash & mask) < (b.hash & mask); });
+         for (size_t i = 0; i < pending; ++i) ok &= add(group[i].key, group[i].hash, group[i].count);
+         pending = 0;
+      };
+
+      for (const auto& [key, count] : local) {
+         uint64_t hash = hashOf(key);
+         __builtin_prefetch(&slots[hash & mask]);
+         group[pending++] = {key, hash, count};
+         if (pending == MERGE_GROUP) flush();
+      }
+      flush();
+      return ok;
+   }
+
+   bool ConcurrentCounterTable::merge(const ConcurrentCounterTable& other) {
+      bool ok = true;
+      for (size_t i = 0; i < other.m_capacity; ++i) {
+         const Slot& slot = other.slots[i];
+         if (slot.state.load(std::memory_order_acquire) != SlotState::READY) continue;
+         ok &= add(slot.key, slot.hash, slot.count.load(std::memory_order_relaxed));
+      }
+      return ok;
+   }
+
+   std::optional<size_t> ConcurrentCounterTable::get(std::string_view key) const {
+      const Slot* slot = find(key, hashOf(key));
+      if (slot == nullptr) return std::nullopt;
+      return slot->count.load(std::memory_order_relaxed);
+   }
+
+   bool ConcurrentCounterTable::contains(std::string_view key) const {
+      return find(key, hashOf(key)) != nullptr;
+   }
+
+   size_t ConcurrentCounterTable::size() const {
+      return m_size.load(std::memory_order_relaxed);
+   }
+
+   size_t ConcurrentCounterTable::capacity() const {
+      return m_capacity;
+   }
+
+}
@@ -0,0 +1,105 @@
+/*
+// ConcurrentCounterTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Lock-free key -> count table for frequency counting from many threads at
+// once (the `ht[key]++` pattern without a global lock).  Keys are never
+// removed, so the table uses plain linear probing over a fixed array of
+// one-cache-line slots:
+// - a thread that finds its key bumps the count with an atomic fetch_add
+// - a thread that reaches an empty slot claims it with a compare-and-swap on
+//   the slot state (EMPTY -> BUSY), writes the key, then publishes it (READY);
+//   threads probing past a BUSY slot wait for it to be published
+// Capacity is fixed at construction; once MAX_LOAD of the slots hold keys,
+// increment() of a new key returns false instead of resizing.
+// merge() folds a thread-local HashTable of counts in, grouping entries by
+// home slot and prefetching each group's slots before touching them.
+// Actionable members include:
+// - increment - add to a key's count, claiming a slot for a new key
+// - merge - add every count of a local HashTable or another counter table
+// - get / contains - read a count (exact once writers have finished)
+// - forEach - visit every (key, count)
+// - size / capacity - keys claimed, and slot count
+*/
+#ifndef PROJECT4_HASHTABLE_CONCURRENTCOUNTERTABLE_H
+#define PROJECT4_HASHTABLE_CONCURRENTCOUNTERTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "HashTable.h"
+
+namespace std {
+
+    class ConcurrentCounterTable {
+    public:
+        static constexpr double MAX_LOAD = 0.75;
+        static constexpr size_t MERGE_GROUP = 32;
+
+    private:
+        enum class SlotState : uint8_t {
+            EMPTY,
+            BUSY,  // claimed, key being written
+            READY
+        };
+
+        struct alignas(64) Slot {
+            std::atomic<SlotState> state{SlotState::EMPTY};
+            std::atomic<size_t> count{0};
+            uint64_t hash = 0;
+            std::string key;
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        size_t m_capacity;
+        size_t m_maxKeys;
+        std::atomic<size_t> m_size{0};
+
+        static uint64_t hashOf(std::string_view key);
+        const Slot* find(std::string_view key, uint64_t hash) const;
+        bool add(std::string_view key, uint64_t hash, size_t by);
+
+    public:
+        explicit ConcurrentCounterTable(size_t expectedKeys = 1024);
+        ConcurrentCounterTable(const ConcurrentCounterTable&) = delete;
+        ConcurrentCounterTable& operator=(const ConcurrentCounterTable&) = delete;
+
+        bool increment(std::string_view key, size_t by = 1);
+        bool merge(const HashTable& local);
+        bool merge(const ConcurrentCounterTable& other);
+
+        std::optional<size_t> get(std::string_view key) const;
+        bool contains(std::string_view key) const;
+
+        template<typename Visitor>
+        void forEach(Visitor&& visit) const;
+
+        size_t size() const;
+        size_t capacity() const;
+    };
+
+    /*
+     * Call visit(key, count) for every published key.  Safe while other
+     * threads increment; counts are then a snapshot per slot, not a
+     * consistent cut of the whole table.
+     */
+    template<typename Visitor>
+    void ConcurrentCounterTable::forEach(Visitor&& visit) const {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            const Slot& slot = slots[i];
+            if (slot.state.load(std::memory_order_acquire) != SlotState::READY) continue;
+            visit(std::string_view(slot.key), slot.count.load(std::memory_order_relaxed));
+        }
+    }
+
+}
+
+#endif // PROJECT4_HASHTABLE_CONCURRENTCOUNTERTABLE_H
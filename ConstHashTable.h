@@ -0,0 +1,189 @@
+/*
+// ConstHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Fixed key/value dictionary (command names, header names, ...) whose hash
+// and slot placement are computed entirely by the compiler.  The table is
+// built from a literal list of pairs by a consteval constructor, so nothing
+// runs at startup and the whole table lives in read-only data.
+// Placement is the same pilot scheme FrozenHashTable uses at run time: keys
+// are hashed with FNV-1a, split into groups of about KEYS_PER_GROUP, and each
+// group (largest first) gets the first pilot that sends all of its keys to
+// free slots.  Keys are hashed once and bucketed by group once per seed, so
+// construction stays near O(N log N) and a few hundred keys fit well inside
+// the compiler's constant-evaluation step limit.  N keys fill exactly N slots, so get() is one hash, one pilot
+// read and one key comparison.
+// A duplicate key, or a key set no seed can place, stops the compile with an
+// error naming buildFailed.
+// Usage:
+//     constexpr ConstHashTable commands({{"GET", 1}, {"SET", 2}, {"DEL", 3}});
+//     static_assert(commands.get("SET") == 2u);
+// Actionable members include:
+// - get / contains - same interface as HashTable, usable in constant expressions
+// - size - number of entries (N)
+*/
+#ifndef PROJECT4_HASHTABLE_CONSTHASHTABLE_H
+#define PROJECT4_HASHTABLE_CONSTHASHTABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace std {
+
+    template<size_t N>
+    class ConstHashTable {
+    public:
+        using Entry = std::pair<std::string_view, size_t>;
+
+        static constexpr size_t KEYS_PER_GROUP = 4;
+        static constexpr size_t GROUPS = N == 0 ? 1 : (N + KEYS_PER_GROUP - 1) / KEYS_PER_GROUP;
+        static constexpr size_t MAX_SEEDS = 8;
+
+    private:
+        static constexpr uint64_t H2_SALT = 0x9e3779b97f4a7c15ULL;
+
+        uint64_t seed = 0;
+        std::array<uint32_t, GROUPS> pilots{};
+        std::array<Entry, N> slots{};
+
+        static constexpr uint64_t fnv1a(std::string_view key) {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (char c : key) {
+                h ^= static_cast<unsigned char>(c);
+                h *= 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        // 64-bit finalizer (splitmix64)
+        static constexpr uint64_t mix(uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        static constexpr size_t reduce(uint64_t h, size_t range) {
+            return static_cast<size_t>((static_cast<unsigned __int128>(h) * range) >> 64);
+        }
+
+        constexpr size_t slotOf(std::string_view key) const {
+            uint64_t h1 = mix(fnv1a(key) ^ seed);
+            uint64_t h2 = mix(h1 ^ H2_SALT);
+            return reduce(mix(h2 + pilots[reduce(h1, GROUPS)]), N);
+        }
+
+        // Not constexpr: reaching it during constant evaluation is the compile error
+        static void buildFailed() {}
+
+        // keyHash[i] is fnv1a of entries[i].first, computed once by the constructor
+        constexpr bool tryBuild(const Entry (&entries)[N], const std::array<uint64_t, N>& keyHash) {
+            std::array<size_t, N> groupOf{};
+            std::array<uint64_t, N> h2{};
+            std::array<size_t, GROUPS + 1> groupStart{};
+            for (size_t i = 0; i < N; ++i) {
+                uint64_t h1 = mix(keyHash[i] ^ seed);
+                groupOf[i] = reduce(h1, GROUPS);
+                h2[i] = mix(h1 ^ H2_SALT);
+                ++groupStart[groupOf[i] + 1];
+            }
+
+            // Bucket the entries by group once, so each pilot attempt only
+            // touches that group's members
+            for (size_t g = 0; g < GROUPS; ++g) groupStart[g + 1] += groupStart[g];
+            std::array<size_t, N> members{};
+            std::array<size_t, GROUPS> fill{};
+            for (size_t i = 0; i < N; ++i) {
+                members[groupStart[groupOf[i]] + fill[groupOf[i]]++] = i;
+            }
+
+            // Largest groups first; ties by index so the order is deterministic
+            auto groupSize = [&](size_t g) { return groupStart[g + 1] - groupStart[g]; };
+            std::array<size_t, GROUPS> order{};
+            for (size_t g = 0; g < GROUPS; ++g) order[g] = g;
+            std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return groupSize(a) != groupSize(b) ? groupSize(a) > groupSize(b) : a < b;
+            });
+
+            std::array<bool, N> taken{};
+            std::array<size_t, N> slotOfEntry{};
+            const uint32_t pilotLimit = static_cast<uint32_t>(64 * N + 1024);
+            for (size_t g : order) {
+                size_t first = groupStart[g], last = groupStart[g + 1];
+                if (first == last) break;
+                bool placed = false;
+                for (uint32_t p = 0; p < pilotLimit && !placed; ++p) {
+                    size_t m = first;
+                    for (; m < last; ++m) {
+                        size_t slot = reduce(mix(h2[members[m]] + p), N);
+                        if (taken[slot]) break;
+                        taken[slot] = true;
+                        slotOfEntry[members[m]] = slot;
+                    }
+                    placed = m == last;
+                    if (placed) {
+                        pilots[g] = p;
+                    } else {
+                        while (m-- > first) taken[slotOfEntry[members[m]]] = false;
+                    }
+                }
+                if (!placed) return false;
+            }
+
+            for (size_t i = 0; i < N; ++i) slots[slotOfEntry[i]] = entries[i];
+            return true;
+        }
+
+    public:
+        consteval ConstHashTable(const Entry (&entries)[N]) {
+            // Hash every key once; equal keys have equal hashes, so sorting the
+            // hashes and comparing neighbours finds duplicates in O(N log N)
+            std::array<uint64_t, N> keyHash{};
+            for (size_t i = 0; i < N; ++i) keyHash[i] = fnv1a(entries[i].first);
+            std::array<uint64_t, N> sorted = keyHash;
+            std::sort(sorted.begin(), sorted.end());
+            for (size_t i = 1; i < N; ++i) {
+                if (sorted[i] == sorted[i - 1]) {
+                    buildFailed(); // duplicate key (or 64-bit hash)
+                }
+            }
+            for (size_t attempt = 0; attempt < MAX_SEEDS; ++attempt) {
+                seed = mix(attempt + 1);
+                pilots.fill(0);
+                if (tryBuild(entries, keyHash)) return;
+            }
+            buildFailed();
+        }
+
+        constexpr std::optional<size_t> get(std::string_view key) const {
+            if constexpr (N == 0) {
+                return std::nullopt;
+            } else {
+                const Entry& entry = slots[slotOf(key)];
+                if (entry.first != key) return std::nullopt;
+                return entry.second;
+            }
+        }
+
+        constexpr bool contains(std::string_view key) const {
+            return get(key).has_value();
+        }
+
+        constexpr size_t size() const {
+            return N;
+        }
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_CONSTHASHTABLE_H
@@ -0,0 +1,270 @@
+/*
+// CuckooHashTable.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Two-choice, 4-way bucketized cuckoo hashing with BFS displacement.
+*/
+
+#include "CuckooHashTable.h"
+#include <bit>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+
+namespace std {
+
+   CuckooHashTable::CuckooHashTable(size_t initCapacity) {
+      size_t bucketCount = (initCapacity + SLOTS - 1) / SLOTS;
+      buckets.resize(std::bit_ceil(bucketCount > 1 ? bucketCount : 2));
+   }
+
+   uint64_t CuckooHashTable::hashOf(std::string_view key) {
+      return std::hash<std::string_view>{}(key);
+   }
+
+   // Top 16 bits; 0 is reserved for free slots
+   uint16_t CuckooHashTable::tagOf(uint64_t hash) {
+      uint16_t tag = static_cast<uint16_t>(hash >> 48);
+      return tag != 0 ? tag : 1;
+   }
+
+   size_t CuckooHashTable::homeBucket(uint64_t hash) const {
+      return hash & (buckets.size() - 1);
+   }
+
+   // XOR with a scrambled tag is its own inverse, so each of a key's two
+   // buckets leads to the other
+   size_t CuckooHashTable::altBucket(size_t bucket, uint16_t tag) const {
+      return (bucket ^ (tag * 0xc6a4a7935bd1e995ULL)) & (buckets.size() - 1);
+   }
+
+   bool CuckooHashTable::find(std::string_view key, uint64_t hash, size_t& bucket, size_t& slot) const {
+      const uint16_t tag = tagOf(hash);
+      const size_t first = homeBucket(hash);
+      const size_t candidates[2] = {first, altBucket(first, tag)};
+      for (size_t b : candidates) {
+         const Bucket& current = buckets[b];
+         for (size_t s = 0; s < SLOTS; ++s) {
+            if (current.tags[s] != tag) continue;
+            const Entry& entry = keyStore[current.entries[s]];
+            if (entry.hash == hash && entry.key == key) {
+               bucket = b;
+               slot = s;
+               return true;
+            }
+         }
+      }
+      return false;
+   }
+
+   /*
+    * Breadth-first search from both candidate buckets for a bucket with a
+    * free slot, then shift the entries along that path one step each, from
+    * the free end back to the start.  On success bucket/slot name the freed
+    * slot in one of the two candidate buckets.
+    * A path can pass through the same bucket twice; if an earlier move has
+    * changed what a later step expected to find, the search gives up and the
+    * caller resizes.  Every move already made put an entry in its other
+    * bucket, so the table stays valid either way.
+    */
+   bool CuckooHashTable::displace(size_t first, size_t second, size_t& bucket, size_t& slot) {
+      bfs.clear();
+      bfs.push_back({first, NONE, 0, 0});
+      bfs.push_back({second, NONE, 0, 0});
+
+      uint32_t found = NONE;
+      size_t freeSlot = 0;
+      for (size_t head = 0; head < bfs.size() && found == NONE; ++head) {
+         const PathNode node = bfs[head];
+         const Bucket& current = buckets[node.bucket];
+         for (size_t s = 0; s < SLOTS; ++s) {
+            if (current.tags[s] == 0) {
+               found = static_cast<uint32_t>(head);
+               freeSlot = s;
+               break;
+            }
+         }
+         if (found != NONE || node.depth == MAX_BFS_DEPTH) continue;
+         for (size_t s = 0; s < SLOTS && bfs.size() < MAX_BFS_NODES; ++s) {
+            size_t next = altBucket(node.bucket, current.tags[s]);
+            if (next == node.bucket) continue;
+            bfs.push_back({next, static_cast<uint32_t>(head), static_cast<uint8_t>(s),
+                           static_cast<uint8_t>(node.depth + 1)});
+         }
+      }
+      if (found == NONE) return false;
+
+      uint32_t at = found;
+      while (bfs[at].parent != NONE) {
+         const PathNode& node = bfs[at];
+         const size_t fromBucket = bfs[node.parent].bucket;
+         Bucket& from = buckets[fromBucket];
+         Bucket& to = buckets[node.bucket];
+         const uint16_t tag = from.tags[node.slot];
+         if (tag == 0 || altBucket(fromBucket, tag) != node.bucket || to.tags[freeSlot] != 0) {
+            return false;
+         }
+         to.tags[freeSlot] = tag;
+         to.entries[freeSlot] = from.entries[node.slot];
+         to.values[freeSlot] = from.values[node.slot];
+         from.tags[node.slot] = 0;
+         ++m_displacements;
+         freeSlot = node.slot;
+         at = node.parent;
+      }
+      bucket = bfs[at].bucket;
+      slot = freeSlot;
+      return true;
+   }
+
+   // Put an entry in a free slot of either candidate bucket, displacing others if needed
+   bool CuckooHashTable::place(uint32_t entry, size_t value, uint64_t hash) {
+      const uint16_t tag = tagOf(hash);
+      const size_t first = homeBucket(hash);
+      const size_t second = altBucket(first, tag);
+      size_t bucket = 0, slot = 0;
+      bool freeFound = false;
+      for (size_t b : {first, second}) {
+         for (size_t s = 0; s < SLOTS && !freeFound; ++s) {
+            if (buckets[b].tags[s] == 0) {
+               bucket = b;
+               slot = s;
+               freeFound = true;
+            }
+         }
+      }
+      if (!freeFound && !displace(first, second, bucket, slot)) return false;
+
+      buckets[bucket].tags[slot] = tag;
+      buckets[bucket].entries[slot] = entry;
+      buckets[bucket].values[slot] = value;
+      return true;
+   }
+
+   // Rebuild into bucketCount buckets from the stored hashes (no key is rehashed);
+   // doubles again in the unlikely case the entries do not all fit
+   void CuckooHashTable::rehashTo(size_t bucketCount) {
+      std::vector<Bucket> old = std::move(buckets);
+      bool placedAll = false;
+      while (!placedAll) {
+         buckets.assign(bucketCount, Bucket{});
+         placedAll = true;
+         for (const Bucket& b : old) {
+            for (size_t s = 0; s < SLOTS && placedAll; ++s) {
+               if (b.tags[s] != 0) {
+                  placedAll = place(b.entries[s], b.values[s], keyStore[b.entries[s]].hash);
+               }
+            }
+            if (!placedAll) break;
+         }
+         bucketCount *= 2;
+      }
+      ++m_resizes;
+   }
+
+   /*
+    * Insert a key-value pair.  Rejects duplicates.  Resizes only when the
+    * displacement search cannot free a slot for the key.
+    */
+   bool CuckooHashTable::insert(std::string_view key, const size_t& value) {
+      const uint64_t hash = hashOf(key);
+      size_t bucket = 0, slot = 0;
+      if (find(key, hash, bucket, slot)) return false;
+
+      uint32_t entry;
+      if (!freeEntries.empty()) {
+         entry = freeEntries.back();
+         freeEntries.pop_back();
+         keyStore[entry].key.assign(key);
+         keyStore[entry].hash = hash;
+      } else {
+         entry = static_cast<uint32_t>(keyStore.size());
+         keyStore.push_back(Entry{std::string(key), hash});
+      }
+
+      while (!place(entry, value, hash)) {
+         rehashTo(buckets.size() * 2);
+      }
+      ++m_size;
+      return true;
+   }
+
+   bool CuckooHashTable::remove(std::string_view key) {
+      size_t bucket = 0, slot = 0;
+      if (!find(key, hashOf(key), bucket, slot)) return false;
+      uint32_t entry = buckets[bucket].entries[slot];
+      buckets[bucket].tags[slot] = 0;
+      keyStore[entry].key.clear();
+      freeEntries.push_back(entry);
+      --m_size;
+      return true;
+   }
+
+   bool CuckooHashTable::contains(std::string_view key) const {
+      return get(key).has_value();
+   }
+
+   std::optional<size_t> CuckooHashTable::get(std::string_view key) const {
+      size_t bucket = 0, slot = 0;
+      if (!find(key, hashOf(key), bucket, slot)) return std::nullopt;
+      return buckets[bucket].values[slot];
+   }
+
+   /*
+    * Reference to the value for key, inserting 0 if absent.  Any later insert
+    * may move entries between buckets, which invalidates the reference.
+    */
+   size_t& CuckooHashTable::operator[](std::string_view key) {
+      const uint64_t hash = hashOf(key);
+      size_t bucket = 0, slot = 0;
+      if (!find(key, hash, bucket, slot)) {
+         insert(key, 0);
+         find(key, hash, bucket, slot);
+      }
+      return buckets[bucket].values[slot];
+   }
+
+   // Size for count entries at a load factor of at most about 0.9
+   void CuckooHashTable::reserve(size_t count) {
+      size_t slotsNeeded = count + count / 9;
+      size_t bucketCount = std::bit_ceil((slotsNeeded + SLOTS - 1) / SLOTS);
+      keyStore.reserve(count);
+      if (bucketCount > buckets.size()) rehashTo(bucketCount);
+   }
+
+   std::vector<std::string> CuckooHashTable::keys() const {
+      std::vector<std::string> result;
+      result.reserve(m_size);
+      for (const Bucket& b : buckets) {
+         for (size_t s = 0; s < SLOTS; ++s) {
+            if (b.tags[s] != 0) result.push_back(keyStore[b.entries[s]].key);
+         }
+      }
+      return result;
+   }
+
+   double CuckooHashTable::alpha() const {
+      return static_cast<double>(m_size) / static_cast<double>(capacity());
+   }
+
+   size_t CuckooHashTable::capacity() const {
+      return buckets.size() * SLOTS;
+   }
+
+   size_t CuckooHashTable::size() const {
+      return m_size;
+   }
+
+   size_t CuckooHashTable::displacements() const {
+      return m_displacements;
+   }
+
+   size_t CuckooHashTable::resizes() const {
+      return m_resizes;
+   }
+
+}
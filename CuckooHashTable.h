@@ -0,0 +1,111 @@
+/*
+// CuckooHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Bucketized cuckoo hash table: an alternative to HashTable's randomized
+// probing with a hard bound on lookup work.  Every key can only live in one
+// of two buckets, and a bucket is a single 64-byte cache line holding SLOTS
+// entries, so get() reads at most two bucket lines no matter how full the
+// table is (plus the stored key of a tag match, to confirm it).
+// Each slot keeps a 16-bit tag from the key's hash, the index of the key in
+// a separate key store, and the value inline.  The second bucket is derived
+// from the first bucket and the tag alone (partial-key cuckoo hashing), so
+// entries can be moved between their buckets without rehashing the key.
+// When both buckets are full, insert() does a breadth-first search for the
+// shortest chain of moves (at most MAX_BFS_DEPTH) that ends at a free slot.
+// Only when that fails does the table resize, which lets it run at load
+// factors above 0.9.
+// Unlike HashTable, every value (including 9999) is accepted.
+// Actionable members include:
+// - insert / remove / contains / get / operator[] - same meaning as on HashTable
+// - reserve - size the table for a number of entries up front
+// - alpha / capacity / size - load factor, slot count, entry count
+// - displacements / resizes - entries moved by BFS inserts, and resize count
+*/
+#ifndef PROJECT4_HASHTABLE_CUCKOOHASHTABLE_H
+#define PROJECT4_HASHTABLE_CUCKOOHASHTABLE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    class CuckooHashTable {
+    public:
+        static constexpr size_t SLOTS = 4;
+        static constexpr size_t MAX_BFS_DEPTH = 5;
+        static constexpr size_t MAX_BFS_NODES = 512;
+
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        // One cache line: a tag of 0 marks a free slot
+        struct alignas(64) Bucket {
+            uint16_t tags[SLOTS] = {};
+            uint32_t entries[SLOTS] = {};
+            size_t values[SLOTS] = {};
+        };
+
+        struct Entry {
+            std::string key;
+            uint64_t hash = 0;
+        };
+
+        // BFS node: reached by moving the entry in slot `slot` of the parent
+        // bucket into `bucket`
+        struct PathNode {
+            size_t bucket;
+            uint32_t parent;
+            uint8_t slot;
+            uint8_t depth;
+        };
+
+        std::vector<Bucket> buckets;
+        std::vector<Entry> keyStore;
+        std::vector<uint32_t> freeEntries;
+        std::vector<PathNode> bfs; // reused by every displacement search
+
+        size_t m_size = 0;
+        size_t m_displacements = 0;
+        size_t m_resizes = 0;
+
+        static uint64_t hashOf(std::string_view key);
+        static uint16_t tagOf(uint64_t hash);
+
+        size_t homeBucket(uint64_t hash) const;
+        size_t altBucket(size_t bucket, uint16_t tag) const;
+        bool find(std::string_view key, uint64_t hash, size_t& bucket, size_t& slot) const;
+        bool place(uint32_t entry, size_t value, uint64_t hash);
+        bool displace(size_t first, size_t second, size_t& bucket, size_t& slot);
+        void rehashTo(size_t bucketCount);
+
+    public:
+        explicit CuckooHashTable(size_t initCapacity = 8);
+
+        bool insert(std::string_view key, const size_t& value);
+        bool remove(std::string_view key);
+        bool contains(std::string_view key) const;
+        std::optional<size_t> get(std::string_view key) const;
+        size_t& operator[](std::string_view key);
+
+        void reserve(size_t count);
+        std::vector<std::string> keys() const;
+
+        double alpha() const;
+        size_t capacity() const;
+        size_t size() const;
+
+        size_t displacements() const;
+        size_t resizes() const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_CUCKOOHASHTABLE_H
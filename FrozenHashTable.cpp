@@ -0,0 +1,201 @@
+/*
+// FrozenHashTable.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Minimal perfect hash construction (pilot search) and one-slot lookups for
+// FrozenHashTable.
+*/
+
+#include "FrozenHashTable.h"
+#include <algorithm>
+#include <bit>
+#include <functional>
+
+namespace std {
+
+   // Read the pilotWidth-bit field for group; a field may straddle two words
+   uint64_t FrozenHashTable::pilot(size_t group) const {
+      if (pilotWidth == 0) return 0;
+      size_t bit = group * pilotWidth;
+      size_t word = bit >> 6;
+      unsigned shift = bit & 63;
+      uint64_t value = pilotWords[word] >> shift;
+      if (shift + pilotWidth > 64) {
+         value |= pilotWords[word + 1] << (64 - shift);
+      }
+      return pilotWidth == 64 ? value : value & ((uint64_t{1} << pilotWidth) - 1);
+   }
+
+   std::string_view FrozenHashTable::keyAt(size_t slot) const {
+      return std::string_view(arena).substr(keyOffsets[slot], keyOffsets[slot + 1] - keyOffsets[slot]);
+   }
+
+   /*
+    * One construction attempt with the current seed.  Groups are placed
+    * largest first, since small groups are the easy ones to fit into the
+    * last free slots.  Each group takes the first pilot that lands all its
+    * keys on distinct free slots.  Returns false if some group needs more
+    * pilots than the limit, so the caller can retry with another seed.
+    */
+   bool FrozenHashTable::tryBuild(const std::vector<uint64_t>& hashes, std::vector<size_t>& slotOf) {
+      std::vector<uint64_t> h2(n);
+      std::vector<size_t> groupStart(groups + 1, 0);
+      std::vector<size_t> groupOf(n);
+      for (size_t i = 0; i < n; ++i) {
+         uint64_t h1 = mix(hashes[i] ^ seed);
+         h2[i] = mix(h1 ^ H2_SALT);
+         groupOf[i] = reduce(h1, groups);
+         ++groupStart[groupOf[i] + 1];
+      }
+      for (size_t g = 0; g < groups; ++g) {
+         groupStart[g + 1] += groupStart[g];
+      }
+      std::vector<size_t> members(n);
+      std::vector<size_t> fill(groupStart.begin(), groupStart.end() - 1);
+      for (size_t i = 0; i < n; ++i) {
+         members[fill[groupOf[i]]++] = i;
+      }
+
+      std::vector<size_t> order(groups);
+      for (size_t g = 0; g < groups; ++g) order[g] = g;
+      std::ranges::stable_sort(order, [&](size_t a, size_t b) {
+         return groupStart[a + 1] - groupStart[a] > groupStart[b + 1] - groupStart[b];
+      });
+
+      // A single key with one free slot left needs about n tries on average
+      const uint64_t pilotLimit = 64 * static_cast<uint64_t>(n) + 1024;
+      std::vector<uint64_t> pilots(groups, 0);
+      std::vector<bool> taken(n, false);
+      std::vector<size_t> slots;
+      for (size_t g : order) {
+         size_t first = groupStart[g], last = groupStart[g + 1];
+         if (first == last) break; // the rest are empty
+         bool placed = false;
+         for (uint64_t p = 0; p < pilotLimit && !placed; ++p) {
+            slots.clear();
+            placed = true;
+            for (size_t m = first; m < last; ++m) {
+               size_t slot = slotFor(h2[members[m]], p);
+               if (taken[slot] || std::ranges::find(slots, slot) != slots.end()) {
+                  placed = false;
+                  break;
+               }
+               slots.push_back(slot);
+            }
+            if (placed) {
+               pilots[g] = p;
+               for (size_t m = first; m < last; ++m) {
+                  taken[slots[m - first]] = true;
+                  slotOf[members[m]] = slots[m - first];
+               }
+            }
+         }
+         if (!placed) return false;
+      }
+
+      uint64_t maxPilot = *std::ranges::max_element(pilots);
+      pilotWidth = static_cast<unsigned>(std::bit_width(maxPilot));
+      pilotWords.assign(pilotWidth == 0 ? 0 : (groups * pilotWidth + 63) / 64 + 1, 0);
+      for (size_t g = 0; g < groups && pilotWidth > 0; ++g) {
+         size_t bit = g * pilotWidth;
+         unsigned shift = bit & 63;
+         pilotWords[bit >> 6] |= pilots[g] << shift;
+         if (shift + pilotWidth > 64) {
+            pilotWords[(bit >> 6) + 1] |= pilots[g] >> (64 - shift);
+         }
+      }
+      return true;
+   }
+
+   /*
+    * Freeze the live entries of source.  Returns nullopt only if no perfect
+    * hash was found, which needs two keys with the same 64-bit std::hash or
+    * MAX_SEEDS unlucky seeds in a row.
+    */
+   std::optional<FrozenHashTable> FrozenHashTable::build(const HashTable& source) {
+      std::vector<std::string_view> keys;
+      std::vector<size_t> sourceValues;
+      keys.reserve(source.size());
+      sourceValues.reserve(source.size());
+      for (auto [key, value] : source) {
+         keys.push_back(key);
+         sourceValues.push_back(value);
+      }
+
+      FrozenHashTable frozen;
+      frozen.n = keys.size();
+      if (frozen.n == 0) return frozen;
+      frozen.groups = (frozen.n + KEYS_PER_GROUP - 1) / KEYS_PER_GROUP;
+
+      std::vector<uint64_t> hashes(frozen.n);
+      for (size_t i = 0; i < frozen.n; ++i) {
+         hashes[i] = std::hash<std::string_view>{}(keys[i]);
+      }
+      // Every seed maps equal hashes to the same slot choices, so no seed can help
+      std::vector<uint64_t> sorted = hashes;
+      std::ranges::sort(sorted);
+      if (std::ranges::adjacent_find(sorted) != sorted.end()) return std::nullopt;
+
+      std::vector<size_t> slotOf(frozen.n);
+      bool built = false;
+      for (size_t attempt = 0; attempt < MAX_SEEDS && !built; ++attempt) {
+         frozen.seed = mix(attempt + 1);
+         built = frozen.tryBuild(hashes, slotOf);
+      }
+      if (!built) return std::nullopt;
+
+      std::vector<size_t> entryAt(frozen.n);
+      size_t keyBytes = 0;
+      for (size_t i = 0; i < frozen.n; ++i) {
+         entryAt[slotOf[i]] = i;
+         keyBytes += keys[i].size();
+      }
+      frozen.arena.reserve(keyBytes);
+      frozen.keyOffsets.resize(frozen.n + 1);
+      frozen.values.resize(frozen.n);
+      for (size_t slot = 0; slot < frozen.n; ++slot) {
+         size_t i = entryAt[slot];
+         frozen.keyOffsets[slot] = frozen.arena.size();
+         frozen.arena += keys[i];
+         frozen.values[slot] = sourceValues[i];
+      }
+      frozen.keyOffsets[frozen.n] = frozen.arena.size();
+      return frozen;
+   }
+
+   /*
+    * The key can only be in one slot; compare it there.
+    */
+   std::optional<size_t> FrozenHashTable::get(std::string_view key) const {
+      if (n == 0) return std::nullopt;
+      uint64_t h1 = mix(std::hash<std::string_view>{}(key) ^ seed);
+      uint64_t h2 = mix(h1 ^ H2_SALT);
+      size_t slot = slotFor(h2, pilot(reduce(h1, groups)));
+      if (keyAt(slot) != key) return std::nullopt;
+      return values[slot];
+   }
+
+   bool FrozenHashTable::contains(std::string_view key) const {
+      return get(key).has_value();
+   }
+
+   size_t FrozenHashTable::size() const {
+      return n;
+   }
+
+   // Space of the perfect hash itself (the pilots), in bits per key
+   double FrozenHashTable::pilotBitsPerKey() const {
+      return n ? static_cast<double>(groups * pilotWidth) / static_cast<double>(n) : 0.0;
+   }
+
+   // Total heap and object bytes, keys and values included
+   size_t FrozenHashTable::bytes() const {
+      return sizeof(*this) + pilotWords.capacity() * sizeof(uint64_t) + arena.capacity() +
+             keyOffsets.capacity() * sizeof(size_t) + values.capacity() * sizeof(size_t);
+   }
+
+}
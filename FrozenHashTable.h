@@ -0,0 +1,99 @@
+/*
+// FrozenHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Read-only snapshot of a HashTable built on a minimal perfect hash, for
+// tables that are filled once and then only queried.  n entries occupy
+// exactly n slots, with no bucket states and no probing: a lookup hashes the
+// key once, reads its group's pilot, computes the one slot the key can be in
+// and compares the key there.
+// The hash is built PTHash-style.  Keys are split into groups of about
+// KEYS_PER_GROUP by one hash.  Going from the largest group to the smallest,
+// each group gets the first pilot value p that sends all of its keys, via
+// slot = range(mix(h2(key) + p), n), to slots that are still free.  Pilots
+// are stored bit-packed at the width of the largest one.
+// Keys live back to back in one character arena, values in a parallel array.
+// Actionable members include:
+// - build - freeze the live entries of a HashTable (nullopt if no hash was found)
+// - get / contains - one-slot lookup with key verification
+// - size / pilotBitsPerKey / bytes - entry count and space used
+*/
+#ifndef PROJECT4_HASHTABLE_FROZENHASHTABLE_H
+#define PROJECT4_HASHTABLE_FROZENHASHTABLE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "HashTable.h"
+
+namespace std {
+
+    class FrozenHashTable {
+    public:
+        static constexpr size_t KEYS_PER_GROUP = 4;
+        static constexpr size_t MAX_SEEDS = 8;
+
+    private:
+        size_t n = 0;
+        size_t groups = 0;
+        uint64_t seed = 0;
+
+        // Pilot of group g is the pilotWidth-bit field starting at bit g * pilotWidth
+        std::vector<uint64_t> pilotWords;
+        unsigned pilotWidth = 0;
+
+        std::string arena;
+        std::vector<size_t> keyOffsets; // n + 1 entries; key i is arena[off[i], off[i+1])
+        std::vector<size_t> values;
+
+        static constexpr uint64_t H2_SALT = 0x9e3779b97f4a7c15ULL;
+
+        // 64-bit finalizer (splitmix64): spreads every input bit over the output
+        static uint64_t mix(uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        // Map a 64-bit hash onto [0, range) with a multiply instead of a division
+        static size_t reduce(uint64_t h, size_t range) {
+            return static_cast<size_t>((static_cast<unsigned __int128>(h) * range) >> 64);
+        }
+
+        // Re-mixing per pilot makes each pilot an independent placement of the
+        // whole group; XOR-ing in a shared displacement would keep the keys'
+        // relative slots nearly fixed and leave the last free slots unreachable
+        size_t slotFor(uint64_t h2, uint64_t pilot) const {
+            return reduce(mix(h2 + pilot), n);
+        }
+
+        uint64_t pilot(size_t group) const;
+        std::string_view keyAt(size_t slot) const;
+        bool tryBuild(const std::vector<uint64_t>& hashes, std::vector<size_t>& slotOf);
+
+    public:
+        FrozenHashTable() = default;
+
+        static std::optional<FrozenHashTable> build(const HashTable& source);
+
+        std::optional<size_t> get(std::string_view key) const;
+        bool contains(std::string_view key) const;
+
+        size_t size() const;
+        double pilotBitsPerKey() const;
+        size_t bytes() const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_FROZENHASHTABLE_H
@@ -15,21 +15,42 @@
  *  'SENTINEL_KEY_42' and a data value of 0 - as suggested boy the project pdf and sets the
  *  initial state to ESS - empty since start.
  * -  Actionable members include:
- *   - generateOffsets -> returns std::vector<size_t> for the hashing offsets
- *   - hash -> maps key to index in table using std::hash returns a size_t result
+ *   - generateOffsets -> returns std::vector<HashTableIndex> for the hashing offsets
+ *   - hash -> maps key to index in table using std::hash (SipHash after a flood) returns a size_t result
  *   - probeIndex -> returns a size_t
  *   - insert -> returns a boolean upon successful or failure to insert
  *   - resize -> void
- *   - remove(const std::string& key) -> bool
- *   - contains(const std::string& key) const -> bool
- *   - get(const std::string& key) const -> returns a std::optional<size_t>
- *   - operator[](const std::string& key) -> returns a reference value of the data
+ *   - remove(std::string_view key) -> bool
+ *   - contains(std::string_view key) const -> bool
+ *   - get(std::string_view key) const -> returns a std::optional<size_t>
+ *   - getBatch(keys, out, groupSize) const -> interleaved coroutine lookups that overlap cache misses
+ *   - operator[](std::string_view key) -> returns a reference value of the data
+ *   - reserve(count, keyCapacity) -> presize so inserts neither resize nor allocate
+ *   - mergeFrom / intersectWith / subtract / eraseIf -> bulk set operations over raw buckets
  *   - keys() const -> returns a std::vector<std::string>  of the keys
+ *   - begin()/end() -> zero-copy iteration over pair<string_view, size_t&>
+ *   - scan(cursor, maxBuckets, visit) -> resumable bounded walk that survives resizes
  *   - alpha() const -> returns a ratio of occupants to total possible (a double)
  *   - capacity() const -> returns total possible occupants
  *   - size() const -> returns occupancy count
  *   - rehashBackwards() -> sorting and dumping to data file
+ *   - setAccessSampling / reoptimize / weightedProbeLength -> re-place hot keys first, fully or incrementally
  *   - debugDumpToJSON() -> just dumps formated data to the JSON
+ *   - stats() const -> HashTableStats snapshot (probe histograms with HASHTABLE_STATS)
+ *   - attachLog / syncLog / logTick -> optional write-ahead log with group commit
+ *   - saveSnapshot / loadSnapshot / checkpoint / recover -> durable state on disk
+ *   - setCacheBudget / isCache -> bounded cache mode with CLOCK eviction
+ *   - insert(key, value, ttl) / expire / ttl -> per-entry expiry, lazy on lookup
+ *   - expireTick / setClock -> incremental timer wheel reclaim, mockable time source
+ *   - setBloomFilter / hasBloomFilter -> blocked Bloom filter that rejects most misses unprobed
+ *   - setFloodProtection / keyedHash / useKeyedHash / hashEpoch -> switch to seeded SipHash when inserts show collision flooding
+ *   - attachTrace -> optional insert/get/remove/operator[] trace for offline replay
+ *   - memoryUsage / setMemoryBudget -> bytes by component; a hard budget that fails, evicts or fills instead of growing
+ *   - attachFeed / serveReplica -> versioned change feed, served to HashTableReplica as deltas or a snapshot
+ *  Capacities are always powers of two so a home index is a mask of the hash.
+ *  Offsets are stored as HashTableIndex (HASHTABLE_INDEX_BITS wide, 32 by
+ *  default), so capacities stop at MAX_CAPACITY; past that, inserts fill the
+ *  table beyond load 0.5 and fail once it is full.
 */
 
 #include "HashTable.h"
@@ -37,30 +58,168 @@
 #include <vector>
 #include <optional>
 #include <algorithm>
+#include <array>
 #include <random>
 #include <fstream>
 #include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 
 namespace std {
+// Bytes an entry counts against a cache byte budget: its key plus the value word
+static size_t entryBytes(std::string_view key) {
+    return key.size() + sizeof(size_t);
+}
+
+// Buckets per thread below which a bulk operation is not worth splitting
+static constexpr size_t PARALLEL_MIN_BUCKETS = size_t{1} << 16;
+
+/*
+ * Run body(begin, end) over contiguous ranges covering [0, count), one per
+ * hardware thread when there is enough work; the caller's thread takes the
+ * first range.  Used for the read-only phases of the bulk set operations.
+ */
+template<typename Body>
+static void forEachRange(size_t count, Body body) {
+    size_t threads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                      count / PARALLEL_MIN_BUCKETS);
+    if (threads <= 1) {
+        body(size_t{0}, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(body, count * t / threads, count * (t + 1) / threads);
+    }
+    body(size_t{0}, count / threads);
+    for (auto &worker : workers) worker.join();
+}
+
 /*
- * Constructor: initializes hash table with given capacity.
- * Sets size to 0 and generates randomized probe offsets.
+ * Constructor: initializes hash table with given capacity, rounded up to a
+ * power of two (at most MAX_CAPACITY).  Sets size to 0 and generates
+ * randomized probe offsets.
  */
 HashTable::HashTable(const size_t initCapacity)
-    : table(initCapacity) {
-    offsets = generateOffsets(initCapacity);
+    : table(std::min(std::bit_ceil(initCapacity), MAX_CAPACITY)) {
+    offsets = generateOffsets(capacity());
+}
+
+/*
+ * Destructor: detaches the write-ahead log, so operator[] writes that are
+ * still held back reach it before the table is gone.
+ */
+HashTable::~HashTable() {
+    if (log && log->table == this) {
+        attachLog(nullptr);
+    }
+}
+
+/*
+ * Copy: the entries and settings, but not the log, trace or change feed,
+ * which keep following the source only.
+ */
+HashTable::HashTable(const HashTable &other) {
+    assignFrom(other);
+}
+
+/*
+ * Move: the new table takes over the entries and any attached log, trace
+ * and feed; the log is re-pointed at it.  The source keeps no buckets and
+ * nothing attached, so it may only be assigned to or destroyed.
+ */
+HashTable::HashTable(HashTable &&other) noexcept {
+    assignFrom(std::move(other));
+}
+
+HashTable &HashTable::operator=(HashTable &&other) noexcept {
+    if (this != &other) {
+        if (log && log->table == this) {
+            attachLog(nullptr);
+        }
+        assignFrom(std::move(other));
+    }
+    return *this;
+}
+
+/*
+ * Member-wise copy or move from other.  Attachments only travel with a move.
+ */
+template<typename Source>
+void HashTable::assignFrom(Source &&other) {
+    constexpr bool moving = !std::is_lvalue_reference_v<Source>;
+    m_size = other.m_size;
+    m_tombstones = other.m_tombstones;
+    table = std::forward<Source>(other).table;
+    offsets = std::forward<Source>(other).offsets;
+
+    if constexpr (moving) {
+        log = std::exchange(other.log, nullptr);
+        if (log && log->table == &other) log->table = this;
+        pendingAssign = std::move(other.pendingAssign);
+        trace = std::exchange(other.trace, nullptr);
+        feed = std::exchange(other.feed, nullptr);
+    } else {
+        log = nullptr;
+        pendingAssign.clear();
+        trace = nullptr;
+        feed = nullptr;
+    }
+
+    m_cacheMaxEntries = other.m_cacheMaxEntries;
+    m_cacheMaxBytes = other.m_cacheMaxBytes;
+    m_entryBytes = other.m_entryBytes;
+    m_clockHand = other.m_clockHand;
+    m_cacheHits = other.m_cacheHits;
+    m_cacheMisses = other.m_cacheMisses;
+    m_evictions = other.m_evictions;
+    m_compactions = other.m_compactions;
+
+    clock = other.clock;
+    wheel = std::forward<Source>(other).wheel;
+    m_expirations = other.m_expirations;
+
+    filter = std::forward<Source>(other).filter;
+    m_filterBitsPerKey = other.m_filterBitsPerKey;
+    m_filterStale = other.m_filterStale;
+    m_filterRejects = other.m_filterRejects;
+    m_filterRebuilds = other.m_filterRebuilds;
+
+    m_accessSampleEvery = other.m_accessSampleEvery;
+    m_accessTick = other.m_accessTick;
+
+    sipHash = other.sipHash;
+    m_keyedHash = other.m_keyedHash;
+    m_floodGuard = other.m_floodGuard;
+    m_reseeds = other.m_reseeds;
+
+    m_memoryBudget = other.m_memoryBudget;
+    m_memoryPolicy = other.m_memoryPolicy;
+    m_keyHeapBytes = other.m_keyHeapBytes;
+    m_budgetRejects = other.m_budgetRejects;
+#ifdef HASHTABLE_STATS
+    m_stats = other.m_stats;
+#endif
 }
 
 /*
  * Generate a randomized sequence of probe offsets for open addressing.
  * Returns a shuffled vector of integers from 1 to cap - 1.
  */
-std::vector<size_t> HashTable::generateOffsets(size_t cap) {
-    std::vector<size_t> result;
+std::vector<HashTableIndex> HashTable::generateOffsets(size_t cap) {
+    std::vector<HashTableIndex> result;
+    result.reserve(cap > 0 ? cap - 1 : 0);
     for (size_t i = 1; i < cap; ++i) {
-        result.push_back(i);
+        result.push_back(static_cast<HashTableIndex>(i));
     }
 
     if (!result.empty()) {
@@ -80,65 +239,142 @@ std::vector<size_t> HashTable::generateOffsets(size_t cap) {
 
 /*
  * Hash function: maps key to index in table using std::hash.
+ * std::hash<std::string_view> agrees with std::hash<std::string>, and hashing
+ * the view means lookups never have to materialize a std::string.
+ * Capacity is a power of two, so the low bits of the hash pick the home slot.
+ * Once a flood has been detected the table uses keyed SipHash instead.
  */
-size_t HashTable::hash(const std::string &key) const {
-    return std::hash<std::string>{}(key) % capacity();
+size_t HashTable::keyHash(std::string_view key) const {
+    if (m_keyedHash) return static_cast<size_t>(sipHash.hash(key));
+    return std::hash<std::string_view>{}(key);
+}
+
+size_t HashTable::hash(std::string_view key) const {
+    return keyHash(key) & (capacity() - 1);
 }
 
 /*
  * Compute probe index using home index and offset sequence.
+ * Attempt 0 is the home slot itself; attempts 1..capacity-1 walk the
+ * shuffled offsets, so every slot is visited exactly once.
  */
 size_t HashTable::probeIndex(size_t home, size_t attempt) const {
-    return (home + offsets[attempt]) % capacity();
+    if (attempt == 0) return home;
+    return (home + offsets[attempt - 1]) & (capacity() - 1);
 }
 
 /*
  * Insert a key-value pair into the hash table.
  * Rejects duplicates and sentinel value (9999).
- * Triggers resize if load factor exceeds 0.5.
+ * Successful inserts are appended to the attached log, if any.
+ */
+bool HashTable::insert(std::string_view key, const size_t &value) {
+    if (trace) trace->record(TraceOp::INSERT, key);
+    return insertHashed(key, value, keyHash(key));
+}
+
+/*
+ * insert() for a key whose full hash the caller already has.
+ */
+bool HashTable::insertHashed(std::string_view key, const size_t &value, size_t fullHash) {
+    if (!insertInternal(key, value, fullHash)) {
+        HASHTABLE_STAT(++m_stats.insertRejects);
+        return false;
+    }
+    HASHTABLE_STAT(++m_stats.inserts);
+    if (log) {
+        log->append(LogOp::INSERT, key, value);
+        logCommitIfDue();
+    }
+    if (feed) feed->record(LogOp::INSERT, key, value);
+    return true;
+}
+
+/*
+ * Insert without logging; used by insert() itself and when rehashing entries
+ * that are already durable.  Triggers resize if load factor exceeds 0.5.
+ * The new probe offsets are seeded from the key length.  glibc's srand()
+ * costs hundreds of generator steps, so it runs only when a resize does.
  */
-bool HashTable::insert(const std::string &key, const size_t &value) {
-    srand(key.length());
+bool HashTable::insertInternal(std::string_view key, const size_t &value) {
+    return insertInternal(key, value, keyHash(key));
+}
 
+bool HashTable::insertInternal(std::string_view key, const size_t &value, size_t fullHash) {
     if (value == 9999) {
         return false;
     }
 
-    if (alpha() >= 0.5) {
+    if (alpha() >= 0.5 && capacity() < MAX_CAPACITY && canRebuild(capacity() * 2)) {
+        srand(key.length());
         resize();
     }
 
+#ifdef HASHTABLE_JSON_DUMPS
     double oldAlpha = alpha();
-    size_t home = hash(key);
+#endif
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
     size_t first_ear_index = capacity();
 
-    for (size_t i = 0; i < capacity(); ++i) {
-        size_t index = probeIndex(home, i);
-        if (table[index].isNormal() && table[index].getKey() == key) {
-            return false;
+    size_t probes = 0;
+    for (; probes < capacity(); ++probes) {
+        size_t index = probeIndex(home, probes);
+        if (table[index].holds(key, tag)) {
+            if (!isExpired(table[index])) {
+                return false;
+            }
+            reclaimExpired(table[index]); // expired: the slot is free for the new entry
+            break;
         }
         if (table[index].isEmptySinceStart()) {
             break;
         }
     }
 
+    if (floodSuspected(home, probes)) {
+        reseedHash();
+        return insertInternal(key, value, keyHash(key));
+    }
+
+    // A full cache evicts (possibly compacting the table) and starts over
+    if (isCache() && overBudget(entryBytes(key))) {
+        if (!makeRoom(entryBytes(key))) return false;
+        return insertInternal(key, value, fullHash);
+    }
+
+    // Past the memory budget: make room as the policy says and start over
+    if (m_memoryBudget > 0 && !budgetAllows(key)) {
+        if (!makeBudgetRoom(key)) return false;
+        return insertInternal(key, value, fullHash);
+    }
+
     for (size_t i = 0; i < capacity(); ++i) {
         size_t index = probeIndex(home, i);
         if (table[index].isEmptyAfterRemoval() && first_ear_index == capacity()) {
             first_ear_index = index;
         }
         if (table[index].isEmptySinceStart()) {
-            table[index].load(key, value);
+            fill(table[index], key, value, tag);
             ++m_size;
+            m_entryBytes += entryBytes(key);
+            filterAdd(fullHash);
+#ifdef HASHTABLE_JSON_DUMPS
             if (alpha() != oldAlpha) debugDumpToJSON();
+#endif
             return true;
         }
     }
 
     if (first_ear_index != capacity()) {
-        table[first_ear_index].load(key, value);
+        fill(table[first_ear_index], key, value, tag);
         ++m_size;
+        --m_tombstones;
+        m_entryBytes += entryBytes(key);
+        filterAdd(fullHash);
+#ifdef HASHTABLE_JSON_DUMPS
         if (alpha() != oldAlpha) debugDumpToJSON();
+#endif
         return true;
     }
 
@@ -150,16 +386,97 @@ bool HashTable::insert(const std::string &key, const size_t &value) {
  * Doubles capacity, rehashes all NORMAL buckets, and regenerates probe offsets.
  */
 void HashTable::resize() {
-    size_t newCapacity = capacity() * 2;
+    if (capacity() >= MAX_CAPACITY) return;
+    rehashTo(capacity() * 2);
+}
+
+/*
+ * Rebuild the table at newCapacity (clamped to MAX_CAPACITY): rehashes all
+ * NORMAL buckets into fresh ESS buckets (dropping tombstones), regenerating
+ * probe offsets if the capacity changes.
+ * Buckets are moved, not re-inserted: the fresh table has no duplicates or
+ * tombstones to check for, and the key strings change hands without copying.
+ */
+void HashTable::rehashTo(size_t newCapacity) {
+    newCapacity = std::min(newCapacity, MAX_CAPACITY);
+#ifdef HASHTABLE_STATS
+    auto start = std::chrono::steady_clock::now();
+#endif
     std::vector<HashTableBucket> oldTable = std::move(table);
+    clearForRebuild(newCapacity);
+    for (auto &bucket : oldTable) {
+        if (bucket.isNormal()) placeRehashed(std::move(bucket));
+    }
+#ifdef HASHTABLE_STATS
+    ++m_stats.resizes;
+    m_stats.resizeNanos += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+#endif
+}
+
+/*
+ * Rebuild at the same capacity, placing entries in the order given by
+ * before(a, b) (true if a should be placed first).  Entries placed earlier
+ * take the earlier slots of their probe sequences, so the first ones mostly
+ * land in their home slot.  Entries keep their values, TTLs and counters.
+ */
+template<typename Before>
+void HashTable::rehashInOrder(Before before) {
+    std::vector<HashTableBucket> entries;
+    entries.reserve(m_size);
+    for (auto &bucket : table) {
+        if (bucket.isNormal()) entries.push_back(std::move(bucket));
+    }
+    std::stable_sort(entries.begin(), entries.end(), before);
+    clearForRebuild(capacity());
+    for (auto &bucket : entries) placeRehashed(std::move(bucket));
+}
 
+/*
+ * Empty table of newCapacity ESS buckets, with fresh probe offsets if the
+ * capacity changes and an empty Bloom filter sized to match.  The old
+ * offsets and filter are freed before anything is allocated, so a rebuild
+ * never holds two of either (rebuildPeak() counts on this).
+ */
+void HashTable::clearForRebuild(size_t newCapacity) {
+    const bool newOffsets = offsets.size() + 1 != newCapacity; // same-size rebuilds keep their offsets
+    if (newOffsets) std::vector<HashTableIndex>().swap(offsets);
+    filter.clear();
+    const bool reused = table.capacity() >= newCapacity;
     table.assign(newCapacity, HashTableBucket());
-    offsets = generateOffsets(newCapacity);
+    if (newOffsets) offsets = generateOffsets(newCapacity);
+    // Reused buckets may still hold the storage of a key they once had
+    m_keyHeapBytes = 0;
+    if (reused) {
+        for (const auto &bucket : table) m_keyHeapBytes += bucket.keyHeapBytes();
+    }
     m_size = 0;
+    m_tombstones = 0;
+    m_clockHand = 0;
+    if (m_filterBitsPerKey > 0) {
+        filter.reset(newCapacity / 2, m_filterBitsPerKey);
+        m_filterStale = 0;
+        ++m_filterRebuilds;
+    }
+}
 
-    for (const auto &bucket : oldTable) {
-        if (bucket.isNormal()) {
-            insert(bucket.getKey(), bucket.getValue());
+/*
+ * Move a NORMAL bucket into the first ESS slot of its probe sequence.  Only
+ * valid while rebuilding: the table has no duplicates or tombstones to check.
+ */
+void HashTable::placeRehashed(HashTableBucket &&bucket) {
+    const size_t fullHash = keyHash(bucket.getKey());
+    filterAdd(fullHash);
+    bucket.setTag(HashTableBucket::tagOf(fullHash)); // the hash function may have changed
+    size_t home = fullHash & (capacity() - 1);
+    for (size_t i = 0; i < capacity(); ++i) {
+        size_t index = probeIndex(home, i);
+        if (table[index].isEmptySinceStart()) {
+            m_keyHeapBytes -= table[index].keyHeapBytes();
+            table[index] = std::move(bucket);
+            m_keyHeapBytes += table[index].keyHeapBytes();
+            ++m_size;
+            return;
         }
     }
 }
@@ -168,62 +485,260 @@ void HashTable::resize() {
  * Remove a key from the table by marking its bucket as EAR.
  * Returns true if key was found and removed, false otherwise.
  */
-bool HashTable::remove(const std::string &key) {
-    size_t home = hash(key);
+bool HashTable::remove(std::string_view key) {
+    if (trace) trace->record(TraceOp::REMOVE, key);
+    const size_t fullHash = keyHash(key);
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
     for (size_t i = 0; i < capacity(); ++i) {
+        if (i == 1 && filterRejects(fullHash)) {
+            HASHTABLE_STAT(++m_stats.removeMisses);
+            return false;
+        }
         size_t index = probeIndex(home, i);
-        if (table[index].isNormal() && table[index].getKey() == key) {
-            table[index].markRemoved();
+        if (table[index].holds(key, tag)) {
+            if (isExpired(table[index])) {
+                reclaimExpired(table[index]);
+                HASHTABLE_STAT(++m_stats.removeMisses);
+                return false;
+            }
+            vacate(table[index]);
             --m_size;
+            ++m_tombstones;
+            m_entryBytes -= entryBytes(key);
+            filterRemoved();
+            HASHTABLE_STAT(++m_stats.removes);
+            if (log) {
+                log->append(LogOp::REMOVE, key, 0);
+                logCommitIfDue();
+            }
+            if (feed) feed->record(LogOp::REMOVE, key, 0);
             return true;
         }
         if (table[index].isEmptySinceStart()) {
+            HASHTABLE_STAT(++m_stats.removeMisses);
             return false;
         }
     }
+    HASHTABLE_STAT(++m_stats.removeMisses);
     return false;
 }
 
 /*
  * Check if a key exists in the table.
  */
-bool HashTable::contains(const std::string &key) const {
+bool HashTable::contains(std::string_view key) const {
     return get(key).has_value();
 }
 
 /*
  * Retrieve the value associated with a key, if present.
  * Returns std::optional<size_t> to indicate presence or absence.
+ * An expired entry counts as absent; it is reclaimed by the next mutation
+ * that reaches it or by expireTick().  In cache mode (or under a memory
+ * budget that evicts) a hit sets the bucket's reference bit, and in cache
+ * mode both outcomes are counted.  With a Bloom filter, a
+ * lookup the home slot does not settle asks the filter before probing on.
  */
-std::optional<size_t> HashTable::get(const std::string &key) const {
-    size_t home = hash(key);
+std::optional<size_t> HashTable::get(std::string_view key) const {
+    if (trace) trace->record(TraceOp::GET, key);
+    const size_t fullHash = keyHash(key);
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
     for (size_t i = 0; i < capacity(); ++i) {
+        if (i == 1 && filterRejects(fullHash)) {
+            HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(1));
+            if (isCache()) ++m_cacheMisses;
+            return std::nullopt;
+        }
         size_t index = probeIndex(home, i);
-        if (table[index].isNormal() && table[index].getKey() == key) {
+        if (table[index].holds(key, tag)) {
+            if (isExpired(table[index])) {
+                HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(i));
+                if (isCache()) ++m_cacheMisses;
+                return std::nullopt;
+            }
+            HASHTABLE_STAT(++m_stats.getHits; m_stats.recordHit(i));
+            noteAccess(table[index]);
+            if (evicts()) table[index].touch();
+            if (isCache()) ++m_cacheHits;
             return table[index].getValue();
         }
         if (table[index].isEmptySinceStart()) {
+            HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(i));
+            if (isCache()) ++m_cacheMisses;
             return std::nullopt;
         }
     }
+    HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(capacity()));
+    if (isCache()) ++m_cacheMisses;
     return std::nullopt;
 }
 
+/*
+ * Look up keys[i] into out[i] for every i, with up to groupSize lookups in
+ * flight at once, and return the number of hits.  Results, cache reference
+ * bits and statistics match calling get() on each key in turn.
+ * Each lookup is a coroutine that prefetches the next bucket it needs and
+ * suspends; the loop below resumes the group round-robin, so by the time a
+ * lookup runs again its line has usually arrived.  On a table much larger
+ * than the last-level cache this overlaps the DRAM misses of a whole group
+ * instead of paying for them one after another.  Frames come from the calling
+ * thread's pool, so a batch after the first does not allocate and readers on
+ * different threads do not share frame storage.  Like get(), it still bumps
+ * the table's mutable counters and reference bits, so concurrent readers need
+ * the same locking they would for get().
+ * groupSize is clamped to [1, MAX_BATCH_GROUP]; 8-32 suits most machines.
+ * A trace records each key as a get().
+ */
+size_t HashTable::getBatch(std::span<const std::string_view> keys, std::span<std::optional<size_t>> out,
+                           size_t groupSize) const {
+    const size_t count = std::min(keys.size(), out.size());
+    if (trace) {
+        for (size_t i = 0; i < count; ++i) trace->record(TraceOp::GET, keys[i]);
+    }
+    groupSize = std::clamp<size_t>(groupSize, 1, MAX_BATCH_GROUP);
+    std::array<HashTableLookupTask, MAX_BATCH_GROUP> inFlight;
+
+    // A new lookup runs straight to its first prefetch
+    size_t next = 0;
+    auto start = [&](HashTableLookupTask &slot) {
+        slot = lookupTask(keys[next], out[next]);
+        ++next;
+        slot.resume();
+    };
+
+    size_t active = 0;
+    for (; active < groupSize && next < count; ++active) start(inFlight[active]);
+    while (active > 0) {
+        for (size_t s = 0; s < groupSize; ++s) {
+            HashTableLookupTask &task = inFlight[s];
+            if (!task) continue;
+            if (!task.done()) task.resume();
+            if (!task.done()) continue;
+            if (next < count) {
+                start(task);
+            } else {
+                task = HashTableLookupTask();
+                --active;
+            }
+        }
+    }
+
+    size_t hits = 0;
+    for (size_t i = 0; i < count; ++i) hits += out[i].has_value();
+    return hits;
+}
+
+/*
+ * One getBatch() lookup: the same probe as get(), with a prefetch and a
+ * suspension before each bucket is read.  A candidate key stored outside
+ * its bucket (too long for the small-string buffer) gets a second prefetch
+ * and suspension before it is compared.  The Bloom filter block is fetched
+ * the same way when the home slot does not settle the lookup.
+ */
+HashTableLookupTask HashTable::lookupTask(std::string_view key, std::optional<size_t> &out) const {
+    out.reset();
+    const size_t fullHash = keyHash(key);
+    const size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
+    for (size_t i = 0; i < capacity(); ++i) {
+        if (i == 1 && m_filterBitsPerKey > 0) {
+            filter.prefetch(fullHash);
+            co_await std::suspend_always{};
+            if (filterRejects(fullHash)) {
+                HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(1));
+                if (isCache()) ++m_cacheMisses;
+                co_return;
+            }
+        }
+        const HashTableBucket &bucket = table[probeIndex(home, i)];
+        const char *line = reinterpret_cast<const char *>(&bucket);
+        __builtin_prefetch(line);
+        __builtin_prefetch(line + sizeof(HashTableBucket) - 1);
+        co_await std::suspend_always{};
+
+        if (bucket.mayHold(key, tag)) {
+            const char *stored = bucket.getKey().data();
+            if (stored < line || stored >= line + sizeof(HashTableBucket)) {
+                __builtin_prefetch(stored);
+                co_await std::suspend_always{};
+            }
+            if (bucket.holds(key, tag)) {
+                if (isExpired(bucket)) {
+                    HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(i));
+                    if (isCache()) ++m_cacheMisses;
+                    co_return;
+                }
+                HASHTABLE_STAT(++m_stats.getHits; m_stats.recordHit(i));
+                noteAccess(bucket);
+                if (evicts()) bucket.touch();
+                if (isCache()) ++m_cacheHits;
+                out = bucket.getValue();
+                co_return;
+            }
+        }
+        if (bucket.isEmptySinceStart()) {
+            HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(i));
+            if (isCache()) ++m_cacheMisses;
+            co_return;
+        }
+    }
+    HASHTABLE_STAT(++m_stats.getMisses; m_stats.recordMiss(capacity()));
+    if (isCache()) ++m_cacheMisses;
+}
+
 /*
  * Access or insert a key-value pair using bracket notation.
  * If key is missing, inserts with default value 0 and returns reference.
+ * In cache mode the reference also dies if its entry is later evicted.
+ * Assigning through the reference keeps the entry's TTL.
+ * With a log attached, the value written through the reference is logged
+ * at the next commit point.
+ * Throws std::length_error if the key is new and a table at MAX_CAPACITY
+ * has no free slot left, or a memory budget has no room for it and its
+ * policy cannot make any (insert() returns false instead).  Existing keys
+ * are always returned.
+ */
+size_t &HashTable::operator[](std::string_view key) {
+    if (trace) trace->record(TraceOp::ASSIGN, key);
+    return findOrAdd(key);
+}
+
+/*
+ * operator[] without tracing; also used to load snapshots.
  */
-size_t &HashTable::operator[](const std::string &key) {
-    if (alpha() >= 0.5) {
+size_t &HashTable::findOrAdd(std::string_view key) {
+    if (alpha() >= 0.5 && capacity() < MAX_CAPACITY && canRebuild(capacity() * 2)) {
         resize();
     }
 
-    size_t home = hash(key);
+    if (log) {
+        logCommitIfDue();
+        if (pendingAssign.empty() || pendingAssign.back() != key) {
+            pendingAssign.emplace_back(key);
+        }
+    }
+    if (feed) feed->record(LogOp::ASSIGN, key, 0);
+
+    const size_t fullHash = keyHash(key);
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
     size_t first_empty_spot = capacity();
 
-    for (size_t i = 0; i < capacity(); ++i) {
+    size_t i = 0;
+    for (; i < capacity(); ++i) {
         size_t index = probeIndex(home, i);
-        if (table[index].isNormal() && table[index].getKey() == key) {
+        if (table[index].holds(key, tag)) {
+            if (isExpired(table[index])) {
+                reclaimExpired(table[index]);
+                if (first_empty_spot == capacity()) first_empty_spot = index;
+                break;
+            }
+            HASHTABLE_STAT(++m_stats.bracketHits; m_stats.recordHit(i));
+            noteAccess(table[index]);
+            if (evicts()) table[index].touch();
+            if (isCache()) ++m_cacheHits;
             return table[index].getValueRef();
         }
         if (table[index].isEmpty() && first_empty_spot == capacity()) {
@@ -234,14 +749,280 @@ size_t &HashTable::operator[](const std::string &key) {
         }
     }
 
+    if (floodSuspected(home, i)) {
+        reseedHash();
+        return findOrAdd(key);
+    }
+
+    // A full cache makes room and starts over; a key too large for the byte
+    // budget is still added, since a reference has to be returned
+    if (isCache() && overBudget(entryBytes(key)) && makeRoom(entryBytes(key))) {
+        return findOrAdd(key);
+    }
+
+    // Past the memory budget a reference can't be returned unless the policy makes room
+    if (m_memoryBudget > 0 && !budgetAllows(key)) {
+        if (!makeBudgetRoom(key)) {
+            throw std::length_error("HashTable memory budget exhausted");
+        }
+        return findOrAdd(key);
+    }
+
     if (first_empty_spot != capacity()) {
-        table[first_empty_spot].load(key, 0);
+        if (table[first_empty_spot].isEmptyAfterRemoval()) {
+            --m_tombstones;
+        }
+        fill(table[first_empty_spot], key, 0, tag);
         ++m_size;
+        m_entryBytes += entryBytes(key);
+        filterAdd(fullHash);
+        if (isCache()) ++m_cacheMisses;
+        HASHTABLE_STAT(++m_stats.bracketInserts);
         return table[first_empty_spot].getValueRef();
     }
 
+    // Every slot is taken; a reference can't be returned unless the table grows
+    if (capacity() >= MAX_CAPACITY) {
+        throw std::length_error("HashTable is full at MAX_CAPACITY");
+    }
     resize();
-    return (*this)[key];
+    return findOrAdd(key);
+}
+
+/*
+ * Presize the table so that count entries fit without a resize.  With a
+ * keyCapacity, every empty bucket also reserves that many key bytes, so
+ * inserting keys up to that length into the presized table never allocates.
+ * Under a memory budget the table is only presized if the rebuild fits, and
+ * keyCapacity is ignored: removes give key storage back there anyway.
+ */
+void HashTable::reserve(size_t count, size_t keyCapacity) {
+    size_t needed = std::bit_ceil(2 * count + 1);
+    if (needed > capacity() && canRebuild(needed)) {
+        rehashTo(needed);
+    }
+    if (keyCapacity > 0 && m_memoryBudget == 0) {
+        for (auto &bucket : table) {
+            if (bucket.isEmpty()) {
+                m_keyHeapBytes -= bucket.keyHeapBytes();
+                bucket.reserveKey(keyCapacity);
+                m_keyHeapBytes += bucket.keyHeapBytes();
+            }
+        }
+    }
+}
+
+/*
+ * For each live bucket of source in [begin, end), call
+ * visit(sourceIndex, fullHash, targetIndex) with the key's full hash under
+ * target's hash function and its bucket in target (target.capacity() if absent, possibly expired).
+ * Buckets go PROBE_GROUP at a time: the group's out-of-line keys are
+ * prefetched, then hashed while their home buckets in target are
+ * prefetched, then looked up, so the cache misses of a group overlap instead
+ * of following one another.  Reads only, so threads can share the tables.
+ */
+template<typename Visit>
+void HashTable::probeLive(const HashTable &source, const HashTable &target, size_t begin, size_t end,
+                          Visit visit) {
+    constexpr size_t PROBE_GROUP = 16;
+    const uint64_t now = source.clock->nowMillis();
+    const size_t mask = target.capacity() - 1;
+    size_t indexes[PROBE_GROUP];
+    size_t hashes[PROBE_GROUP];
+    for (size_t i = begin; i < end;) {
+        size_t count = 0;
+        for (; i < end && count < PROBE_GROUP; ++i) {
+            if (!source.isLive(i, now)) continue;
+            __builtin_prefetch(source.table[i].getKey().data());
+            indexes[count++] = i;
+        }
+        for (size_t g = 0; g < count; ++g) {
+            hashes[g] = target.keyHash(source.table[indexes[g]].getKey());
+            __builtin_prefetch(&target.table[hashes[g] & mask]);
+        }
+        for (size_t g = 0; g < count; ++g) {
+            const HashTableBucket &home = target.table[hashes[g] & mask];
+            if (home.isNormal()) __builtin_prefetch(home.getKey().data());
+        }
+        for (size_t g = 0; g < count; ++g) {
+            visit(indexes[g], hashes[g], target.locate(source.table[indexes[g]].getKey(), hashes[g]));
+        }
+    }
+}
+
+/*
+ * Add every live entry of other whose key is not live here, with the same
+ * rules as insert() (values of 9999 are skipped, TTLs are not copied), and
+ * return how many were added.
+ * Instead of copying other's keys and re-probing for each insert, one pass
+ * over other's raw buckets hashes each key once and checks it against this
+ * table; that pass is read-only, so it is split across threads by bucket
+ * range.  The table is then presized for exactly the keys that will be
+ * added, and each goes straight into the first free bucket on its probe
+ * sequence with its saved hash.  A table already at MAX_CAPACITY cannot be
+ * presized past it; keys left over once every bucket is taken are not
+ * added and not counted.
+ */
+size_t HashTable::mergeFrom(const HashTable &other) {
+    enum : uint8_t { SKIP, ABSENT, EXPIRED_HERE };
+    const uint64_t now = clock->nowMillis();
+    std::vector<size_t> hashes(other.capacity());
+    std::vector<uint8_t> action(other.capacity(), SKIP);
+    std::atomic<size_t> toAdd{0};
+
+    forEachRange(other.capacity(), [&](size_t begin, size_t end) {
+        size_t added = 0;
+        probeLive(other, *this, begin, end, [&](size_t i, size_t fullHash, size_t here) {
+            if (other.table[i].getValue() == 9999) return;
+            hashes[i] = fullHash;
+            if (here == capacity()) {
+                action[i] = ABSENT;
+                ++added;
+            } else if (!isLive(here, now)) {
+                action[i] = EXPIRED_HERE;
+                ++added;
+            }
+        });
+        toAdd += added;
+    });
+
+    if (toAdd == 0) return 0;
+    if (!isCache()) reserve(m_size + toAdd);
+
+    // Prefetch a few entries ahead: both the source key and the home bucket
+    // it is going to are usually cache misses
+    constexpr size_t AHEAD = 8;
+    std::vector<HashTableIndex> pending;
+    pending.reserve(toAdd);
+    for (size_t i = 0; i < other.capacity(); ++i) {
+        if (action[i] != SKIP) pending.push_back(static_cast<HashTableIndex>(i));
+    }
+    // A flood detected while placing reseeds the hash; later saved hashes are stale
+    const uint64_t reseeds = m_reseeds;
+    const size_t mask = capacity() - 1;
+    size_t added = 0;
+    bool full = false; // at MAX_CAPACITY the presize can fall short
+    for (size_t p = 0; p < pending.size(); ++p) {
+        if (p + AHEAD < pending.size()) {
+            size_t ahead = pending[p + AHEAD];
+            __builtin_prefetch(other.table[ahead].getKey().data());
+            __builtin_prefetch(&table[hashes[ahead] & mask]);
+        }
+        const size_t i = pending[p];
+        const HashTableBucket &bucket = other.table[i];
+        const size_t fullHash = m_reseeds == reseeds ? hashes[i] : keyHash(bucket.getKey());
+        if (action[i] == ABSENT && !isCache() && m_memoryBudget == 0) {
+            if (full) continue;
+            full = !placeNew(bucket.getKey(), bucket.getValue(), fullHash);
+            added += !full;
+        } else {
+            added += insertHashed(bucket.getKey(), bucket.getValue(), fullHash);
+        }
+    }
+#ifdef HASHTABLE_JSON_DUMPS
+    debugDumpToJSON();
+#endif
+    return added;
+}
+
+/*
+ * Remove every entry whose key is not live in other and return how many
+ * were removed.  The membership pass over this table's buckets is read-only
+ * and runs across threads; the removes are then applied in one sweep and
+ * logged like remove().
+ */
+size_t HashTable::intersectWith(const HashTable &other) {
+    const uint64_t otherNow = other.clock->nowMillis();
+    std::vector<uint8_t> marked(capacity(), 0);
+    forEachRange(capacity(), [&](size_t begin, size_t end) {
+        probeLive(*this, other, begin, end, [&](size_t i, size_t, size_t there) {
+            marked[i] = there == other.capacity() || !other.isLive(there, otherNow);
+        });
+    });
+    return dropMarked(marked);
+}
+
+/*
+ * Remove every entry whose key is live in other and return how many were
+ * removed.  The pass walks whichever table is smaller: each live key found
+ * in the other one marks a bucket of this table, and distinct keys mark
+ * distinct buckets, so the threads never write the same flag.
+ */
+size_t HashTable::subtract(const HashTable &other) {
+    const uint64_t now = clock->nowMillis();
+    const uint64_t otherNow = other.clock->nowMillis();
+    std::vector<uint8_t> marked(capacity(), 0);
+    if (other.size() < size()) {
+        forEachRange(other.capacity(), [&](size_t begin, size_t end) {
+            probeLive(other, *this, begin, end, [&](size_t, size_t, size_t here) {
+                if (here != capacity() && isLive(here, now)) marked[here] = 1;
+            });
+        });
+    } else {
+        forEachRange(capacity(), [&](size_t begin, size_t end) {
+            probeLive(*this, other, begin, end, [&](size_t i, size_t, size_t there) {
+                marked[i] = there != other.capacity() && other.isLive(there, otherNow);
+            });
+        });
+    }
+    return dropMarked(marked);
+}
+
+/*
+ * Remove the marked buckets, then compact if they left the table sparse.
+ */
+size_t HashTable::dropMarked(const std::vector<uint8_t> &marked) {
+    size_t dropped = 0;
+    for (size_t i = 0; i < marked.size(); ++i) {
+        if (marked[i]) {
+            dropBucket(table[i]);
+            ++dropped;
+        }
+    }
+    if (dropped > 0) {
+        HASHTABLE_STAT(m_stats.removes += dropped);
+        if (log) logCommitIfDue();
+        compactIfSparse();
+    }
+    return dropped;
+}
+
+/*
+ * Store a key known to be absent in the first free bucket of its probe
+ * sequence.  The caller has already made room, so this never resizes,
+ * though a flood found on the way rebuilds the table under a new hash.
+ * Returns false, storing nothing, if every bucket is taken.
+ */
+bool HashTable::placeNew(std::string_view key, const size_t &value, size_t fullHash) {
+    size_t home = fullHash & (capacity() - 1);
+    for (size_t i = 0; i < capacity(); ++i) {
+        HashTableBucket &bucket = table[probeIndex(home, i)];
+        if (!bucket.isEmpty()) continue;
+        if (bucket.isEmptyAfterRemoval()) --m_tombstones;
+        fill(bucket, key, value, HashTableBucket::tagOf(fullHash));
+        ++m_size;
+        m_entryBytes += entryBytes(key);
+        filterAdd(fullHash);
+        HASHTABLE_STAT(++m_stats.inserts);
+        if (log) {
+            log->append(LogOp::INSERT, key, value);
+            logCommitIfDue();
+        }
+        if (feed) feed->record(LogOp::INSERT, key, value);
+        if (floodSuspected(home, i)) reseedHash();
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Load a new entry into bucket, keeping the count of key storage outside
+ * the buckets current.
+ */
+void HashTable::fill(HashTableBucket &bucket, std::string_view key, const size_t &value, uint32_t tag) {
+    m_keyHeapBytes -= bucket.keyHeapBytes();
+    bucket.load(key, value, tag);
+    m_keyHeapBytes += bucket.keyHeapBytes();
 }
 
 /*
@@ -249,14 +1030,43 @@ size_t &HashTable::operator[](const std::string &key) {
  */
 std::vector<std::string> HashTable::keys() const {
     std::vector<std::string> result;
+    result.reserve(m_size);
+    uint64_t now = clock->nowMillis();
     for (const auto &bucket : table) {
-        if (bucket.isNormal()) {
+        if (bucket.isNormal() && !bucket.isExpired(now)) {
             result.push_back(bucket.getKey());
         }
     }
     return result;
 }
 
+/*
+ * Iterators over NORMAL buckets; see HashTable::BasicIterator.
+ */
+HashTable::iterator HashTable::begin() {
+    return {table.data(), table.data() + table.size(), clock->nowMillis()};
+}
+
+HashTable::iterator HashTable::end() {
+    return {table.data() + table.size(), table.data() + table.size()};
+}
+
+HashTable::const_iterator HashTable::begin() const {
+    return {table.data(), table.data() + table.size(), clock->nowMillis()};
+}
+
+HashTable::const_iterator HashTable::end() const {
+    return {table.data() + table.size(), table.data() + table.size()};
+}
+
+HashTable::const_iterator HashTable::cbegin() const {
+    return begin();
+}
+
+HashTable::const_iterator HashTable::cend() const {
+    return end();
+}
+
 /*
  * Return current load factor (alpha = size / capacity).
  */
@@ -265,6 +1075,68 @@ double HashTable::alpha() const {
     return static_cast<double>(this->m_size) / static_cast<double>(capacity());
 }
 
+/*
+ * Return number of buckets in the EAR (tombstone) state.
+ */
+size_t HashTable::tombstones() const {
+    return m_tombstones;
+}
+
+/*
+ * Snapshot of table statistics.  Shape figures are always filled in; probe
+ * histograms and operation counters only when built with HASHTABLE_STATS.
+ */
+HashTableStats HashTable::stats() const {
+#ifdef HASHTABLE_STATS
+    HashTableStats snapshot = m_stats;
+    snapshot.enabled = true;
+#else
+    HashTableStats snapshot;
+#endif
+    snapshot.size = m_size;
+    snapshot.capacity = capacity();
+    snapshot.tombstones = m_tombstones;
+    snapshot.loadFactor = alpha();
+    snapshot.cacheMode = isCache();
+    snapshot.cacheMaxEntries = m_cacheMaxEntries;
+    snapshot.cacheMaxBytes = m_cacheMaxBytes;
+    snapshot.cacheBytes = m_entryBytes;
+    snapshot.cacheHits = m_cacheHits;
+    snapshot.cacheMisses = m_cacheMisses;
+    snapshot.evictions = m_evictions;
+    snapshot.compactions = m_compactions;
+    snapshot.expirations = m_expirations;
+    snapshot.ttlTimers = wheel.pending();
+    snapshot.bloomBitsPerKey = m_filterBitsPerKey;
+    snapshot.bloomBytes = filter.bytes();
+    snapshot.bloomRejects = m_filterRejects;
+    snapshot.bloomRebuilds = m_filterRebuilds;
+    snapshot.keyedHash = m_keyedHash;
+    snapshot.hashReseeds = m_reseeds;
+    snapshot.memoryBytes = budgetedBytes();
+    snapshot.memoryBudget = m_memoryBudget;
+    snapshot.budgetRejects = m_budgetRejects;
+    return snapshot;
+}
+
+/*
+ * Clear the recorded counters and histograms.  Cache counters are always
+ * kept; the rest only exist with HASHTABLE_STATS.
+ */
+void HashTable::resetStats() {
+#ifdef HASHTABLE_STATS
+    m_stats = HashTableStats();
+#endif
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+    m_evictions = 0;
+    m_compactions = 0;
+    m_expirations = 0;
+    m_filterRejects = 0;
+    m_filterRebuilds = 0;
+    m_budgetRejects = 0;
+}
+
 /*
  * Return total number of buckets in the table.
  */
@@ -284,26 +1156,611 @@ size_t HashTable::size() const {
  * Used for deterministic reordering and forensic inspection.
  */
 void HashTable::rehashBackwards() {
-    std::vector<std::pair<std::string, size_t>> keyValuePairs;
+    auto asciiSum = [](const std::string &key) {
+        int sum = 0;
+        for (char c : key) sum += c;
+        return sum;
+    };
+    rehashInOrder([&](const HashTableBucket &a, const HashTableBucket &b) {
+        return asciiSum(a.getKey()) > asciiSum(b.getKey());
+    });
+#ifdef HASHTABLE_JSON_DUMPS
+    debugDumpToJSON();
+#endif
+}
+
+/*
+ * Sample lookup hits for reoptimize(): one hit in oneIn (rounded up to a
+ * power of two) bumps the hit bucket's 8-bit saturating counter.  Sampling
+ * keeps the counters from saturating and costs a hot lookup one increment
+ * of a table field; 0 turns sampling off.
+ */
+void HashTable::setAccessSampling(size_t oneIn) {
+    m_accessSampleEvery = oneIn == 0 ? 0 : std::bit_ceil(oneIn);
+}
+
+/*
+ * Average number of buckets a hit reads, weighting each live entry by its
+ * access counter (every entry weighs the same when none has been sampled).
+ */
+double HashTable::weightedProbeLength() const {
+    const uint64_t now = clock->nowMillis();
+    double weighted = 0, plain = 0;
+    uint64_t weight = 0, entries = 0;
+    for (size_t index = 0; index < capacity(); ++index) {
+        if (!table[index].isNormal() || table[index].isExpired(now)) continue;
+        double probes = static_cast<double>(probeDistance(index) + 1);
+        uint8_t count = table[index].getAccessCount();
+        weighted += probes * count;
+        weight += count;
+        plain += probes;
+        ++entries;
+    }
+    if (weight > 0) return weighted / static_cast<double>(weight);
+    return entries > 0 ? plain / static_cast<double>(entries) : 0.0;
+}
+
+/*
+ * Rebuild with the most-accessed keys placed first, so the hottest ones
+ * mostly sit in their home slot and are found with one bucket read.  Ties
+ * keep table order.  Counters are then halved, so the next call ranks recent
+ * traffic above old.  O(n log n); see reoptimize(cursor, maxHomes) for an
+ * incremental version.
+ */
+HashTableLayoutReport HashTable::reoptimize() {
+    HashTableLayoutReport report;
+    report.probesBefore = weightedProbeLength();
+    rehashInOrder([](const HashTableBucket &a, const HashTableBucket &b) {
+        return a.getAccessCount() > b.getAccessCount();
+    });
+    report.probesAfter = weightedProbeLength();
+    for (auto &bucket : table) bucket.ageAccessCount();
+    return report;
+}
+
+/*
+ * Incremental reoptimize(): for at most maxHomes home slots, reorder the
+ * entries that hash to that home so the most-accessed ones take the
+ * earliest of the slots they already hold along its probe sequence, then
+ * halve their counters.  Entries only trade places within one probe
+ * sequence, so lookups stay correct between calls, and a call does
+ * O(maxHomes) work.  It cannot move a hot key into a slot held by another
+ * home's key; the full reoptimize() can.  Cursors work like scan(): pass 0
+ * to start, and 0 comes back once every home has been visited (restart if
+ * hashEpoch() changes on the way).
+ */
+size_t HashTable::reoptimize(size_t cursor, size_t maxHomes) {
+    const size_t mask = capacity() - 1;
+    std::vector<size_t> slots;
+    std::vector<HashTableBucket> entries;
+    for (size_t n = 0; n < maxHomes; ++n) {
+        const size_t home = cursor & mask;
+        slots.clear();
+        for (size_t i = 0; i < capacity(); ++i) {
+            size_t index = probeIndex(home, i);
+            if (table[index].isEmptySinceStart()) break;
+            if (table[index].isNormal() && hash(table[index].getKey()) == home) slots.push_back(index);
+        }
+        auto hotter = [this](size_t a, size_t b) { return table[a].getAccessCount() > table[b].getAccessCount(); };
+        if (!std::is_sorted(slots.begin(), slots.end(), hotter)) {
+            entries.clear();
+            for (size_t index : slots) entries.push_back(std::move(table[index]));
+            std::stable_sort(entries.begin(), entries.end(), [](const HashTableBucket &a, const HashTableBucket &b) {
+                return a.getAccessCount() > b.getAccessCount();
+            });
+            for (size_t k = 0; k < slots.size(); ++k) table[slots[k]] = std::move(entries[k]);
+        }
+        for (size_t index : slots) table[index].ageAccessCount();
+
+        cursor = advanceCursor(cursor, mask);
+        if (cursor == 0) return 0;
+    }
+    return cursor;
+}
+
+/*
+ * Attempts needed to reach the entry at index from its home slot.
+ */
+size_t HashTable::probeDistance(size_t index) const {
+    size_t home = hash(table[index].getKey());
+    for (size_t i = 0; i < capacity(); ++i) {
+        if (probeIndex(home, i) == index) return i;
+    }
+    return capacity();
+}
+
+/*
+ * Next scan-style cursor: increment the cursor's reversed bits above the
+ * mask, so the walk survives resizes.  0 means the walk is complete.
+ */
+size_t HashTable::advanceCursor(size_t cursor, size_t mask) {
+    auto reverse = [](size_t v) {
+        size_t r = 0;
+        for (size_t bit = 0; bit < 8 * sizeof(size_t); ++bit, v >>= 1) r = (r << 1) | (v & 1);
+        return r;
+    };
+    cursor |= ~mask;
+    return reverse(reverse(cursor) + 1);
+}
+
+/*
+ * Probe-length outlier check for an insert whose probe stopped after
+ * probes buckets.  At load 0.5 with shuffled offsets, FLOOD_PROBES buckets
+ * in a row are almost never all taken, but tombstones or plain clustering
+ * can still do it.  What separates a flood is that keys which share a home
+ * slot share its whole probe sequence, so the first FLOOD_PROBES buckets
+ * are rehashed and the table counts as flooded when half of them hold keys
+ * from this home.  That costs a few dozen hashes, only on outlier inserts.
+ * A table whose memory budget has no room for the rebuild keeps its hash.
+ */
+bool HashTable::floodSuspected(size_t home, size_t probes) const {
+    if (!m_floodGuard || probes < FLOOD_PROBES) return false;
+    size_t shared = 0;
+    for (size_t i = 0; i < FLOOD_PROBES; ++i) {
+        const HashTableBucket &bucket = table[probeIndex(home, i)];
+        if (bucket.isNormal() && hash(bucket.getKey()) == home) ++shared;
+    }
+    return shared >= FLOOD_PROBES / 2 && canRebuild(capacity());
+}
+
+/*
+ * Switch to SipHash under a fresh random key and rebuild at the same
+ * capacity, so the colliding keys scatter.  A table that is already keyed
+ * just draws a new key.
+ */
+void HashTable::reseedHash() {
+    sipHash = HashTableSipHash::random();
+    m_keyedHash = true;
+    ++m_reseeds;
+    rehashTo(capacity());
+}
+
+/*
+ * Turn the flood check on (the default) or off.  Turning it off keeps the
+ * current hash function; it only stops further switches.
+ */
+void HashTable::setFloodProtection(bool on) {
+    m_floodGuard = on;
+}
+
+/*
+ * True once a flood has switched this table to keyed SipHash.
+ */
+bool HashTable::keyedHash() const {
+    return m_keyedHash;
+}
+
+/*
+ * Switch to SipHash under a fresh random key now, as a detected flood would,
+ * and rebuild the table.  Counts as a reseed in stats().
+ */
+void HashTable::useKeyedHash() {
+    reseedHash();
+}
+
+/*
+ * Number of times the hash function has changed.  Every key gets a new
+ * home when it does, so scan() and reoptimize(cursor) walks begun under an
+ * older epoch must start over from cursor 0.
+ */
+uint64_t HashTable::hashEpoch() const {
+    return m_reseeds;
+}
+
+/*
+ * Turn the table into a bounded cache holding at most maxEntries entries and,
+ * if maxBytes is non-zero, at most maxBytes of keys and values.  Once the
+ * budget is reached inserts evict with CLOCK instead of resizing.  The table
+ * is grown once here so the budget always fits under the 0.5 load factor.
+ * maxEntries 0 turns cache mode off again.
+ */
+void HashTable::setCacheBudget(size_t maxEntries, size_t maxBytes) {
+    m_cacheMaxEntries = maxEntries;
+    m_cacheMaxBytes = maxEntries > 0 ? maxBytes : 0;
+    if (!isCache()) return;
+
+    while (m_size > m_cacheMaxEntries || (m_cacheMaxBytes > 0 && m_entryBytes > m_cacheMaxBytes)) {
+        evictOne();
+    }
+    size_t needed = std::bit_ceil(2 * maxEntries + 1);
+    if (needed > capacity() || m_tombstones > 0) {
+        rehashTo(std::max(needed, capacity()));
+    }
+}
+
+/*
+ * Return true when a cache budget is set.
+ */
+bool HashTable::isCache() const {
+    return m_cacheMaxEntries > 0;
+}
+
+/*
+ * True if one more entry of extraBytes would exceed the cache budget.
+ */
+bool HashTable::overBudget(size_t extraBytes) const {
+    return m_size + 1 > m_cacheMaxEntries || (m_cacheMaxBytes > 0 && m_entryBytes + extraBytes > m_cacheMaxBytes);
+}
+
+/*
+ * Evict until an entry of extraBytes fits, then compact if evictions have
+ * left more than a quarter of the buckets as tombstones; without that, probe
+ * sequences would run out of ESS buckets and misses would scan the whole
+ * table.  Returns false, evicting nothing, if the entry alone is over budget.
+ */
+bool HashTable::makeRoom(size_t extraBytes) {
+    if (m_cacheMaxBytes > 0 && extraBytes > m_cacheMaxBytes) {
+        return false;
+    }
+    while (m_size > 0 && overBudget(extraBytes)) {
+        evictOne();
+    }
+    compactIfSparse();
+    return true;
+}
+
+/*
+ * Rebuild in place, dropping tombstones, once they fill a quarter of the
+ * buckets; after mass removals they would otherwise lengthen every probe.
+ * Skipped while a memory budget has no room for the second bucket array.
+ */
+void HashTable::compactIfSparse() {
+    if (m_tombstones > capacity() / 4 && canRebuild(capacity())) {
+        rehashTo(capacity());
+        ++m_compactions;
+    }
+}
+
+/*
+ * CLOCK eviction: sweep the hand over the buckets, giving entries whose
+ * reference bit is set a second chance (clearing the bit), and evict the
+ * first unreferenced entry.  Evictions are logged as removes.
+ */
+void HashTable::evictOne() {
+    while (true) {
+        HashTableBucket &bucket = table[m_clockHand];
+        m_clockHand = (m_clockHand + 1) & (capacity() - 1);
+        if (!bucket.isNormal()) continue;
+        if (bucket.isReferenced()) {
+            bucket.clearReferenced();
+            continue;
+        }
+        dropBucket(bucket);
+        ++m_evictions;
+        return;
+    }
+}
+
+/*
+ * Remove the entry in bucket on the table's behalf (eviction or expiry),
+ * logging it as a remove so recovery and replicas agree.
+ */
+void HashTable::dropBucket(HashTableBucket &bucket) {
+    if (log) {
+        log->append(LogOp::REMOVE, bucket.getKey(), 0);
+    }
+    if (feed) feed->record(LogOp::REMOVE, bucket.getKey(), 0);
+    m_entryBytes -= entryBytes(bucket.getKey());
+    vacate(bucket);
+    --m_size;
+    ++m_tombstones;
+    filterRemoved();
+}
+
+/*
+ * Turn bucket into a tombstone.  Its key storage is normally kept for the
+ * next key loaded there; under a memory budget it is freed, so the budget
+ * only pays for live keys.
+ */
+void HashTable::vacate(HashTableBucket &bucket) {
+    bucket.markRemoved();
+    if (m_memoryBudget > 0) {
+        m_keyHeapBytes -= bucket.keyHeapBytes();
+        bucket.releaseKey();
+    }
+}
+
+/*
+ * Index of the bucket holding key, expired or not, or capacity() if absent.
+ */
+size_t HashTable::find(std::string_view key) const {
+    const size_t fullHash = keyHash(key);
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
+    for (size_t i = 0; i < capacity(); ++i) {
+        if (i == 1 && filterRejects(fullHash)) break;
+        size_t index = probeIndex(home, i);
+        if (table[index].holds(key, tag)) {
+            return index;
+        }
+        if (table[index].isEmptySinceStart()) {
+            break;
+        }
+    }
+    return capacity();
+}
+
+/*
+ * find() for a key whose full hash is known, without touching any counter,
+ * so several threads can call it at once on an unchanging table.
+ */
+size_t HashTable::locate(std::string_view key, size_t fullHash) const {
+    size_t home = fullHash & (capacity() - 1);
+    const uint32_t tag = HashTableBucket::tagOf(fullHash);
+    for (size_t i = 0; i < capacity(); ++i) {
+        if (i == 1 && m_filterBitsPerKey > 0 && !filter.mayContain(fullHash)) break;
+        size_t index = probeIndex(home, i);
+        if (table[index].holds(key, tag)) {
+            return index;
+        }
+        if (table[index].isEmptySinceStart()) {
+            break;
+        }
+    }
+    return capacity();
+}
+
+// NORMAL and not expired at now
+bool HashTable::isLive(size_t index, uint64_t now) const {
+    return table[index].isNormal() && !table[index].isExpired(now);
+}
+
+/*
+ * True if the bucket's TTL has run out.  The clock is only read for entries
+ * that have a deadline, so tables without TTLs never pay for it.
+ */
+bool HashTable::isExpired(const HashTableBucket &bucket) const {
+    return bucket.getExpiry() != 0 && bucket.isExpired(clock->nowMillis());
+}
+
+void HashTable::reclaimExpired(HashTableBucket &bucket) {
+    dropBucket(bucket);
+    ++m_expirations;
+}
+
+/*
+ * Put a Bloom filter of bitsPerKey bits per entry (sized for the 0.5 load
+ * factor) in front of lookups, built from the current entries.  About 10
+ * bits per key lets roughly 1% of absent keys through to probing.
+ * bitsPerKey 0 removes the filter.
+ */
+void HashTable::setBloomFilter(size_t bitsPerKey) {
+    m_filterBitsPerKey = bitsPerKey;
+    if (bitsPerKey == 0) {
+        filter.clear();
+        m_filterStale = 0;
+        return;
+    }
+    rebuildFilter();
+}
+
+/*
+ * Return true when a Bloom filter is in use.
+ */
+bool HashTable::hasBloomFilter() const {
+    return m_filterBitsPerKey > 0;
+}
+
+/*
+ * True if the filter proves the key absent, so the caller can stop probing.
+ * Lookups only ask once the home slot has not settled them: the filter costs
+ * about one cache miss, as much as the home slot itself, so it pays off only
+ * on the longer probe sequences that load and tombstones create.
+ */
+bool HashTable::filterRejects(size_t fullHash) const {
+    if (m_filterBitsPerKey == 0 || filter.mayContain(fullHash)) return false;
+    ++m_filterRejects;
+    return true;
+}
+
+void HashTable::filterAdd(size_t fullHash) {
+    if (m_filterBitsPerKey > 0) filter.add(fullHash);
+}
+
+/*
+ * A removed key's bits stay set and only cost false positives.  Once removes
+ * since the last build reach a quarter of the capacity, rebuild from the live
+ * entries; the rebuild is O(capacity), so this is O(1) amortized per remove.
+ */
+void HashTable::filterRemoved() {
+    if (m_filterBitsPerKey > 0 && ++m_filterStale > capacity() / 4) {
+        rebuildFilter();
+    }
+}
+
+/*
+ * Refill the filter from every NORMAL bucket.  Expired entries that have not
+ * been reclaimed are still in the table, so they are added too.
+ */
+void HashTable::rebuildFilter() {
+    filter.reset(capacity() / 2, m_filterBitsPerKey);
     for (const auto &bucket : table) {
-        if (bucket.isNormal()) {
-            keyValuePairs.push_back({bucket.getKey(), bucket.getValue()});
+        if (bucket.isNormal()) filter.add(keyHash(bucket.getKey()));
+    }
+    m_filterStale = 0;
+    ++m_filterRebuilds;
+}
+
+/*
+ * Heap bytes held by the table, by component.  Walks the buckets and the
+ * timer wheel, so it is O(capacity + timers).  resizePeak adds what the next
+ * doubling allocates before it frees the old bucket array; at MAX_CAPACITY
+ * there is no next doubling and it equals total().
+ */
+HashTableMemoryUsage HashTable::memoryUsage() const {
+    HashTableMemoryUsage usage;
+    usage.buckets = table.capacity() * sizeof(HashTableBucket);
+    usage.offsets = offsets.capacity() * sizeof(HashTableIndex);
+    for (const auto &bucket : table) usage.keys += bucket.keyHeapBytes();
+    usage.filter = filter.bytes();
+    usage.timers = wheel.bytes();
+    usage.pending = pendingAssign.capacity() * sizeof(std::string);
+    for (const auto &key : pendingAssign) usage.pending += HashTableBucket::heapBytesFor(key.capacity());
+    usage.batchFrames = HashTableFramePool::local().bytes();
+    usage.resizePeak = usage.total();
+    if (capacity() < MAX_CAPACITY) usage.resizePeak += rebuildPeak(capacity() * 2) - budgetedBytes();
+    return usage;
+}
+
+/*
+ * Cap the bucket array, probe offsets, Bloom filter and key storage at
+ * maxBytes (0 removes the cap).  A growth or rebuild goes ahead only if its
+ * peak, with the old and new bucket arrays both live, fits; otherwise a new
+ * key is handled by policy.  MemoryPolicy::EVICT also evicts down to the
+ * budget now.  TTL timers, pending log keys and batch frames are reported by
+ * memoryUsage() but not capped.
+ */
+void HashTable::setMemoryBudget(size_t maxBytes, MemoryPolicy policy) {
+    m_memoryBudget = maxBytes;
+    m_memoryPolicy = policy;
+    if (maxBytes == 0) return;
+
+    // Keys removed before now kept their storage; the budget does not pay for it
+    for (auto &bucket : table) {
+        if (bucket.isEmpty()) {
+            m_keyHeapBytes -= bucket.keyHeapBytes();
+            bucket.releaseKey();
         }
     }
+    if (policy == MemoryPolicy::EVICT) {
+        while (m_size > 0 && budgetedBytes() > m_memoryBudget) evictOne();
+    }
+}
 
-    std::ranges::sort(keyValuePairs, [](const auto &a, const auto &b) {
-        int sumA = 0, sumB = 0;
-        for (char c : a.first) sumA += c;
-        for (char c : b.first) sumB += c;
-        return sumA > sumB;
-    });
+/*
+ * Return the memory budget in bytes, 0 if there is none.
+ */
+size_t HashTable::memoryBudget() const {
+    return m_memoryBudget;
+}
 
-    table.assign(capacity(), HashTableBucket());
-    m_size = 0;
+// What the memory budget covers: bucket array, offsets, filter and key storage; O(1)
+size_t HashTable::budgetedBytes() const {
+    return table.capacity() * sizeof(HashTableBucket) + offsets.capacity() * sizeof(HashTableIndex) +
+           filter.bytes() + m_keyHeapBytes;
+}
+
+/*
+ * budgetedBytes() at the peak of rehashTo(newCapacity): the old bucket array
+ * is freed only once every entry has moved to the new one, but the old
+ * offsets and filter go first (clearForRebuild) and keys move uncopied.
+ */
+size_t HashTable::rebuildPeak(size_t newCapacity) const {
+    const size_t newOffsets = offsets.size() + 1 == newCapacity ? offsets.capacity() : newCapacity - 1;
+    size_t peak = (table.capacity() + newCapacity) * sizeof(HashTableBucket) + newOffsets * sizeof(HashTableIndex) +
+                  m_keyHeapBytes;
+    if (m_filterBitsPerKey > 0) peak += HashTableBloomFilter::bytesFor(newCapacity / 2, m_filterBitsPerKey);
+    return peak;
+}
+
+// True if rebuilding at newCapacity stays within the memory budget (always, without one)
+bool HashTable::canRebuild(size_t newCapacity) const {
+    return m_memoryBudget == 0 || rebuildPeak(newCapacity) <= m_memoryBudget;
+}
+
+/*
+ * True if the budget has room for key at the current capacity: its storage
+ * fits, and the table is below the load at which it would have grown (0.5;
+ * MAX_FILL_LOAD under MemoryPolicy::FILL).  Only consulted when the growth
+ * did not fit, or a table at MAX_CAPACITY, which has no such load.
+ */
+bool HashTable::budgetAllows(std::string_view key) const {
+    const double maxLoad = m_memoryPolicy == MemoryPolicy::FILL ? MAX_FILL_LOAD : 0.5;
+    if (capacity() < MAX_CAPACITY && alpha() >= maxLoad) return false;
+    return budgetedBytes() + HashTableBucket::heapBytesFor(key.size()) <= m_memoryBudget;
+}
+
+/*
+ * Apply the memory policy for a key the budget has no room for.  EVICT
+ * removes entries with CLOCK (as cache mode does) until the key fits, then
+ * compacts if that is affordable; FAIL and FILL give up.  Returns true if
+ * the key fits now.
+ */
+bool HashTable::makeBudgetRoom(std::string_view key) {
+    if (m_memoryPolicy == MemoryPolicy::EVICT) {
+        while (m_size > 0 && !budgetAllows(key)) {
+            evictOne();
+        }
+        compactIfSparse();
+        if (budgetAllows(key)) return true;
+    }
+    ++m_budgetRejects;
+    return false;
+}
+
+/*
+ * Insert with a time to live: the entry disappears from lookups once ttl has
+ * passed on the table's clock.
+ */
+bool HashTable::insert(std::string_view key, const size_t &value, std::chrono::milliseconds ttl) {
+    if (!insert(key, value)) return false;
+    expire(key, ttl);
+    return true;
+}
 
-    for (const auto &pair : keyValuePairs) {
-        insert(pair.first, pair.second);
+/*
+ * Give an existing entry a new time to live (replacing any earlier one) and
+ * file it with the timer wheel.  An entry that already has a timer due no
+ * later than the new deadline keeps it, and expireTick re-files it when it
+ * fires, so refreshing a key's TTL over and over holds one timer, not one per
+ * call.  Returns false if the key is absent.
+ */
+bool HashTable::expire(std::string_view key, std::chrono::milliseconds ttl) {
+    size_t index = find(key);
+    if (index == capacity() || isExpired(table[index])) return false;
+    uint64_t now = clock->nowMillis();
+    uint64_t expiresAt = std::max<uint64_t>(now + static_cast<uint64_t>(std::max<int64_t>(ttl.count(), 0)), 1);
+    uint64_t previous = table[index].getExpiry();
+    table[index].setExpiry(expiresAt);
+    if (previous == 0 || expiresAt < previous) {
+        wheel.schedule(key, expiresAt, now);
+    }
+    return true;
+}
+
+/*
+ * Time left before key expires, or nullopt if the key is absent or has no TTL.
+ */
+std::optional<std::chrono::milliseconds> HashTable::ttl(std::string_view key) const {
+    size_t index = find(key);
+    if (index == capacity() || table[index].getExpiry() == 0 || isExpired(table[index])) {
+        return std::nullopt;
     }
+    return std::chrono::milliseconds(table[index].getExpiry() - clock->nowMillis());
+}
+
+/*
+ * Active expiry: let the timer wheel fire up to maxWork due timers and
+ * reclaim each entry that is still expired with that same deadline.  A timer
+ * for an entry whose TTL was pushed back is filed again for the new deadline;
+ * timers left behind by removes or shortened TTLs are dropped.  Cost is
+ * bounded by maxWork, so callers can run it from a hot loop.  Returns entries
+ * reclaimed.
+ */
+size_t HashTable::expireTick(size_t maxWork) {
+    uint64_t now = clock->nowMillis();
+    size_t reclaimed = 0;
+    wheel.advance(now, maxWork, [&](std::string_view key, uint64_t expiresAt) {
+        size_t index = find(key);
+        if (index == capacity()) return;
+        uint64_t current = table[index].getExpiry();
+        if (current == expiresAt && table[index].isExpired(now)) {
+            reclaimExpired(table[index]);
+            ++reclaimed;
+        } else if (current > expiresAt) {
+            wheel.schedule(key, current, now);
+        }
+    });
+    return reclaimed;
+}
+
+/*
+ * Swap the time source (nullptr restores the steady clock).  Deadlines are
+ * on the clock's own scale, so set the clock before giving entries TTLs.
+ */
+void HashTable::setClock(const HashTableClock *source) {
+    clock = source ? source : &HashTableClock::steady();
+    wheel.clear();
 }
 
   // Dump current table state to JSON for debugging and forensic inspection.
@@ -357,6 +1814,269 @@ void HashTable::rehashBackwards() {
         file << "\n  ]\n}\n";
     }
 
+/*
+ * Attach (or with nullptr, detach) a write-ahead log.  Detaching commits
+ * anything still buffered first.  A log serves one table at a time, so
+ * attaching one that another table holds detaches it there.
+ */
+void HashTable::attachLog(HashTableLog *wal) {
+    if (log) {
+        syncLog();
+        if (log->table == this) log->table = nullptr;
+    }
+    if (wal && wal->table && wal->table != this) {
+        wal->table->attachLog(nullptr);
+    }
+    log = wal;
+    if (log) log->table = this;
+}
+
+/*
+ * Attach (or with nullptr, detach) an operation trace.  Every later insert,
+ * get / contains / getBatch, remove and operator[] call is recorded in it;
+ * bulk set operations and iteration are not.
+ */
+void HashTable::attachTrace(HashTableTrace *recorder) {
+    trace = recorder;
+}
+
+/*
+ * Attach (or with nullptr, detach) a replication change feed.  Every later
+ * insert, remove, operator[] call, eviction and expiry is recorded in it,
+ * bulk set operations included.  Writes through iterators or a reference
+ * kept from an earlier operator[] call are not.
+ */
+void HashTable::attachFeed(HashTableChangeFeed *changes) {
+    feed = changes;
+}
+
+/*
+ * Answer one HashTableReplica::pull: read its PULL frame from in and write
+ * the reply to out (the same descriptor for a socket).  If the feed still
+ * holds every change since the replica's version, the reply is those
+ * changes, at most as many as it asked for; otherwise it is a snapshot of
+ * every live entry.  Values are read from the table as the reply is built,
+ * so a change is sent as the key's current value, or as a remove if the key
+ * is gone or expired.  TTLs are not replicated.  Returns false once in is
+ * closed, on a malformed request, or if no feed is attached.
+ */
+bool HashTable::serveReplica(int in, int out) {
+    ReplicationFrame type;
+    std::string request;
+    if (!feed || !HashTableChangeFeed::readFrame(in, type, request, HashTableChangeFeed::PULL_BYTES)) return false;
+    uint64_t epoch = 0, from = 0;
+    uint32_t max = 0;
+    if (type != ReplicationFrame::PULL || request.size() != HashTableChangeFeed::PULL_BYTES) return false;
+    std::memcpy(&epoch, request.data(), sizeof(epoch));
+    std::memcpy(&from, request.data() + sizeof(epoch), sizeof(from));
+    std::memcpy(&max, request.data() + sizeof(epoch) + sizeof(from), sizeof(max));
+    max = std::max<uint32_t>(max, 1);
+
+    std::string reply;
+    auto put = [&reply](const auto &field) { reply.append(reinterpret_cast<const char *>(&field), sizeof(field)); };
+    const uint64_t feedEpoch = feed->epoch();
+    put(feedEpoch);
+    std::vector<HashTableChange> changes;
+    // One change past max tells whether the replica is left behind
+    if (epoch == feedEpoch && feed->changesSince(from, changes, size_t{max} + 1)) {
+        const bool more = changes.size() > max;
+        if (more) changes.resize(max);
+        const uint64_t to = more ? changes.back().version : feed->version();
+        const uint8_t moreFlag = more;
+        const uint32_t count = static_cast<uint32_t>(changes.size());
+        put(to);
+        put(moreFlag);
+        put(count);
+        for (const auto &change : changes) {
+            const size_t index = change.op == LogOp::REMOVE ? capacity() : find(change.key);
+            if (index != capacity() && !isExpired(table[index])) {
+                HashTableChangeFeed::appendChange(reply, LogOp::INSERT, change.key, table[index].getValue());
+            } else {
+                HashTableChangeFeed::appendChange(reply, LogOp::REMOVE, change.key, 0);
+            }
+        }
+        return HashTableChangeFeed::writeFrame(out, ReplicationFrame::CHANGES, reply);
+    }
+
+    // Same entry layout as saveSnapshot
+    const uint64_t now = clock->nowMillis();
+    uint64_t count = 0;
+    for (const auto &bucket : table) {
+        count += bucket.isNormal() && !bucket.isExpired(now);
+    }
+    put(feed->version());
+    put(count);
+    for (const auto &bucket : table) {
+        if (bucket.isNormal() && !bucket.isExpired(now)) {
+            const uint32_t len = static_cast<uint32_t>(bucket.getKey().size());
+            const uint64_t value = bucket.getValue();
+            put(len);
+            reply.append(bucket.getKey());
+            put(value);
+        }
+    }
+    return HashTableChangeFeed::writeFrame(out, ReplicationFrame::SNAPSHOT, reply);
+}
+
+/*
+ * Commit the log group once the sync policy says it is due.  Held-back
+ * operator[] writes count towards the group.
+ */
+void HashTable::logCommitIfDue() {
+    if (log->commitDue(pendingAssign.size())) {
+        syncLog();
+    }
+}
+
+/*
+ * Idle-time commit: groups are otherwise only checked when the table is
+ * written to, so under SyncPolicy::INTERVAL the last writes before a quiet
+ * spell would stay buffered.  Call this from the owner's idle loop (as with
+ * expireTick).  Returns true if a group was committed.
+ */
+bool HashTable::logTick() {
+    if (!log || !log->commitDue(pendingAssign.size())) return false;
+    return syncLog();
+}
+
+/*
+ * Force a group commit: resolve operator[] assignments to their current
+ * values, then write and sync every buffered record.
+ */
+bool HashTable::syncLog() {
+    if (!log) return false;
+    for (const auto &key : pendingAssign) {
+        size_t index = find(key);
+        if (index != capacity() && !isExpired(table[index])) {
+            log->append(LogOp::ASSIGN, key, table[index].getValue());
+        }
+    }
+    pendingAssign.clear();
+    return log->commit();
+}
+
+// Snapshot layout: "HTSNAP01", u64 count, then count x [u32 len][key][u64 value]
+static constexpr char SNAPSHOT_MAGIC[8] = {'H', 'T', 'S', 'N', 'A', 'P', '0', '1'};
+
+static void appendBytes(std::vector<char> &out, const void *data, size_t len) {
+    const char *p = static_cast<const char *>(data);
+    out.insert(out.end(), p, p + len);
+}
+
+// fsync the directory holding path so a rename into it survives a crash
+static bool syncParentDirectory(const std::string &path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+/*
+ * Write every live NORMAL entry to path (TTLs are not saved).  The data goes to a temporary file that is
+ * synced and then renamed over path, so a crash never leaves a half snapshot.  The directory is synced
+ * after the rename, so once this returns true the snapshot is durable and the log can be truncated.
+ */
+bool HashTable::saveSnapshot(const std::string &path) const {
+    std::vector<char> out;
+    appendBytes(out, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    uint64_t now = clock->nowMillis();
+    uint64_t count = 0;
+    for (const auto &bucket : table) {
+        count += bucket.isNormal() && !bucket.isExpired(now);
+    }
+    appendBytes(out, &count, sizeof(count));
+    for (const auto &bucket : table) {
+        if (bucket.isNormal() && !bucket.isExpired(now)) {
+            uint32_t len = static_cast<uint32_t>(bucket.getKey().size());
+            uint64_t value = bucket.getValue();
+            appendBytes(out, &len, sizeof(len));
+            appendBytes(out, bucket.getKey().data(), len);
+            appendBytes(out, &value, sizeof(value));
+        }
+    }
+
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    size_t written = 0;
+    while (written < out.size()) {
+        ssize_t n = ::write(fd, out.data() + written, out.size() - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok && ::rename(tmp.c_str(), path.c_str()) == 0 && syncParentDirectory(path);
+}
+
+/*
+ * Load entries from a snapshot written by saveSnapshot on top of the current
+ * contents.  Returns false if the file is missing or malformed.  The count and
+ * key lengths are checked against the bytes left in the file before anything
+ * is allocated, so a corrupt header cannot ask for gigabytes.
+ */
+bool HashTable::loadSnapshot(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    uint64_t remaining = static_cast<uint64_t>(file.tellg());
+    file.seekg(0);
+    constexpr uint64_t ENTRY_OVERHEAD = sizeof(uint32_t) + sizeof(uint64_t);
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint64_t count = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    if (!file.read(reinterpret_cast<char *>(&count), sizeof(count))) return false;
+    remaining -= std::min<uint64_t>(remaining, sizeof(magic) + sizeof(count));
+    if (count > remaining / ENTRY_OVERHEAD) return false;
+
+    std::string key;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t len = 0;
+        uint64_t value = 0;
+        if (!file.read(reinterpret_cast<char *>(&len), sizeof(len))) return false;
+        if (remaining < ENTRY_OVERHEAD || len > remaining - ENTRY_OVERHEAD) return false;
+        remaining -= ENTRY_OVERHEAD + len;
+        key.resize(len);
+        if (!file.read(key.data(), len)) return false;
+        if (!file.read(reinterpret_cast<char *>(&value), sizeof(value))) return false;
+        findOrAdd(key) = value;
+    }
+    return true;
+}
+
+/*
+ * Commit the log, write a snapshot of the whole table, then truncate the log
+ * since the snapshot now covers every record in it.
+ */
+bool HashTable::checkpoint(const std::string &snapshotPath) {
+    if (log && !syncLog()) return false;
+    if (!saveSnapshot(snapshotPath)) return false;
+    return !log || log->truncate();
+}
+
+/*
+ * Rebuild state after a crash: load the latest snapshot (if any) and replay
+ * the log on top of it.  The attached log is detached while replaying so the
+ * replayed records are not logged a second time.  Returns records replayed.
+ */
+size_t HashTable::recover(const std::string &snapshotPath, const std::string &logPath) {
+    HashTableLog *attached = log;
+    log = nullptr;
+    loadSnapshot(snapshotPath);
+    size_t replayed = HashTableLog::replay(logPath, *this);
+    log = attached;
+    return replayed;
+}
+
     std::ostream &operator<<(std::ostream &os, const HashTable &ht) {
         for (size_t i = 0; i < ht.table.size(); ++i) {
             if (ht.table[i].isNormal()) {
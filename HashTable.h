@@ -1,45 +1,411 @@
 #ifndef PROJECT4_HASHTABLE_HASHTABLE_H
 #define PROJECT4_HASHTABLE_HASHTABLE_H
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "HashTableBatch.h"
+#include "HashTableBloomFilter.h"
 #include "HashTableBucket.h"
+#include "HashTableClock.h"
+#include "HashTableLog.h"
+#include "HashTableReplication.h"
+#include "HashTableSipHash.h"
+#include "HashTableStats.h"
+#include "HashTableTimerWheel.h"
+#include "HashTableTrace.h"
+
+// Width of the slot indices HashTable keeps per slot (the probe offsets):
+// 16, 32 or 64 bits.  A table never grows past 2^bits slots, so narrow
+// indices only suit tables known to stay small; 32 bits caps out far beyond
+// what memory allows anyway.
+#ifndef HASHTABLE_INDEX_BITS
+#define HASHTABLE_INDEX_BITS 32
+#endif
+static_assert(HASHTABLE_INDEX_BITS == 16 || HASHTABLE_INDEX_BITS == 32 || HASHTABLE_INDEX_BITS == 64,
+              "HASHTABLE_INDEX_BITS must be 16, 32 or 64");
 
 namespace std {
+ using HashTableIndex = std::conditional_t<HASHTABLE_INDEX_BITS == 16, uint16_t,
+                        std::conditional_t<HASHTABLE_INDEX_BITS == 32, uint32_t, uint64_t>>;
+
+ // What reoptimize() did to the access-weighted average probe count of a hit
+ struct HashTableLayoutReport {
+  double probesBefore = 0;
+  double probesAfter = 0;
+ };
+
+ // Heap bytes held by a HashTable, by component (HashTable::memoryUsage)
+ struct HashTableMemoryUsage {
+  size_t buckets = 0;     // the bucket array
+  size_t offsets = 0;     // probe offsets
+  size_t keys = 0;        // key storage outside the buckets (keys longer than the inline string buffer)
+  size_t filter = 0;      // Bloom filter
+  size_t timers = 0;      // TTL timer wheel
+  size_t pending = 0;     // operator[] keys waiting for the log
+  size_t batchFrames = 0; // getBatch() frames the calling thread keeps for its next batch; shared by
+                          // every table that thread batches against, so not part of total()
+  size_t resizePeak = 0;  // total while the next doubling runs, old and new bucket arrays both live
+
+  size_t total() const { return buckets + offsets + keys + filter + timers + pending; }
+ };
+
+ // What an insert does when adding its key would take the table past its memory budget
+ enum class MemoryPolicy : uint8_t {
+  FAIL,  // insert returns false, operator[] throws std::length_error
+  EVICT, // evict entries with CLOCK until the key fits
+  FILL   // keep the capacity and fill past load 0.5, up to MAX_FILL_LOAD, then fail
+ };
+
  class HashTable {
  private:
   size_t m_size = 0;
+  size_t m_tombstones = 0;
   std::vector<HashTableBucket> table;
-  std::vector<size_t> offsets;
+  std::vector<HashTableIndex> offsets;
+
+  // Every data member below is handed over in assignFrom() when a table is copied or moved
+
+  // Optional write-ahead log; keys handed out by operator[] are logged with
+  // their current value at the next commit point
+  HashTableLog* log = nullptr;
+  std::vector<std::string> pendingAssign;
+
+  // Optional operation trace for offline replay (HashTableTraceReplay)
+  HashTableTrace* trace = nullptr;
+
+  // Optional change feed for replicas (serveReplica)
+  HashTableChangeFeed* feed = nullptr;
 
-  size_t hash(const std::string& key) const;
+  // Cache mode (m_cacheMaxEntries > 0): inserts past the budget evict with
+  // CLOCK instead of resizing.  Entry bytes are key length plus the value word.
+  size_t m_cacheMaxEntries = 0;
+  size_t m_cacheMaxBytes = 0;
+  size_t m_entryBytes = 0;
+  size_t m_clockHand = 0;
+  mutable uint64_t m_cacheHits = 0;
+  mutable uint64_t m_cacheMisses = 0;
+  uint64_t m_evictions = 0;
+  uint64_t m_compactions = 0;
+
+  // Entry TTLs: deadlines live in the buckets; the wheel finds due ones for
+  // expireTick().  Lookups treat an expired entry as absent straight away.
+  const HashTableClock* clock = &HashTableClock::steady();
+  HashTableTimerWheel wheel;
+  uint64_t m_expirations = 0;
+
+  // Optional Bloom filter checked before get()/contains()/remove() probe.
+  // Sized for capacity()/2 keys; rebuilt on every rehash and once removes
+  // since the last build pass a quarter of the capacity.
+  HashTableBloomFilter filter;
+  size_t m_filterBitsPerKey = 0;
+  size_t m_filterStale = 0;
+  mutable uint64_t m_filterRejects = 0;
+  uint64_t m_filterRebuilds = 0;
+
+  // Access sampling for reoptimize(): one hit in m_accessSampleEvery (a
+  // power of two; 0 = off) bumps the bucket's saturating counter
+  size_t m_accessSampleEvery = 0;
+  mutable size_t m_accessTick = 0;
+
+  // Hash flood defence: keys start on the fast unkeyed std::hash; an insert
+  // whose probe passes many keys from its own home slot switches the table to
+  // SipHash under a fresh random key and rebuilds it
+  static constexpr size_t FLOOD_PROBES = 32;
+  HashTableSipHash sipHash;
+  bool m_keyedHash = false;
+  bool m_floodGuard = true;
+  uint64_t m_reseeds = 0;
+
+  // Optional memory budget (0 = none) on the bucket array, offsets, filter
+  // and key storage, with the peak of any rebuild checked before it starts.
+  // m_keyHeapBytes tracks key storage outside the buckets.
+  size_t m_memoryBudget = 0;
+  MemoryPolicy m_memoryPolicy = MemoryPolicy::FAIL;
+  size_t m_keyHeapBytes = 0;
+  uint64_t m_budgetRejects = 0;
+
+#ifdef HASHTABLE_STATS
+  mutable HashTableStats m_stats;
+#endif
+
+  size_t keyHash(std::string_view key) const;
+  size_t hash(std::string_view key) const;
   size_t probeIndex(size_t home, size_t attempt) const;
   void resize();
+  void rehashTo(size_t newCapacity);
+  template<typename Before>
+  void rehashInOrder(Before before);
+  void clearForRebuild(size_t newCapacity);
+  void placeRehashed(HashTableBucket&& bucket);
+  size_t probeDistance(size_t index) const;
+  static size_t advanceCursor(size_t cursor, size_t mask);
+  void noteAccess(const HashTableBucket& bucket) const {
+   if (m_accessSampleEvery > 0 && (++m_accessTick & (m_accessSampleEvery - 1)) == 0) bucket.recordAccess();
+  }
+  bool floodSuspected(size_t home, size_t probes) const;
+  void reseedHash();
+  bool insertHashed(std::string_view key, const size_t& value, size_t fullHash);
+  bool insertInternal(std::string_view key, const size_t& value);
+  bool insertInternal(std::string_view key, const size_t& value, size_t fullHash);
+  bool placeNew(std::string_view key, const size_t& value, size_t fullHash);
+  void fill(HashTableBucket& bucket, std::string_view key, const size_t& value, uint32_t tag);
+  size_t budgetedBytes() const;
+  size_t rebuildPeak(size_t newCapacity) const;
+  bool canRebuild(size_t newCapacity) const;
+  bool budgetAllows(std::string_view key) const;
+  bool makeBudgetRoom(std::string_view key);
+  bool evicts() const { return m_cacheMaxEntries > 0 || (m_memoryBudget > 0 && m_memoryPolicy == MemoryPolicy::EVICT); }
+  size_t& findOrAdd(std::string_view key);
+  void logCommitIfDue();
+  bool overBudget(size_t extraBytes) const;
+  bool makeRoom(size_t extraBytes);
+  void evictOne();
+  size_t find(std::string_view key) const;
+  size_t locate(std::string_view key, size_t fullHash) const;
+  bool isLive(size_t index, uint64_t now) const;
+  size_t dropMarked(const std::vector<uint8_t>& marked);
+  template<typename Visit>
+  static void probeLive(const HashTable& source, const HashTable& target, size_t begin, size_t end, Visit visit);
+  void compactIfSparse();
+  bool isExpired(const HashTableBucket& bucket) const;
+  void dropBucket(HashTableBucket& bucket);
+  void vacate(HashTableBucket& bucket);
+  void reclaimExpired(HashTableBucket& bucket);
+  bool filterRejects(size_t fullHash) const;
+  void filterAdd(size_t fullHash);
+  void filterRemoved();
+  void rebuildFilter();
+  template<typename Source>
+  void assignFrom(Source&& other);
+  HashTableLookupTask lookupTask(std::string_view key, std::optional<size_t>& out) const;
 
  public:
+  /*
+   * Forward iterator over NORMAL buckets yielding pair<string_view, size_t&>
+   * views, so walking the table copies no keys.  Like operator[] references,
+   * iterators are invalidated by any insert that resizes the table.  Entries
+   * already expired when begin() was called are skipped.
+   */
+  template<bool Const>
+  class BasicIterator {
+   public:
+    using bucket_pointer = std::conditional_t<Const, const HashTableBucket*, HashTableBucket*>;
+    using value_type = std::pair<std::string_view, std::conditional_t<Const, const size_t&, size_t&>>;
+    using reference = value_type;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+
+    struct pointer {
+      value_type item;
+      const value_type* operator->() const { return &item; }
+    };
+
+    BasicIterator() = default;
+    BasicIterator(bucket_pointer pos, bucket_pointer last, uint64_t now = 0) : pos(pos), last(last), now(now) {
+      skipEmpty();
+    }
+
+    operator BasicIterator<true>() const requires (!Const) { return {pos, last, now}; }
+
+    reference operator*() const { return {pos->getKey(), pos->getValueRef()}; }
+    pointer operator->() const { return {**this}; }
+
+    BasicIterator& operator++() {
+      ++pos;
+      skipEmpty();
+      return *this;
+    }
+
+    BasicIterator operator++(int) {
+      BasicIterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const BasicIterator& other) const { return pos == other.pos; }
+
+   private:
+    bucket_pointer pos = nullptr;
+    bucket_pointer last = nullptr;
+    uint64_t now = 0;
+
+    void skipEmpty() {
+      while (pos != last && (!pos->isNormal() || pos->isExpired(now))) ++pos;
+    }
+  };
+
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  static constexpr size_t MAX_BATCH_GROUP = 64;
+  // Largest capacity whose offsets fit a HashTableIndex (2^63 for 64 bits)
+  static constexpr size_t MAX_CAPACITY = size_t{1} << (HASHTABLE_INDEX_BITS == 64 ? 63 : HASHTABLE_INDEX_BITS);
+  // Highest load MemoryPolicy::FILL lets a table reach when it cannot afford to grow
+  static constexpr double MAX_FILL_LOAD = 0.875;
+
   HashTable(size_t initCapacity = 8);
+  ~HashTable();
+  // A log, trace or feed belongs to one table: a copy starts with none
+  // attached, and a move takes them along
+  HashTable(const HashTable &other);
+  HashTable &operator=(const HashTable &) = delete;
+  HashTable(HashTable &&other) noexcept;
+  HashTable &operator=(HashTable &&other) noexcept;
+
+  static std::vector<HashTableIndex> generateOffsets(size_t cap);
+
+  bool insert(std::string_view key, const size_t& value);
+  bool insert(std::string_view key, const size_t& value, std::chrono::milliseconds ttl);
+  bool remove(std::string_view key);
+  bool contains(std::string_view key) const;
+  optional<size_t> get(std::string_view key) const;
+  size_t getBatch(std::span<const std::string_view> keys, std::span<std::optional<size_t>> out,
+                  size_t groupSize = 16) const;
+  size_t& operator[](std::string_view key);
 
-  static std::vector<::size_t> generateOffsets(size_t cap);
+  void reserve(size_t count, size_t keyCapacity = 0);
 
-  bool insert(const std::string& key, const size_t& value);
-  bool remove(const std::string& key);
-  bool contains(const std::string& key) const;
-  optional<size_t> get(const std::string& key) const;
-  size_t& operator[](const std::string& key);
+  size_t mergeFrom(const HashTable& other);
+  size_t intersectWith(const HashTable& other);
+  size_t subtract(const HashTable& other);
+  template<typename Predicate>
+  size_t eraseIf(Predicate&& pred);
 
   vector<std::string> keys() const;
+
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+  template<typename Visitor>
+  size_t scan(size_t cursor, size_t maxBuckets, Visitor&& visit) const;
   double alpha() const;
   size_t capacity() const;
 
   size_t size() const;
+  size_t tombstones() const;
+
+  HashTableStats stats() const;
+  void resetStats();
 
   void rehashBackwards();
 
+  void setAccessSampling(size_t oneIn = 1);
+  double weightedProbeLength() const;
+  HashTableLayoutReport reoptimize();
+  size_t reoptimize(size_t cursor, size_t maxHomes);
+
+  void setFloodProtection(bool on);
+  bool keyedHash() const;
+  void useKeyedHash();
+  uint64_t hashEpoch() const;
+
+  void setCacheBudget(size_t maxEntries, size_t maxBytes = 0);
+  bool isCache() const;
+
+  void setBloomFilter(size_t bitsPerKey = 10);
+  bool hasBloomFilter() const;
+
+  HashTableMemoryUsage memoryUsage() const;
+  void setMemoryBudget(size_t maxBytes, MemoryPolicy policy = MemoryPolicy::FAIL);
+  size_t memoryBudget() const;
+
+  bool expire(std::string_view key, std::chrono::milliseconds ttl);
+  optional<std::chrono::milliseconds> ttl(std::string_view key) const;
+  size_t expireTick(size_t maxWork = 32);
+  void setClock(const HashTableClock* source);
+
   void debugDumpToJSON();
 
+  void attachLog(HashTableLog* wal);
+  bool syncLog();
+  bool logTick();
+  bool saveSnapshot(const std::string& path) const;
+  bool loadSnapshot(const std::string& path);
+  bool checkpoint(const std::string& snapshotPath);
+  size_t recover(const std::string& snapshotPath, const std::string& logPath);
+
+  void attachTrace(HashTableTrace* recorder);
+
+  void attachFeed(HashTableChangeFeed* changes);
+  bool serveReplica(int in, int out);
+
   friend std::ostream& operator<<(std::ostream& os, const HashTable& ht);
  };
 
+ /*
+  * Redis SCAN-style bounded walk.  Pass 0 to start; each call visits the keys
+  * of at most maxBuckets home slots, calling visit(key, value), and returns
+  * the cursor to resume from (0 once the scan is complete).
+  * A home slot's keys all sit on its probe sequence before the first ESS
+  * bucket, so they are found by walking that sequence and keeping the keys
+  * that hash there.  Capacities are powers of two and home = hash & mask, so
+  * the cursor advances in reversed-bit order like Redis dictScan: every key
+  * present for the whole scan is visited at least once even if the table
+  * resizes between calls (a key may be visited more than once).  Expired
+  * entries are not visited.  A reseed (a detected flood, or useKeyedHash)
+  * moves every key to a new home, so that guarantee only holds while
+  * hashEpoch() stays the same; a caller that sees it change restarts at 0.
+  */
+ /*
+  * Remove every live entry for which pred(key, value) returns true, in one
+  * pass over the buckets with no hashing or probing, and return how many
+  * went.  Removes are logged like remove().  pred runs on the calling
+  * thread only, so it may keep state.  A table left with more than a
+  * quarter of its buckets as tombstones is compacted in place.
+  */
+ template<typename Predicate>
+ size_t HashTable::eraseIf(Predicate&& pred) {
+  const uint64_t now = clock->nowMillis();
+  size_t erased = 0;
+  for (auto& bucket : table) {
+   if (bucket.isNormal() && !bucket.isExpired(now) && pred(std::string_view(bucket.getKey()), bucket.getValue())) {
+    dropBucket(bucket);
+    ++erased;
+   }
+  }
+  if (erased > 0) {
+   HASHTABLE_STAT(m_stats.removes += erased);
+   if (log) logCommitIfDue();
+   compactIfSparse();
+  }
+  return erased;
+ }
+
+ template<typename Visitor>
+ size_t HashTable::scan(size_t cursor, size_t maxBuckets, Visitor&& visit) const {
+  if (table.empty()) return 0;
+  const size_t mask = capacity() - 1;
+  const uint64_t now = clock->nowMillis();
+
+  for (size_t n = 0; n < maxBuckets; ++n) {
+   size_t home = cursor & mask;
+   for (size_t i = 0; i < capacity(); ++i) {
+    const HashTableBucket& bucket = table[probeIndex(home, i)];
+    if (bucket.isEmptySinceStart()) break;
+    if (bucket.isNormal() && !bucket.isExpired(now) && hash(bucket.getKey()) == home) {
+     visit(std::string_view(bucket.getKey()), bucket.getValue());
+    }
+   }
+
+   cursor = advanceCursor(cursor, mask);
+   if (cursor == 0) return 0;
+  }
+  return cursor;
+ }
 
 }
 #endif //PROJECT4_HASHTABLE_HASHTABLE_H
\ No newline at end of file
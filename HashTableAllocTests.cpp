@@ -0,0 +1,213 @@
+/**
+ * HashTableAllocTests.cpp
+ *
+ * Allocation-counting harness for the HashTable hot paths.
+ * - Replaces global operator new so every heap allocation is counted while armed
+ * - Lookups (get / contains / operator[] on existing keys / remove) must never allocate
+ * - Inserts into a table presized with reserve(count, keyCapacity) must never allocate
+ * - memoryUsage() must match the bytes the table holds, and its predicted resize
+ *   peak the bytes live at once; a memory budget must hold for the whole run
+ * - Narrated like HashTableTests; exits non-zero if any armed section allocated
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "HashTable.h"
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Counting allocator
+// -----------------------------------------------------------------------------
+static bool g_armed = false;
+static size_t g_allocations = 0;
+
+// Each block carries its size in a header, so bytes live and their peak are known
+static constexpr size_t HEADER = 16;
+static size_t g_liveBytes = 0;
+static size_t g_peakBytes = 0;
+
+[[gnu::noinline]] void* operator new(size_t n) {
+    if (g_armed) ++g_allocations;
+    void* p = std::malloc(HEADER + n);
+    if (!p) throw std::bad_alloc();
+    *static_cast<size_t*>(p) = n;
+    g_liveBytes += n;
+    if (g_liveBytes > g_peakBytes) g_peakBytes = g_liveBytes;
+    return static_cast<char*>(p) + HEADER;
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    if (!p) return;
+    char* block = static_cast<char*>(p) - HEADER;
+    g_liveBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// Run body with the counter armed and report how many allocations it made
+template<typename Body>
+static size_t countAllocations(Body body) {
+    g_allocations = 0;
+    g_armed = true;
+    body();
+    g_armed = false;
+    return g_allocations;
+}
+
+static bool report(const string& what, size_t allocations) {
+    bool ok = allocations == 0;
+    cout << (ok ? "SUCCESS: " : "FAILURE: ") << what << " made " << allocations << " heap allocation(s)."
+         << endl << endl;
+    return ok;
+}
+
+int main() {
+    constexpr size_t COUNT = 4096;
+    constexpr size_t LONG_KEY = 48; // well past the small-string buffer
+    bool ok = true;
+
+    cout << "+==================================+" << endl;
+    cout << "| HASH TABLE ALLOCATION-FREE TESTS |" << endl;
+    cout << "+==================================+" << endl << endl;
+
+    // Keys are built up front so only the table's own allocations are counted
+    vector<string> shortKeys, longKeys, missing;
+    for (size_t i = 0; i < COUNT; i++) {
+        shortKeys.push_back("k" + to_string(i));
+        longKeys.push_back(string(LONG_KEY - 8, 'x') + to_string(10000000 + i));
+        missing.push_back("missing-" + to_string(i) + string(LONG_KEY, 'y'));
+    }
+
+    HashTable ht;
+    cout << "Presizing with reserve(" << 2 * COUNT << ", " << LONG_KEY << ")..." << endl << endl;
+    ht.reserve(2 * COUNT, LONG_KEY);
+    size_t capacityBefore = ht.capacity();
+
+    cout << "Testing insert() into a presized table" << endl;
+    cout << "--------------------------------------" << endl;
+    ok &= report("insert() of " + to_string(2 * COUNT) + " short and long keys", countAllocations([&] {
+        for (size_t i = 0; i < COUNT; i++) {
+            ht.insert(shortKeys[i], i);
+            ht.insert(longKeys[i], i);
+        }
+    }));
+    ok &= ht.size() == 2 * COUNT && ht.capacity() == capacityBefore;
+
+    cout << "Testing get() / contains() hits and misses" << endl;
+    cout << "------------------------------------------" << endl;
+    size_t found = 0;
+    ok &= report("get()/contains() on " + to_string(4 * COUNT) + " keys", countAllocations([&] {
+        for (size_t i = 0; i < COUNT; i++) {
+            found += ht.get(shortKeys[i]).has_value();
+            found += ht.contains(longKeys[i]);
+            found += ht.contains(missing[i]);
+            found += ht.get(string_view(missing[i]).substr(0, 12)).has_value();
+        }
+    }));
+    ok &= found == 2 * COUNT;
+
+    cout << "Testing get() with string literals" << endl;
+    cout << "----------------------------------" << endl;
+    ok &= report("get(\"k1\") / contains(literal)", countAllocations([&] {
+        found += ht.get("k1").has_value();
+        found += ht.contains("a literal key that is far too long for SSO");
+    }));
+
+    cout << "Testing operator[] on existing keys" << endl;
+    cout << "-----------------------------------" << endl;
+    ok &= report("operator[] read/modify of existing keys", countAllocations([&] {
+        for (size_t i = 0; i < COUNT; i++) {
+            ht[longKeys[i]] += 1;
+        }
+    }));
+
+    cout << "Testing remove() and reinsert into freed buckets" << endl;
+    cout << "------------------------------------------------" << endl;
+    ok &= report("remove() + insert() churn", countAllocations([&] {
+        for (size_t i = 0; i < COUNT; i++) {
+            ht.remove(longKeys[i]);
+        }
+        for (size_t i = 0; i < COUNT; i++) {
+            ht.insert(longKeys[i], i);
+        }
+    }));
+    ok &= ht.size() == 2 * COUNT;
+
+    cout << "Testing getBatch() once its frame pool is warm" << endl;
+    cout << "----------------------------------------------" << endl;
+    vector<string_view> batchKeys;
+    for (size_t i = 0; i < COUNT; i++) {
+        batchKeys.push_back(longKeys[i]);
+        batchKeys.push_back(missing[i]);
+    }
+    vector<optional<size_t>> batchOut(batchKeys.size());
+    ht.getBatch(batchKeys, batchOut, HashTable::MAX_BATCH_GROUP);
+    ok &= report("getBatch() of " + to_string(batchKeys.size()) + " keys", countAllocations([&] {
+        found = ht.getBatch(batchKeys, batchOut, HashTable::MAX_BATCH_GROUP);
+    }));
+    ok &= found == COUNT;
+
+    cout << "Testing memoryUsage() against the allocator" << endl;
+    cout << "-------------------------------------------" << endl;
+    {
+        // Bytes measured from before the table exists, so they are all its own
+        const size_t base = g_liveBytes;
+        bool exact = true;
+        size_t resizes = 0;
+        {
+            HashTable grown;
+            for (size_t i = 0; i < COUNT; i++) {
+                HashTableMemoryUsage usage = grown.memoryUsage();
+                exact &= usage.total() == g_liveBytes - base;
+                const size_t capacity = grown.capacity();
+                g_peakBytes = g_liveBytes;
+                grown.insert(shortKeys[i], i);
+                grown.insert(longKeys[i], i);
+                if (grown.capacity() != capacity) {
+                    exact &= usage.resizePeak == g_peakBytes - base;
+                    ++resizes;
+                }
+            }
+            exact &= grown.memoryUsage().total() == g_liveBytes - base;
+        }
+        ok &= exact && resizes > 0;
+        cout << (exact ? "SUCCESS: " : "FAILURE: ") << "total() and resizePeak matched the allocator across "
+             << resizes << " resizes." << endl << endl;
+
+        const pair<MemoryPolicy, const char*> policies[] = {
+            {MemoryPolicy::FAIL, "FAIL"}, {MemoryPolicy::EVICT, "EVICT"}, {MemoryPolicy::FILL, "FILL"}};
+        for (auto [policy, name] : policies) {
+            constexpr size_t BUDGET = 256 * 1024;
+            g_peakBytes = g_liveBytes;
+            const size_t before = g_liveBytes;
+            size_t inserted = 0;
+            {
+                HashTable bounded(1);
+                bounded.setMemoryBudget(BUDGET, policy);
+                for (size_t i = 0; i < COUNT; i++) {
+                    inserted += bounded.insert(longKeys[i], i);
+                    inserted += bounded.insert(shortKeys[i], i);
+                    bounded.remove(shortKeys[i / 2]);
+                }
+            }
+            const size_t peak = g_peakBytes - before;
+            bool within = peak <= BUDGET && inserted > 0;
+            ok &= within;
+            cout << (within ? "SUCCESS: " : "FAILURE: ") << name << " budget peaked at "
+                 << peak << " of " << BUDGET << " budgeted bytes (" << inserted << " inserts landed)." << endl
+                 << endl;
+        }
+    }
+
+    cout << (ok ? "All allocation checks passed." : "Allocation checks FAILED.") << endl;
+    return ok ? 0 : 1;
+}
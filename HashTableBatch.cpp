@@ -0,0 +1,67 @@
+/*
+// HashTableBatch.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Frame pool for batched lookup coroutines.
+*/
+
+#include "HashTableBatch.h"
+#include <new>
+
+namespace std {
+
+   HashTableFramePool::~HashTableFramePool() {
+      for (void* block : freeBlocks) ::operator delete(block);
+   }
+
+   // Freed with its thread; frames never outlive the getBatch call that made them
+   HashTableFramePool& HashTableFramePool::local() {
+      thread_local HashTableFramePool pool;
+      return pool;
+   }
+
+   /*
+    * The first frame fixes the block size.  Larger frames (none in practice)
+    * go straight to the heap and are marked so release() frees them there.
+    */
+   void* HashTableFramePool::allocate(size_t bytes) {
+      if (blockSize == 0) blockSize = bytes;
+      void* block;
+      HashTableFramePool* owner = this;
+      if (bytes > blockSize) {
+         block = ::operator new(HEADER + bytes);
+         owner = nullptr;
+      } else if (!freeBlocks.empty()) {
+         block = freeBlocks.back();
+         freeBlocks.pop_back();
+      } else {
+         block = ::operator new(HEADER + blockSize);
+      }
+      *static_cast<HashTableFramePool**>(block) = owner;
+      return static_cast<char*>(block) + HEADER;
+   }
+
+   // Frames are destroyed before getBatch returns, so the owner is still alive
+   void HashTableFramePool::release(void* frame) noexcept {
+      void* block = static_cast<char*>(frame) - HEADER;
+      HashTableFramePool* owner = *static_cast<HashTableFramePool**>(block);
+      if (owner == nullptr) {
+         ::operator delete(block);
+         return;
+      }
+      try {
+         owner->freeBlocks.push_back(block);
+      } catch (...) {
+         ::operator delete(block);
+      }
+   }
+
+   size_t HashTableFramePool::bytes() const {
+      return freeBlocks.size() * (HEADER + blockSize) + freeBlocks.capacity() * sizeof(void*);
+   }
+
+}
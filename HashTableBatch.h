@@ -0,0 +1,97 @@
+/*
+// HashTableBatch.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Coroutine plumbing for HashTable::getBatch.  Each lookup in a batch is a
+// HashTableLookupTask: a coroutine that prefetches the bucket it is about to
+// read and suspends, so the batch can start other lookups while the line
+// arrives from memory (asynchronous memory access chaining).  The tasks are
+// resumed round-robin by getBatch itself.
+// Coroutine frames come from a HashTableFramePool instead of the heap.  Every
+// lookup frame has the same size, so the pool keeps a free list of blocks of
+// that size and a warmed-up batch allocates nothing.  Each thread has its own
+// pool, so readers on different threads can batch against one table without
+// sharing frame storage; a task must be destroyed on the thread that made it.
+// Actionable members include:
+// - HashTableFramePool::local - the calling thread's pool
+// - HashTableFramePool::allocate / release - frame storage for lookup tasks
+// - HashTableFramePool::bytes - memory held in free blocks between batches
+// - HashTableLookupTask::resume / done - step a lookup to its next suspension
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLEBATCH_H
+#define PROJECT4_HASHTABLE_HASHTABLEBATCH_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace std {
+
+    class HashTableFramePool {
+    private:
+        // Each block starts with the owning pool (null for oversized frames)
+        static constexpr size_t HEADER = 16;
+
+        size_t blockSize = 0;
+        std::vector<void*> freeBlocks;
+
+    public:
+        HashTableFramePool() = default;
+        HashTableFramePool(const HashTableFramePool&) = delete;
+        HashTableFramePool& operator=(const HashTableFramePool&) = delete;
+        ~HashTableFramePool();
+
+        static HashTableFramePool& local();
+
+        void* allocate(size_t bytes);
+        static void release(void* frame) noexcept;
+        size_t bytes() const;
+    };
+
+    class HashTableLookupTask {
+    public:
+        struct promise_type {
+            HashTableLookupTask get_return_object() {
+                return HashTableLookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+
+            static void* operator new(size_t bytes) { return HashTableFramePool::local().allocate(bytes); }
+            static void operator delete(void* frame) noexcept { HashTableFramePool::release(frame); }
+        };
+
+        HashTableLookupTask() = default;
+        HashTableLookupTask(HashTableLookupTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        HashTableLookupTask& operator=(HashTableLookupTask&& other) noexcept {
+            if (this != &other) {
+                if (handle) handle.destroy();
+                handle = std::exchange(other.handle, {});
+            }
+            return *this;
+        }
+        ~HashTableLookupTask() {
+            if (handle) handle.destroy();
+        }
+
+        explicit operator bool() const { return static_cast<bool>(handle); }
+        void resume() const { handle.resume(); }
+        bool done() const { return handle.done(); }
+
+    private:
+        explicit HashTableLookupTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+        std::coroutine_handle<promise_type> handle;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLEBATCH_H
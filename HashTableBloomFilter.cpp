@@ -0,0 +1,40 @@
+/*
+// HashTableBloomFilter.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Sizing for the blocked Bloom filter; add/mayContain are inline in the header.
+*/
+
+#include "HashTableBloomFilter.h"
+
+namespace std {
+
+   // Round up to whole 512-bit blocks, at least one
+   void HashTableBloomFilter::reset(size_t expectedKeys, size_t bitsPerKey) {
+      blocks.assign(bytesFor(expectedKeys, bitsPerKey) / sizeof(Block), Block{});
+   }
+
+   size_t HashTableBloomFilter::bytesFor(size_t expectedKeys, size_t bitsPerKey) {
+      size_t bits = expectedKeys * bitsPerKey;
+      size_t count = (bits + 511) / 512;
+      return (count > 0 ? count : 1) * sizeof(Block);
+   }
+
+   void HashTableBloomFilter::clear() {
+      blocks.clear();
+      blocks.shrink_to_fit();
+   }
+
+   bool HashTableBloomFilter::empty() const {
+      return blocks.empty();
+   }
+
+   size_t HashTableBloomFilter::bytes() const {
+      return blocks.size() * sizeof(Block);
+   }
+
+}
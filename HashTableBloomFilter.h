@@ -0,0 +1,86 @@
+/*
+// HashTableBloomFilter.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Cache-line blocked Bloom filter that lets HashTable turn away most misses
+// without probing.  The filter is an array of 64-byte blocks of eight 64-bit
+// words.  A key's hash picks one block with its high 32 bits, then sets one
+// bit in each of the block's eight words using its low 32 bits times a
+// per-word odd constant.  A query therefore touches a single cache line,
+// and with 10 bits per key about 1% of absent keys get through.
+// Bits can't be cleared, so removed keys keep their bits until the owner
+// rebuilds the filter (HashTable does this on every rehash, and after enough
+// removes).
+// Actionable members include:
+// - reset - drop all keys and size for expectedKeys at bitsPerKey
+// - add - record a key's 64-bit hash
+// - mayContain - false means the key was definitely never added
+// - prefetch - start loading a key's block ahead of mayContain
+// - bytes / empty - memory used, and whether the filter has any blocks
+// - bytesFor - memory reset() would use, without resetting
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLEBLOOMFILTER_H
+#define PROJECT4_HASHTABLE_HASHTABLEBLOOMFILTER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace std {
+
+    class HashTableBloomFilter {
+    public:
+        static constexpr size_t WORDS = 8;
+
+    private:
+        struct alignas(64) Block {
+            uint64_t words[WORDS] = {};
+        };
+
+        std::vector<Block> blocks;
+
+        size_t blockOf(uint64_t hash) const {
+            return static_cast<size_t>(((hash >> 32) * blocks.size()) >> 32);
+        }
+
+        // Bit in word w: top 6 bits of the low hash half times an odd salt
+        static uint64_t bitFor(uint32_t low, size_t w) {
+            static constexpr uint32_t SALTS[WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+            return uint64_t{1} << ((low * SALTS[w]) >> 26);
+        }
+
+    public:
+        void reset(size_t expectedKeys, size_t bitsPerKey);
+        static size_t bytesFor(size_t expectedKeys, size_t bitsPerKey);
+        void clear();
+
+        void add(uint64_t hash) {
+            Block& block = blocks[blockOf(hash)];
+            const uint32_t low = static_cast<uint32_t>(hash);
+            for (size_t w = 0; w < WORDS; ++w) block.words[w] |= bitFor(low, w);
+        }
+
+        bool mayContain(uint64_t hash) const {
+            const Block& block = blocks[blockOf(hash)];
+            const uint32_t low = static_cast<uint32_t>(hash);
+            uint64_t missing = 0;
+            for (size_t w = 0; w < WORDS; ++w) missing |= bitFor(low, w) & ~block.words[w];
+            return missing == 0;
+        }
+
+        // Start loading the block mayContain(hash) will read
+        void prefetch(uint64_t hash) const {
+            __builtin_prefetch(&blocks[blockOf(hash)]);
+        }
+
+        bool empty() const;
+        size_t bytes() const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLEBLOOMFILTER_H
@@ -15,11 +15,15 @@
 // 'SENTINEL_KEY_42' and a data value of 0 - as suggested boy the project pdf and sets the
 // initial state to ESS - empty since start.
 // Actionable members include:
-// - load - to load new key and value
+// - load - to load new key and value, with the key's hash tag
+// - holds / mayHold - key comparison that rejects on hash tag and length first
 // - getKey - returns the key
 // - getValue - returns the value
 // - getValueRef - returns a std::string& value
 // - markRemoved - for node cleaning
+// - reserveKey - preallocate key storage so a later load() does not allocate
+// - touch / isReferenced / clearReferenced - CLOCK reference bit for cache mode
+// - getExpiry / setExpiry / isExpired - TTL deadline in clock milliseconds (0 = none)
 */
 
 #include "HashTableBucket.h"
@@ -36,10 +40,21 @@ namespace std {
        : state(BucketType::NORMAL), key(key), value(value) {}
 
    // Load a key-value pair into the bucket and mark as NORMAL
-   void HashTableBucket::load(const std::string& key, const size_t& value) {
-      this->key = key;
+   // assign() reuses the key's existing capacity, so no allocation when it fits.
+   // A key that does not fit gets storage of exactly its length (heapBytesFor),
+   // where assign() would grow to at least twice the old capacity.
+   void HashTableBucket::load(std::string_view key, const size_t& value, uint32_t tag) {
+      if (key.size() > this->key.capacity()) {
+         this->key = std::string(key);
+      } else {
+         this->key.assign(key.data(), key.size());
+      }
       this->value = value;
+      this->tag = tag;
       this->state = BucketType::NORMAL;
+      this->referenced = false;
+      this->accessCount = 0;
+      this->expiresAt = 0;
    }
 
    // returns true if Bucket is not NORMAL (empty in any sense of the word)
@@ -74,11 +89,87 @@ namespace std {
       return value;
    }
 
+   const size_t& HashTableBucket::getValueRef() const {
+      return value;
+   }
+
    // Mark bucket as EAR (Empty After Removal) and reset contents
+   // The sentinel is assigned in place, so the key keeps its capacity for reuse
    void HashTableBucket::markRemoved() {
       state = BucketType::EAR;
       key = "SENTINEL_KEY_42";
       value = 0;
+      tag = 0;
+      referenced = false;
+      accessCount = 0;
+      expiresAt = 0;
+   }
+
+   // Re-tag after the owning table changes hash function
+   void HashTableBucket::setTag(uint32_t tag) {
+      this->tag = tag;
+   }
+
+   // Grow the key's storage ahead of time; the sentinel contents are kept
+   void HashTableBucket::reserveKey(size_t capacity) {
+      key.reserve(capacity);
+   }
+
+   // Bytes the key has on the heap (its terminator included); 0 while it fits
+   // in the string's own inline buffer
+   size_t HashTableBucket::keyHeapBytes() const {
+      return heapBytesFor(key.capacity());
+   }
+
+   // Heap bytes of a key with this much capacity, as load() allocates it
+   size_t HashTableBucket::heapBytesFor(size_t length) {
+      static const size_t inlineCapacity = std::string().capacity();
+      return length > inlineCapacity ? length + 1 : 0;
+   }
+
+   // Give a removed key's heap storage back; the sentinel fits inline
+   void HashTableBucket::releaseKey() {
+      key.shrink_to_fit();
+   }
+
+   // Record a lookup hit; const because lookups are, the bit is mutable
+   void HashTableBucket::touch() const {
+      referenced = true;
+   }
+
+   bool HashTableBucket::isReferenced() const {
+      return referenced;
+   }
+
+   void HashTableBucket::clearReferenced() {
+      referenced = false;
+   }
+
+   // Count a sampled hit, sticking at 255
+   void HashTableBucket::recordAccess() const {
+      if (accessCount != UINT8_MAX) ++accessCount;
+   }
+
+   uint8_t HashTableBucket::getAccessCount() const {
+      return accessCount;
+   }
+
+   // Halve the count so keys that have cooled off lose their rank
+   void HashTableBucket::ageAccessCount() {
+      accessCount >>= 1;
+   }
+
+   uint64_t HashTableBucket::getExpiry() const {
+      return expiresAt;
+   }
+
+   void HashTableBucket::setExpiry(uint64_t expiresAt) {
+      this->expiresAt = expiresAt;
+   }
+
+   // True if the entry has a deadline and now has reached it
+   bool HashTableBucket::isExpired(uint64_t now) const {
+      return expiresAt != 0 && expiresAt <= now;
    }
 
    // Overloaded stream operator for HashTableBucket
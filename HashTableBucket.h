@@ -15,21 +15,33 @@
 // 'SENTINEL_KEY_42' and a data value of 0 - as suggested boy the project pdf and sets the
 // initial state to ESS - empty since start.
 // Actionable members include:
-// - load - to load new key and value
+// - load - to load new key and value, with the key's hash tag
+// - holds / mayHold - key comparison that rejects on hash tag and length first
 // - getKey - returns the key
 // - getValue - returns the value
 // - getValueRef - returns a std::string& value
 // - markRemoved - for node cleaning
+// - reserveKey - preallocate key storage so a later load() does not allocate
+// - keyHeapBytes / heapBytesFor / releaseKey - key storage held outside the bucket, and freeing it
+// - touch / isReferenced / clearReferenced - CLOCK reference bit for cache mode
+// - recordAccess / getAccessCount / ageAccessCount - saturating sampled-hit counter
+// - getExpiry / setExpiry / isExpired - TTL deadline in clock milliseconds (0 = none)
 */
 #ifndef PROJECT4_HASHTABLE_HASHTABLEBUCKET_H
 #define PROJECT4_HASHTABLE_HASHTABLEBUCKET_H
 
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <iostream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace std {
 
-    enum class BucketType {
+    enum class BucketType : uint8_t {
         ESS,    // Empty Since Start
         NORMAL, // Occupied
         EAR     // Empty After Removal
@@ -38,28 +50,112 @@ namespace std {
     class HashTableBucket {
     private:
         BucketType state;
+        mutable bool referenced = false; // set by lookups in cache mode; fits beside state
+        mutable uint8_t accessCount = 0; // sampled hits, saturating; also in the padding
+        uint32_t tag = 0;                // high half of the key's hash; the rest of the padding
         std::string key;
         size_t value;
+        uint64_t expiresAt = 0;
 
     public:
         HashTableBucket();
         HashTableBucket(const std::string& key, const size_t& value);
 
-        void load(const std::string& key, const size_t& value);
+        static uint32_t tagOf(uint64_t hash) { return static_cast<uint32_t>(hash >> 32); }
+
+        void load(std::string_view key, const size_t& value, uint32_t tag);
+        void setTag(uint32_t tag);
         void markRemoved();
+        void reserveKey(size_t capacity);
+        size_t keyHeapBytes() const;
+        static size_t heapBytesFor(size_t length);
+        void releaseKey();
+
+        void touch() const;
+        bool isReferenced() const;
+        void clearReferenced();
+
+        void recordAccess() const;
+        uint8_t getAccessCount() const;
+        void ageAccessCount();
+
+        uint64_t getExpiry() const;
+        void setExpiry(uint64_t expiresAt);
+        bool isExpired(uint64_t now) const;
 
         bool isEmpty() const;
         bool isEmptySinceStart() const;
         bool isEmptyAfterRemoval() const;
         bool isNormal() const;
 
+        bool mayHold(std::string_view probe, uint32_t probeTag) const;
+        bool holds(std::string_view probe, uint32_t probeTag) const;
+        static bool equalBytes(const char* a, const char* b, size_t n);
+
         const std::string& getKey() const;
         size_t getValue() const;
         size_t& getValueRef();
+        const size_t& getValueRef() const;
 
         friend std::ostream& operator<<(std::ostream& os, const HashTableBucket& bucket);
     };
 
+    /*
+     * Probe-loop key comparison, inline because every probe runs it.  The
+     * tag (32 hash bits the home slot didn't use) and the length sit in the
+     * bucket itself, so a different key is almost always turned away
+     * without reading its bytes, which for keys past 15 bytes live on the
+     * heap.  Keys with a long common prefix, such as URLs, would otherwise
+     * be read up to the first differing byte.
+     */
+    inline bool HashTableBucket::mayHold(std::string_view probe, uint32_t probeTag) const {
+        return state == BucketType::NORMAL && tag == probeTag && key.size() == probe.size();
+    }
+
+    inline bool HashTableBucket::holds(std::string_view probe, uint32_t probeTag) const {
+        return mayHold(probe, probeTag) && equalBytes(key.data(), probe.data(), probe.size());
+    }
+
+    /*
+     * Equality of n bytes.  Up to 16 bytes: two overlapping loads of 4 or 8
+     * bytes, no loop.  Longer: 16 bytes per SSE2 compare, the last block
+     * overlapping the one before.  memcmp would also find the order, which
+     * a hash table never needs.
+     */
+    inline bool HashTableBucket::equalBytes(const char* a, const char* b, size_t n) {
+        auto word = [](const char* p) {
+            uint64_t w;
+            std::memcpy(&w, p, sizeof(w));
+            return w;
+        };
+        auto half = [](const char* p) {
+            uint32_t w;
+            std::memcpy(&w, p, sizeof(w));
+            return w;
+        };
+        if (n < 4) {
+            for (size_t i = 0; i < n; ++i) {
+                if (a[i] != b[i]) return false;
+            }
+            return true;
+        }
+        if (n <= 8) return ((half(a) ^ half(b)) | (half(a + n - 4) ^ half(b + n - 4))) == 0;
+        if (n <= 16) return ((word(a) ^ word(b)) | (word(a + n - 8) ^ word(b + n - 8))) == 0;
+#ifdef __SSE2__
+        auto same16 = [](const char* x, const char* y) {
+            __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+            __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(vx, vy)) == 0xFFFF;
+        };
+        for (size_t i = 0; i + 16 < n; i += 16) {
+            if (!same16(a + i, b + i)) return false;
+        }
+        return same16(a + n - 16, b + n - 16);
+#else
+        return std::memcmp(a, b, n) == 0;
+#endif
+    }
+
 }
 
 #endif // PROJECT4_HASHTABLE_HASHTABLEBUCKET_H
\ No newline at end of file
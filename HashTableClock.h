@@ -0,0 +1,70 @@
+/*
+// HashTableClock.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Millisecond time source for entry TTLs.  HashTable reads the time through
+// this interface only, so tests can swap in a ManualClock and move time by
+// hand instead of sleeping.  Times are milliseconds on the clock's own scale
+// (steady_clock by default), so they only mean something within one process.
+// Actionable members include:
+// - nowMillis - current time in milliseconds
+// - steady - shared std::chrono::steady_clock backed instance (the default)
+// - ManualClock::advance / set - move a test clock forward or to a given time
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLECLOCK_H
+#define PROJECT4_HASHTABLE_HASHTABLECLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace std {
+
+    class HashTableClock {
+    public:
+        virtual ~HashTableClock() = default;
+        virtual uint64_t nowMillis() const = 0;
+
+        static const HashTableClock& steady();
+    };
+
+    class SteadyHashTableClock : public HashTableClock {
+    public:
+        uint64_t nowMillis() const override {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    };
+
+    inline const HashTableClock& HashTableClock::steady() {
+        static const SteadyHashTableClock instance;
+        return instance;
+    }
+
+    // Clock that only moves when told to; starts at 1 so no time reads as "unset"
+    class ManualClock : public HashTableClock {
+    private:
+        uint64_t now;
+
+    public:
+        explicit ManualClock(uint64_t start = 1) : now(start) {}
+
+        uint64_t nowMillis() const override {
+            return now;
+        }
+
+        void advance(std::chrono::milliseconds by) {
+            now += static_cast<uint64_t>(by.count());
+        }
+
+        void set(uint64_t millis) {
+            now = millis;
+        }
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLECLOCK_H
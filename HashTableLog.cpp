@@ -0,0 +1,234 @@
+/*
+// HashTableLog.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Append-only mutation log with group commit.  Each record is laid out as
+//   [u32 checksum][u8 op][u32 key length][u64 value][key bytes]
+// in host byte order.  The checksum covers everything after it, so a record
+// torn by a crash in the middle of a write is detected and replay stops there,
+// cutting the torn tail off the file.
+*/
+
+#include "HashTableLog.h"
+#include "HashTable.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace std {
+
+   static constexpr size_t RECORD_HEADER = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+   // FNV-1a over the record body, used to detect torn or corrupt tail records
+   static uint32_t recordChecksum(const char* data, size_t len) {
+      uint32_t h = 2166136261u;
+      for (size_t i = 0; i < len; ++i) {
+         h ^= static_cast<unsigned char>(data[i]);
+         h *= 16777619u;
+      }
+      return h;
+   }
+
+   // Write as much of the range as possible, retrying on short writes and
+   // EINTR; returns the number of bytes that reached the file
+   static size_t writeAll(int fd, const char* data, size_t len) {
+      size_t written = 0;
+      while (written < len) {
+         ssize_t n = ::write(fd, data + written, len - written);
+         if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+         }
+         if (n == 0) break;
+         written += static_cast<size_t>(n);
+      }
+      return written;
+   }
+
+   // Opens (or creates) the log file in append mode
+   HashTableLog::HashTableLog(const std::string& path, SyncPolicy policy, size_t groupSize,
+                              std::chrono::milliseconds interval)
+       : path(path), policy(policy), groupSize(groupSize == 0 ? 1 : groupSize), interval(interval),
+         lastCommit(std::chrono::steady_clock::now()) {
+      fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+   }
+
+   // Detaches from its table (which resolves its operator[] writes) and
+   // flushes whatever is still buffered before closing
+   HashTableLog::~HashTableLog() {
+      if (table) table->attachLog(nullptr);
+      if (fd >= 0) {
+         commit();
+         ::close(fd);
+      }
+   }
+
+   bool HashTableLog::isOpen() const {
+      return fd >= 0;
+   }
+
+   const std::string& HashTableLog::getPath() const {
+      return path;
+   }
+
+   // Serialize one record into the group buffer; nothing touches the disk here
+   void HashTableLog::append(LogOp op, std::string_view key, size_t value) {
+      size_t start = buffer.size();
+      buffer.resize(start + RECORD_HEADER + key.size());
+      char* p = buffer.data() + start;
+
+      uint8_t opByte = static_cast<uint8_t>(op);
+      uint32_t keyLen = static_cast<uint32_t>(key.size());
+      uint64_t val = value;
+      std::memcpy(p + 4, &opByte, sizeof(opByte));
+      std::memcpy(p + 5, &keyLen, sizeof(keyLen));
+      std::memcpy(p + 9, &val, sizeof(val));
+      std::memcpy(p + RECORD_HEADER, key.data(), key.size());
+
+      uint32_t sum = recordChecksum(p + 4, RECORD_HEADER - 4 + key.size());
+      std::memcpy(p, &sum, sizeof(sum));
+      ++pendingRecords;
+   }
+
+   /*
+    * True when the buffered group should be committed under the current
+    * policy.  deferred is the number of operator[] writes the table holds
+    * back until the commit; they count as records of the group.
+    */
+   bool HashTableLog::commitDue(size_t deferred) const {
+      const size_t records = pendingRecords + deferred;
+      if (records == 0) return false;
+      if (deferred >= MAX_DEFERRED) return true;
+      switch (policy) {
+         case SyncPolicy::EVERY_OP:
+            return records >= groupSize;
+         case SyncPolicy::INTERVAL:
+            return buffer.size() >= MAX_BUFFER_BYTES ||
+                   std::chrono::steady_clock::now() - lastCommit >= interval;
+         case SyncPolicy::NEVER:
+            return buffer.size() >= MAX_BUFFER_BYTES;
+      }
+      return false;
+   }
+
+   /*
+    * Group commit: one write() for every buffered record, then one
+    * fdatasync().  Bytes that reached the file leave the buffer even if the
+    * write stops short or the sync fails, so a retry continues the record
+    * stream instead of appending a second copy after a torn prefix.
+    */
+   bool HashTableLog::commit() {
+      if (fd < 0) return false;
+      if (buffer.empty() && !unsynced) return true;
+
+      const size_t written = writeAll(fd, buffer.data(), buffer.size());
+      buffer.erase(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(written));
+      unsynced = unsynced || written > 0;
+      if (!buffer.empty()) {
+         return false;
+      }
+      if (policy != SyncPolicy::NEVER) {
+         if (::fdatasync(fd) != 0) {
+            return false;
+         }
+         ++syncCount;
+      }
+
+      unsynced = false;
+      pendingRecords = 0;
+      ++commitCount;
+      lastCommit = std::chrono::steady_clock::now();
+      return true;
+   }
+
+   // Discard the on-disk log; called once a snapshot covers everything in it
+   bool HashTableLog::truncate() {
+      if (fd < 0) return false;
+      buffer.clear();
+      pendingRecords = 0;
+      unsynced = false;
+      if (::ftruncate(fd, 0) != 0) return false;
+      return ::fdatasync(fd) == 0;
+   }
+
+   size_t HashTableLog::pending() const {
+      return pendingRecords;
+   }
+
+   size_t HashTableLog::commits() const {
+      return commitCount;
+   }
+
+   size_t HashTableLog::syncs() const {
+      return syncCount;
+   }
+
+   // Apply every intact record of the log at path to ht, stopping at the first
+   // torn or corrupt record.  Anything from there on is cut off the file, so
+   // records appended after recovery do not land behind the garbage and get
+   // dropped by the next replay.  Returns the number of records applied.
+   size_t HashTableLog::replay(const std::string& path, HashTable& ht) {
+      int in = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (in < 0) return 0;
+
+      std::vector<char> data;
+      char chunk[1 << 16];
+      ssize_t n;
+      while ((n = ::read(in, chunk, sizeof(chunk))) > 0) {
+         data.insert(data.end(), chunk, chunk + n);
+      }
+      ::close(in);
+
+      size_t applied = 0;
+      size_t pos = 0;
+      while (pos + RECORD_HEADER <= data.size()) {
+         const char* p = data.data() + pos;
+         uint32_t sum;
+         uint8_t opByte;
+         uint32_t keyLen;
+         uint64_t val;
+         std::memcpy(&sum, p, sizeof(sum));
+         std::memcpy(&opByte, p + 4, sizeof(opByte));
+         std::memcpy(&keyLen, p + 5, sizeof(keyLen));
+         std::memcpy(&val, p + 9, sizeof(val));
+
+         if (pos + RECORD_HEADER + keyLen > data.size()) break;
+         if (recordChecksum(p + 4, RECORD_HEADER - 4 + keyLen) != sum) break;
+
+         LogOp op = static_cast<LogOp>(opByte);
+         if (op != LogOp::INSERT && op != LogOp::REMOVE && op != LogOp::ASSIGN) break;
+
+         std::string key(p + RECORD_HEADER, keyLen);
+         switch (op) {
+            case LogOp::INSERT:
+               ht.insert(key, val);
+               break;
+            case LogOp::REMOVE:
+               ht.remove(key);
+               break;
+            case LogOp::ASSIGN:
+               ht[key] = val;
+               break;
+         }
+         ++applied;
+         pos += RECORD_HEADER + keyLen;
+      }
+
+      if (pos < data.size()) {
+         int out = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+         if (out >= 0) {
+            if (::ftruncate(out, static_cast<off_t>(pos)) == 0) {
+               ::fdatasync(out);
+            }
+            ::close(out);
+         }
+      }
+      return applied;
+   }
+
+}
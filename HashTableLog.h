@@ -0,0 +1,103 @@
+/*
+// HashTableLog.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Optional append-only mutation log (write-ahead log) for a HashTable.  Every
+// insert, remove and operator[] assignment is appended as a small checksummed
+// record to an in-memory buffer.  Records from many operations are written out
+// together with a single write() + fdatasync() (group commit), so the cost of a
+// sync is shared by the whole group.  Recovery loads the latest snapshot and
+// replays the log on top of it.
+// Commits only happen when the table is written to, so under INTERVAL the
+// last writes before the table goes quiet stay buffered until the owner
+// calls HashTable::logTick() (or syncLog()) from its idle loop.
+// Actionable members include:
+// - append - buffer one mutation record
+// - commitDue - true when the sync policy says the buffered group should go out
+// - commit - write the buffered group and sync it according to the policy; after a
+//   failed or short write, the next commit resumes where the file left off
+// - truncate - drop the log contents after a checkpoint
+// - replay - apply every intact record of a log file to a HashTable and truncate
+//   the file after the last one
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLELOG_H
+#define PROJECT4_HASHTABLE_HASHTABLELOG_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    class HashTable;
+
+    enum class LogOp : uint8_t {
+        INSERT = 1, // insert(key, value)
+        REMOVE = 2, // remove(key)
+        ASSIGN = 3  // operator[](key) = value
+    };
+
+    enum class SyncPolicy {
+        EVERY_OP, // write + fdatasync every group of groupSize operations
+        INTERVAL, // write + fdatasync at most once per interval
+        NEVER     // write when the buffer fills, leave syncing to the OS
+    };
+
+    class HashTableLog {
+    private:
+        int fd = -1;
+        std::string path;
+        SyncPolicy policy;
+        size_t groupSize;
+        std::chrono::milliseconds interval;
+        std::vector<char> buffer;  // records not yet written to the file
+        size_t pendingRecords = 0;
+        bool unsynced = false;     // written since the last successful fdatasync
+        std::chrono::steady_clock::time_point lastCommit;
+        size_t commitCount = 0;
+        size_t syncCount = 0;
+
+        // The table this log is attached to; whichever of the two goes first
+        // detaches the other, so operator[] writes still pending are flushed
+        HashTable* table = nullptr;
+        friend class HashTable;
+
+        // Buffer size at which NEVER / INTERVAL policies write regardless of time
+        static constexpr size_t MAX_BUFFER_BYTES = 1 << 20;
+        // operator[] writes a table may hold back before a commit is due regardless of policy
+        static constexpr size_t MAX_DEFERRED = 4096;
+
+    public:
+        HashTableLog(const std::string& path,
+                     SyncPolicy policy = SyncPolicy::EVERY_OP,
+                     size_t groupSize = 1,
+                     std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+        ~HashTableLog();
+
+        HashTableLog(const HashTableLog&) = delete;
+        HashTableLog& operator=(const HashTableLog&) = delete;
+
+        bool isOpen() const;
+        const std::string& getPath() const;
+
+        void append(LogOp op, std::string_view key, size_t value);
+        bool commitDue(size_t deferred = 0) const;
+        bool commit();
+        bool truncate();
+
+        size_t pending() const;
+        size_t commits() const;
+        size_t syncs() const;
+
+        static size_t replay(const std::string& path, HashTable& ht);
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLELOG_H
@@ -0,0 +1,293 @@
+/*
+// HashTableReplication.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Change feed compaction, the replication wire format, and the replica side
+// of a pull.  The primary side is HashTable::serveReplica.
+*/
+
+#include "HashTableReplication.h"
+#include "HashTable.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace std {
+
+   HashTableChangeFeed::HashTableChangeFeed(size_t maxChanges)
+       : maxChanges(std::max<size_t>(maxChanges, 1)) {
+      std::random_device seed;
+      feedEpoch = (static_cast<uint64_t>(seed()) << 32) | seed();
+   }
+
+   /*
+    * Number the change with the next version.  It supersedes any earlier
+    * change to the same key, whose entry stays where it is until it reaches
+    * the front or compact() sweeps it out.  If the feed is then over
+    * maxChanges live entries the oldest are dropped.
+    */
+   void HashTableChangeFeed::record(LogOp op, std::string_view key, size_t value) {
+      const uint64_t version = ++head;
+      auto it = latest.find(key);
+      if (it == latest.end()) {
+         it = latest.emplace(std::string(key), Latest{}).first;
+      } else {
+         --liveCount;
+         ++supersededCount;
+      }
+      it->second = {version, op, value};
+      entries.push_back({version, &*it});
+      ++liveCount;
+
+      while (liveCount > maxChanges) dropOldest();
+      while (!entries.front().live()) entries.pop_front();
+      // Sweep once superseded entries outnumber live ones, so each sweep
+      // costs no more than the records that made it necessary
+      if (entries.size() - liveCount > std::max<size_t>(liveCount, 64)) compact();
+   }
+
+   uint64_t HashTableChangeFeed::epoch() const {
+      return feedEpoch;
+   }
+
+   uint64_t HashTableChangeFeed::version() const {
+      return head;
+   }
+
+   uint64_t HashTableChangeFeed::oldestVersion() const {
+      return floor;
+   }
+
+   /*
+    * Copy up to maxChanges live changes newer than from into out, oldest
+    * first.  Returns false if changes after from have been dropped (or from
+    * is ahead of this feed), in which case the replica needs a snapshot.
+    */
+   bool HashTableChangeFeed::changesSince(uint64_t from, std::vector<HashTableChange>& out,
+                                          size_t maxChanges) const {
+      out.clear();
+      if (from < floor || from > head) return false;
+      for (size_t i = positionOf(from + 1); i < entries.size() && out.size() < maxChanges; ++i) {
+         if (!entries[i].live()) continue;
+         const auto& [key, change] = *entries[i].node;
+         out.push_back({entries[i].version, change.op, change.value, key});
+      }
+      return true;
+   }
+
+   size_t HashTableChangeFeed::size() const {
+      return liveCount;
+   }
+
+   uint64_t HashTableChangeFeed::superseded() const {
+      return supersededCount;
+   }
+
+   uint64_t HashTableChangeFeed::dropped() const {
+      return droppedCount;
+   }
+
+   // Index of the first entry at or after version; entries are in version order
+   size_t HashTableChangeFeed::positionOf(uint64_t version) const {
+      auto it = std::lower_bound(entries.begin(), entries.end(), version,
+                                 [](const Entry& e, uint64_t v) { return e.version < v; });
+      return static_cast<size_t>(it - entries.begin());
+   }
+
+   // Drop the front entry; a live one moves the floor past its version
+   void HashTableChangeFeed::dropOldest() {
+      const Entry front = entries.front();
+      entries.pop_front();
+      if (front.live()) {
+         floor = front.version;
+         latest.erase(front.node->first);
+         --liveCount;
+         ++droppedCount;
+      }
+   }
+
+   void HashTableChangeFeed::compact() {
+      std::erase_if(entries, [](const Entry& e) { return !e.live(); });
+   }
+
+   // Change layout: [u8 op][u32 key length][u64 value][key]
+   void HashTableChangeFeed::appendChange(std::string& out, LogOp op, std::string_view key, size_t value) {
+      const uint8_t code = static_cast<uint8_t>(op);
+      const uint32_t len = static_cast<uint32_t>(key.size());
+      const uint64_t v = value;
+      out.append(reinterpret_cast<const char*>(&code), sizeof(code));
+      out.append(reinterpret_cast<const char*>(&len), sizeof(len));
+      out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+      out.append(key);
+   }
+
+   // Write the whole range, retrying on short writes and EINTR.  Sockets use
+   // MSG_NOSIGNAL so a vanished peer is an error rather than SIGPIPE.
+   static bool writeAll(int fd, const char* data, size_t len) {
+      bool socket = true;
+      while (len > 0) {
+         ssize_t n = socket ? ::send(fd, data, len, MSG_NOSIGNAL) : ::write(fd, data, len);
+         if (n < 0) {
+            if (errno == EINTR) continue;
+            if (socket && errno == ENOTSOCK) {
+               socket = false;
+               continue;
+            }
+            return false;
+         }
+         data += n;
+         len -= static_cast<size_t>(n);
+      }
+      return true;
+   }
+
+   // Read exactly len bytes; false on EOF or error
+   static bool readAll(int fd, char* data, size_t len) {
+      while (len > 0) {
+         ssize_t n = ::read(fd, data, len);
+         if (n < 0 && errno == EINTR) continue;
+         if (n <= 0) return false;
+         data += n;
+         len -= static_cast<size_t>(n);
+      }
+      return true;
+   }
+
+   static constexpr size_t FRAME_HEADER = sizeof(uint64_t) + sizeof(uint8_t);
+
+   bool HashTableChangeFeed::writeFrame(int fd, ReplicationFrame type, std::string_view body) {
+      char header[FRAME_HEADER];
+      const uint64_t len = body.size();
+      std::memcpy(header, &len, sizeof(len));
+      header[sizeof(len)] = static_cast<char>(type);
+      return writeAll(fd, header, sizeof(header)) && writeAll(fd, body.data(), body.size());
+   }
+
+   // Read one frame; false on EOF, error, or a body longer than maxBody
+   // (checked before anything is allocated for it)
+   bool HashTableChangeFeed::readFrame(int fd, ReplicationFrame& type, std::string& body, size_t maxBody) {
+      char header[FRAME_HEADER];
+      if (!readAll(fd, header, sizeof(header))) return false;
+      uint64_t len = 0;
+      std::memcpy(&len, header, sizeof(len));
+      if (len > maxBody) return false;
+      type = static_cast<ReplicationFrame>(header[sizeof(len)]);
+      body.resize(len);
+      return readAll(fd, body.data(), len);
+   }
+
+   HashTableReplica::HashTableReplica(HashTable& table, size_t maxFrameBytes)
+       : table(table), maxFrameBytes(maxFrameBytes) {}
+
+   // Copy a fixed-size field out of [p, end); false if it runs past end
+   template<typename T>
+   static bool take(const char*& p, const char* end, T& value) {
+      if (static_cast<size_t>(end - p) < sizeof(T)) return false;
+      std::memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+      return true;
+   }
+
+   /*
+    * One round trip: ask the primary for up to maxChanges changes after this
+    * replica's version and apply the reply, a batch of changes or a whole
+    * snapshot.  in and out are the same descriptor for a socket.  Returns
+    * false if the primary has gone away or sent a malformed reply.
+    */
+   bool HashTableReplica::pull(int in, int out, size_t maxChanges) {
+      const uint32_t max = static_cast<uint32_t>(std::clamp<size_t>(maxChanges, 1, UINT32_MAX));
+      char request[HashTableChangeFeed::PULL_BYTES];
+      std::memcpy(request, &feedEpoch, sizeof(feedEpoch));
+      std::memcpy(request + sizeof(feedEpoch), &current, sizeof(current));
+      std::memcpy(request + sizeof(feedEpoch) + sizeof(current), &max, sizeof(max));
+      if (!HashTableChangeFeed::writeFrame(out, ReplicationFrame::PULL, std::string_view(request, sizeof(request)))) {
+         return false;
+      }
+
+      ReplicationFrame type;
+      if (!HashTableChangeFeed::readFrame(in, type, buffer, maxFrameBytes)) return false;
+      receivedBytes += FRAME_HEADER + buffer.size();
+      const char* p = buffer.data();
+      const char* end = p + buffer.size();
+      if (type == ReplicationFrame::SNAPSHOT) return applySnapshot(p, end);
+      if (type == ReplicationFrame::CHANGES) return applyChanges(p, end);
+      return false;
+   }
+
+   uint64_t HashTableReplica::version() const {
+      return current;
+   }
+
+   bool HashTableReplica::upToDate() const {
+      return caughtUp;
+   }
+
+   uint64_t HashTableReplica::snapshots() const {
+      return snapshotCount;
+   }
+
+   uint64_t HashTableReplica::changesApplied() const {
+      return appliedCount;
+   }
+
+   uint64_t HashTableReplica::bytesReceived() const {
+      return receivedBytes;
+   }
+
+   /*
+    * Replace the table's contents with the snapshot, then take on the
+    * snapshot's epoch and version.
+    */
+   bool HashTableReplica::applySnapshot(const char* p, const char* end) {
+      uint64_t epoch = 0, version = 0, count = 0;
+      if (!take(p, end, epoch) || !take(p, end, version) || !take(p, end, count)) return false;
+      table.eraseIf([](std::string_view, size_t) { return true; });
+      for (uint64_t i = 0; i < count; ++i) {
+         uint32_t len = 0;
+         uint64_t value = 0;
+         if (!take(p, end, len) || static_cast<size_t>(end - p) < len) return false;
+         std::string_view key(p, len);
+         p += len;
+         if (!take(p, end, value)) return false;
+         table[key] = value;
+      }
+      feedEpoch = epoch;
+      current = version;
+      caughtUp = true;
+      ++snapshotCount;
+      return true;
+   }
+
+   // Apply a batch of changes: INSERT sets the key's value, REMOVE removes it
+   bool HashTableReplica::applyChanges(const char* p, const char* end) {
+      uint64_t epoch = 0, to = 0;
+      uint8_t more = 0;
+      uint32_t count = 0;
+      if (!take(p, end, epoch) || !take(p, end, to) || !take(p, end, more) || !take(p, end, count)) return false;
+      for (uint32_t i = 0; i < count; ++i) {
+         uint8_t op = 0;
+         uint32_t len = 0;
+         uint64_t value = 0;
+         if (!take(p, end, op) || !take(p, end, len) || !take(p, end, value) || static_cast<size_t>(end - p) < len) {
+            return false;
+         }
+         std::string_view key(p, len);
+         p += len;
+         if (static_cast<LogOp>(op) == LogOp::REMOVE) table.remove(key);
+         else table[key] = value;
+         ++appliedCount;
+      }
+      feedEpoch = epoch;
+      current = to;
+      caughtUp = more == 0;
+      return true;
+   }
+
+}
@@ -0,0 +1,161 @@
+/*
+// HashTableReplication.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Incremental replication of a HashTable to replicas in other processes.
+// A primary table with a HashTableChangeFeed attached numbers every mutation
+// with the next version and keeps it in the feed.  Only the newest change to
+// each key is kept: a change supersedes any earlier one to the same key, so
+// a hot key costs one entry however often it is written.  The feed holds at
+// most maxChanges live entries; once it is full the oldest are dropped, and
+// a replica still behind them has to start over from a full snapshot.
+// Replicas pull over a byte stream (a pipe pair, socketpair or Unix socket):
+// HashTableReplica::pull sends its version, the primary's
+// HashTable::serveReplica answers with every change since then, or with a
+// snapshot of the whole table if the feed no longer reaches back that far.
+// Every feed has a random epoch, so a replica of an earlier primary process
+// is sent a snapshot rather than changes numbered by some other feed.
+// Frames are [u64 body length][u8 type][body] in host byte order, so both
+// ends must run on the same kind of machine.  The length comes from the
+// peer, so each reader caps it: a PULL body is exactly PULL_BYTES, and a
+// replica refuses replies longer than its maxFrameBytes.
+// Actionable members include:
+// - HashTableChangeFeed::record - add one mutation (HashTable calls this)
+// - HashTableChangeFeed::epoch - random id of this feed
+// - HashTableChangeFeed::version / oldestVersion - newest version, and the
+//   oldest one a replica can still catch up from without a snapshot
+// - HashTableChangeFeed::changesSince - the compacted changes after a version
+// - HashTableChangeFeed::writeFrame / readFrame / appendChange - the wire format
+// - HashTableReplica::pull - one round trip: request, then apply the reply
+// - HashTableReplica::version / snapshots / changesApplied / bytesReceived - replica progress
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLEREPLICATION_H
+#define PROJECT4_HASHTABLE_HASHTABLEREPLICATION_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "HashTableLog.h"
+
+namespace std {
+
+    class HashTable;
+
+    // One change in a feed; op is INSERT, REMOVE or ASSIGN as in the log
+    struct HashTableChange {
+        uint64_t version;
+        LogOp op;
+        size_t value; // unused for REMOVE; for ASSIGN, resolved when served
+        std::string key;
+    };
+
+    // Replication frame types
+    enum class ReplicationFrame : uint8_t {
+        PULL = 1,    // replica -> primary: [u64 epoch][u64 from version][u32 max changes]
+        CHANGES = 2, // primary -> replica: [u64 epoch][u64 to version][u8 more][u32 count] count x change
+        SNAPSHOT = 3 // primary -> replica: [u64 epoch][u64 version][u64 count] count x entry
+    };
+
+    class HashTableChangeFeed {
+    public:
+        static constexpr size_t DEFAULT_CHANGES = size_t{1} << 20;
+        // Body of a PULL frame: epoch, from version, max changes
+        static constexpr size_t PULL_BYTES = sizeof(uint64_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+        explicit HashTableChangeFeed(size_t maxChanges = DEFAULT_CHANGES);
+
+        void record(LogOp op, std::string_view key, size_t value);
+
+        uint64_t epoch() const;
+        uint64_t version() const;
+        uint64_t oldestVersion() const;
+        bool changesSince(uint64_t from, std::vector<HashTableChange>& out, size_t maxChanges) const;
+
+        size_t size() const;
+        uint64_t superseded() const;
+        uint64_t dropped() const;
+
+        static void appendChange(std::string& out, LogOp op, std::string_view key, size_t value);
+        static bool writeFrame(int fd, ReplicationFrame type, std::string_view body);
+        static bool readFrame(int fd, ReplicationFrame& type, std::string& body, size_t maxBody);
+
+    private:
+        // Lets latest be searched with a string_view
+        struct KeyHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+        };
+
+        // A key's newest change
+        struct Latest {
+            uint64_t version;
+            LogOp op;
+            size_t value;
+        };
+        using Node = std::pair<const std::string, Latest>;
+
+        // One version in the feed.  It is superseded once its key has a newer
+        // change; the node outlives every entry pointing at it, because only
+        // the newest entry of a key can drop it, from the front.
+        struct Entry {
+            uint64_t version;
+            const Node* node;
+            bool live() const { return node->second.version == version; }
+        };
+
+        size_t maxChanges;
+        uint64_t feedEpoch;
+        std::unordered_map<std::string, Latest, KeyHash, std::equal_to<>> latest;
+        std::deque<Entry> entries; // version order
+        size_t liveCount = 0;
+        uint64_t head = 0;  // newest version handed out
+        uint64_t floor = 0; // newest version dropped while live
+        uint64_t supersededCount = 0;
+        uint64_t droppedCount = 0;
+
+        size_t positionOf(uint64_t version) const;
+        void dropOldest();
+        void compact();
+    };
+
+    class HashTableReplica {
+    public:
+        static constexpr size_t DEFAULT_BATCH = 64 * 1024;
+        static constexpr size_t DEFAULT_MAX_FRAME = size_t{1} << 30;
+
+        explicit HashTableReplica(HashTable& table, size_t maxFrameBytes = DEFAULT_MAX_FRAME);
+
+        bool pull(int in, int out, size_t maxChanges = DEFAULT_BATCH);
+
+        uint64_t version() const;
+        bool upToDate() const;
+        uint64_t snapshots() const;
+        uint64_t changesApplied() const;
+        uint64_t bytesReceived() const;
+
+    private:
+        HashTable& table;
+        size_t maxFrameBytes; // longest reply body accepted; a snapshot must fit
+        uint64_t feedEpoch = 0;
+        uint64_t current = 0;
+        bool caughtUp = false;
+        uint64_t snapshotCount = 0;
+        uint64_t appliedCount = 0;
+        uint64_t receivedBytes = 0;
+        std::string buffer;
+
+        bool applySnapshot(const char* p, const char* end);
+        bool applyChanges(const char* p, const char* end);
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLEREPLICATION_H
@@ -0,0 +1,228 @@
+/*
+// HashTableResp.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// RESP2 request parsing and reply encoding for HashTableServer.
+*/
+
+#include "HashTableResp.h"
+#include <charconv>
+
+namespace std {
+
+   enum class RespStep { DONE, INCOMPLETE, BAD };
+
+   // Longest integer line worth waiting for ("*", "$" and ":" headers)
+   static constexpr size_t MAX_NUMBER_LINE = 32;
+
+   /*
+    * Signed decimal from pos up to the next \r\n; pos moves past the \r\n.
+    * A line that is still unterminated after MAX_NUMBER_LINE bytes is bad.
+    */
+   static RespStep readNumber(std::string_view in, size_t& pos, int64_t& value) {
+      size_t end = in.find("\r\n", pos);
+      if (end == std::string_view::npos) {
+         return in.size() - pos > MAX_NUMBER_LINE ? RespStep::BAD : RespStep::INCOMPLETE;
+      }
+      auto [ptr, ec] = std::from_chars(in.data() + pos, in.data() + end, value);
+      if (ec != std::errc() || ptr != in.data() + end) return RespStep::BAD;
+      pos = end + 2;
+      return RespStep::DONE;
+   }
+
+   // Up to left bulk strings "$len\r\n<len bytes>\r\n"; pos and left only
+   // move past complete ones
+   static RespStep parseBulks(std::string_view in, size_t& pos, int64_t& left, HashTableResp::Batch& batch) {
+      for (; left > 0; --left) {
+         size_t at = pos;
+         if (at >= in.size()) return RespStep::INCOMPLETE;
+         if (in[at] != '$') {
+            batch.error = "Protocol error: expected '$'";
+            return RespStep::BAD;
+         }
+         ++at;
+         int64_t length = 0;
+         RespStep step = readNumber(in, at, length);
+         if (step == RespStep::INCOMPLETE) return step;
+         if (step == RespStep::BAD || length < 0 || static_cast<uint64_t>(length) > HashTableResp::MAX_BULK) {
+            batch.error = "Protocol error: invalid bulk length";
+            return RespStep::BAD;
+         }
+         const size_t bytes = static_cast<size_t>(length);
+         if (in.size() - at < bytes + 2) return RespStep::INCOMPLETE;
+         if (in[at + bytes] != '\r' || in[at + bytes + 1] != '\n') {
+            batch.error = "Protocol error: bulk string not terminated";
+            return RespStep::BAD;
+         }
+         batch.args.push_back(in.substr(at, bytes));
+         pos = at + bytes + 2;
+      }
+      return RespStep::DONE;
+   }
+
+   /*
+    * "*N\r\n" then N bulk strings.  With a saved Resume the header and the
+    * bulk strings already read are not parsed again; an array that is still
+    * incomplete after its header saves its progress there.
+    */
+   static RespStep parseArray(std::string_view in, size_t& pos, HashTableResp::Batch& batch,
+                              HashTableResp::Resume* resume) {
+      const size_t start = pos;
+      const size_t argsBefore = batch.args.size();
+      int64_t left = 0;
+      if (resume && resume->argsLeft > 0) {
+         for (auto [offset, length] : resume->args) batch.args.push_back(in.substr(start + offset, length));
+         pos = start + resume->pos;
+         left = resume->argsLeft;
+      } else {
+         ++pos;
+         RespStep step = readNumber(in, pos, left);
+         if (step != RespStep::DONE || left <= 0) {
+            if (step == RespStep::BAD) batch.error = "Protocol error: invalid multibulk length";
+            return step; // "*0" and "*-1" are empty requests
+         }
+         if (static_cast<uint64_t>(left) > HashTableResp::MAX_ARGS) {
+            batch.error = "Protocol error: invalid multibulk length";
+            return RespStep::BAD;
+         }
+      }
+
+      RespStep step = parseBulks(in, pos, left, batch);
+      if (resume) {
+         resume->clear();
+         if (step == RespStep::INCOMPLETE) {
+            resume->pos = pos - start;
+            resume->argsLeft = left;
+            for (size_t a = argsBefore; a < batch.args.size(); ++a) {
+               const size_t offset = static_cast<size_t>(batch.args[a].data() - in.data()) - start;
+               resume->args.emplace_back(offset, batch.args[a].size());
+            }
+         }
+      }
+      return step;
+   }
+
+   // One line of space-separated words; a blank line is an empty request
+   static RespStep parseInline(std::string_view in, size_t& pos, HashTableResp::Batch& batch) {
+      size_t end = in.find('\n', pos);
+      if (end == std::string_view::npos) {
+         if (in.size() - pos <= HashTableResp::MAX_INLINE) return RespStep::INCOMPLETE;
+         batch.error = "Protocol error: too big inline request";
+         return RespStep::BAD;
+      }
+      std::string_view line = in.substr(pos, end - pos);
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      size_t at = 0;
+      while (at < line.size()) {
+         size_t space = line.find(' ', at);
+         if (space == std::string_view::npos) space = line.size();
+         if (space > at) batch.args.push_back(line.substr(at, space - at));
+         at = space + 1;
+      }
+      pos = end + 1;
+      return RespStep::DONE;
+   }
+
+   /*
+    * Append every complete request at the front of input to batch and return
+    * the bytes they took.  An incomplete request at the end is left for the
+    * next call with more data; given a resume, that call picks the request up
+    * where this one stopped.  On a protocol error batch.error is set and the
+    * requests before it are kept.
+    */
+   size_t HashTableResp::parse(std::string_view input, Batch& batch, Resume* resume) {
+      size_t consumed = 0;
+      // Saved progress only ever belongs to the first request
+      if (resume && (input.empty() || input[0] != '*')) resume->clear();
+      while (consumed < input.size()) {
+         const size_t argsBefore = batch.args.size();
+         size_t pos = consumed;
+         RespStep step = input[pos] == '*' ? parseArray(input, pos, batch, resume) : parseInline(input, pos, batch);
+         if (step != RespStep::DONE) {
+            batch.args.resize(argsBefore);
+            break;
+         }
+         if (batch.args.size() > argsBefore) batch.commands.push_back({argsBefore, batch.args.size() - argsBefore});
+         consumed = pos;
+      }
+      return consumed;
+   }
+
+   static void appendNumberLine(std::string& out, char type, int64_t value) {
+      char digits[24];
+      auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+      out += type;
+      out.append(digits, end);
+      out += "\r\n";
+   }
+
+   void HashTableResp::appendSimple(std::string& out, std::string_view text) {
+      out += '+';
+      out += text;
+      out += "\r\n";
+   }
+
+   void HashTableResp::appendError(std::string& out, std::string_view message) {
+      out += '-';
+      out += message;
+      out += "\r\n";
+   }
+
+   void HashTableResp::appendInteger(std::string& out, int64_t value) {
+      appendNumberLine(out, ':', value);
+   }
+
+   void HashTableResp::appendBulk(std::string& out, std::string_view bytes) {
+      appendNumberLine(out, '$', static_cast<int64_t>(bytes.size()));
+      out += bytes;
+      out += "\r\n";
+   }
+
+   void HashTableResp::appendNull(std::string& out) {
+      out += "$-1\r\n";
+   }
+
+   void HashTableResp::appendArray(std::string& out, size_t count) {
+      appendNumberLine(out, '*', static_cast<int64_t>(count));
+   }
+
+   void HashTableResp::appendCommand(std::string& out, std::span<const std::string_view> args) {
+      appendArray(out, args.size());
+      for (std::string_view arg : args) appendBulk(out, arg);
+   }
+
+   // End of the reply starting at pos, or npos if it is incomplete or malformed
+   static size_t replyEnd(std::string_view in, size_t pos) {
+      if (pos >= in.size()) return std::string_view::npos;
+      const char type = in[pos];
+      if (type == '+' || type == '-' || type == ':') {
+         size_t end = in.find("\r\n", pos);
+         return end == std::string_view::npos ? end : end + 2;
+      }
+      if (type != '$' && type != '*') return std::string_view::npos;
+      ++pos;
+      int64_t count = 0;
+      if (readNumber(in, pos, count) != RespStep::DONE) return std::string_view::npos;
+      if (count < 0) return pos; // null bulk or null array
+      if (type == '$') {
+         const size_t bytes = static_cast<size_t>(count);
+         return in.size() - pos < bytes + 2 ? std::string_view::npos : pos + bytes + 2;
+      }
+      for (int64_t k = 0; k < count && pos != std::string_view::npos; ++k) pos = replyEnd(in, pos);
+      return pos;
+   }
+
+   /*
+    * Bytes taken by the first reply in input, or 0 if it has not all
+    * arrived (or is not a reply).  Lets a client count pipelined replies.
+    */
+   size_t HashTableResp::replyLength(std::string_view input) {
+      size_t end = replyEnd(input, 0);
+      return end == std::string_view::npos ? 0 : end;
+   }
+
+}
@@ -0,0 +1,92 @@
+/*
+// HashTableResp.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// The subset of the Redis serialization protocol (RESP2) that HashTableServer
+// speaks.  Requests are arrays of bulk strings ("*2\r\n$3\r\nGET\r\n$1\r\nk\r\n")
+// or inline lines ("GET k\r\n", as typed into telnet).  parse() takes as many
+// complete requests as a buffer holds, so a pipelined read becomes one batch;
+// arguments are views into that buffer, and the batch's vectors are reused
+// from read to read, so steady-state parsing does not allocate.  A Resume
+// records how far parse() got into an array request that had not fully
+// arrived, so a request spread over many reads is parsed once, not again
+// from its start on every read.
+// Actionable members include:
+// - parse - append every complete request in a buffer to a Batch, optionally
+//   resuming a partial request where the previous call stopped
+// - appendSimple / appendError / appendInteger / appendBulk / appendNull /
+//   appendArray - encode one reply (or a command, as an array of bulks)
+// - replyLength - size of the first complete reply in a buffer (for clients)
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLERESP_H
+#define PROJECT4_HASHTABLE_HASHTABLERESP_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    class HashTableResp {
+    public:
+        static constexpr size_t MAX_BULK = size_t{64} << 20; // longest accepted key or value
+        static constexpr size_t MAX_ARGS = size_t{1} << 20;  // most arguments in one request
+        static constexpr size_t MAX_INLINE = size_t{64} << 10; // longest inline request line
+
+        // Requests parsed from one buffer; args are views into that buffer
+        struct Batch {
+            struct Command {
+                size_t first;
+                size_t count;
+            };
+            std::vector<std::string_view> args;
+            std::vector<Command> commands;
+            const char* error = nullptr; // set on a protocol error; parsing stopped there
+
+            void clear() {
+                args.clear();
+                commands.clear();
+                error = nullptr;
+            }
+            std::span<const std::string_view> argsOf(const Command& command) const {
+                return std::span<const std::string_view>(args).subspan(command.first, command.count);
+            }
+        };
+
+        // Progress through the partial array request left at the end of the
+        // last parse(); offsets are from the start of that request, which the
+        // caller passes again at the front of its next input
+        struct Resume {
+            size_t pos = 0;     // bytes of the request already parsed
+            int64_t argsLeft = 0; // bulk strings still to read; 0 = nothing saved
+            std::vector<std::pair<size_t, size_t>> args; // offset and length of each one read
+
+            void clear() {
+                pos = 0;
+                argsLeft = 0;
+                args.clear();
+            }
+        };
+
+        static size_t parse(std::string_view input, Batch& batch, Resume* resume = nullptr);
+
+        static void appendSimple(std::string& out, std::string_view text);
+        static void appendError(std::string& out, std::string_view message);
+        static void appendInteger(std::string& out, int64_t value);
+        static void appendBulk(std::string& out, std::string_view bytes);
+        static void appendNull(std::string& out);
+        static void appendArray(std::string& out, size_t count);
+        static void appendCommand(std::string& out, std::span<const std::string_view> args);
+
+        static size_t replyLength(std::string_view input);
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLERESP_H
@@ -0,0 +1,421 @@
+/*
+// HashTableServer.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// epoll loop, connection buffers and command execution for HashTableServer.
+*/
+
+#include "HashTableServer.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace std {
+
+   // Case-insensitive match of a command name against its upper-case form
+   static bool commandIs(std::string_view name, std::string_view upper) {
+      if (name.size() != upper.size()) return false;
+      for (size_t i = 0; i < name.size(); ++i) {
+         if (std::toupper(static_cast<unsigned char>(name[i])) != upper[i]) return false;
+      }
+      return true;
+   }
+
+   // Commands whose keys go through the batched lookup path
+   static bool isRead(std::span<const std::string_view> args) {
+      if (commandIs(args[0], "GET")) return args.size() == 2;
+      return args.size() >= 2 && (commandIs(args[0], "MGET") || commandIs(args[0], "EXISTS"));
+   }
+
+   static void appendArityError(std::string& out, std::string_view name) {
+      std::string message = "ERR wrong number of arguments for '";
+      for (char c : name) message += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      message += "' command";
+      HashTableResp::appendError(out, message);
+   }
+
+   static void appendValue(std::string& out, const std::string* value) {
+      if (value) HashTableResp::appendBulk(out, *value);
+      else HashTableResp::appendNull(out);
+   }
+
+   HashTableServer::HashTableServer(size_t expectedKeys)
+      : readBuffer(std::make_unique_for_overwrite<char[]>(READ_CHUNK)) {
+      if (expectedKeys > 0) store.reserve(expectedKeys);
+      epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+      wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (epollFd >= 0 && wakeFd >= 0) {
+         epoll_event event{};
+         event.events = EPOLLIN;
+         event.data.fd = wakeFd;
+         ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+      }
+   }
+
+   HashTableServer::~HashTableServer() {
+      for (auto& conn : connections) {
+         if (conn) ::close(conn->fd);
+      }
+      if (listenFd >= 0) ::close(listenFd);
+      if (wakeFd >= 0) ::close(wakeFd);
+      if (epollFd >= 0) ::close(epollFd);
+      if (!unixPath.empty()) ::unlink(unixPath.c_str());
+   }
+
+   bool HashTableServer::startListening(int fd) {
+      epoll_event event{};
+      event.events = EPOLLIN;
+      event.data.fd = fd;
+      if (::listen(fd, SOMAXCONN) < 0 || ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+         ::close(fd);
+         return false;
+      }
+      listenFd = fd;
+      return true;
+   }
+
+   /*
+    * Listen on a Unix-domain socket at path.  A socket file left there by an
+    * earlier run is removed first; any other kind of file is left alone and
+    * the bind fails.  Returns false if the server already listens.
+    */
+   bool HashTableServer::listenUnix(const std::string& path) {
+      sockaddr_un addr{};
+      addr.sun_family = AF_UNIX;
+      if (listenFd >= 0 || epollFd < 0 || path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+      std::memcpy(addr.sun_path, path.data(), path.size());
+
+      struct stat existing;
+      if (::lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) ::unlink(path.c_str());
+
+      int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (fd < 0) return false;
+      if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+         ::close(fd);
+         return false;
+      }
+      if (!startListening(fd)) {
+         ::unlink(path.c_str());
+         return false;
+      }
+      unixPath = path;
+      return true;
+   }
+
+   // Listen on 127.0.0.1:port; port 0 picks a free one, reported by port()
+   bool HashTableServer::listenTcp(uint16_t port) {
+      if (listenFd >= 0 || epollFd < 0) return false;
+      int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (fd < 0) return false;
+      int one = 1;
+      ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(port);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      socklen_t length = sizeof(addr);
+      if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+          ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) < 0) {
+         ::close(fd);
+         return false;
+      }
+      if (!startListening(fd)) return false;
+      tcp = true;
+      m_port = ntohs(addr.sin_port);
+      return true;
+   }
+
+   uint16_t HashTableServer::port() const {
+      return m_port;
+   }
+
+   /*
+    * Serve until stop().  Events are level-triggered: a connection is
+    * watched for EPOLLIN, or only for EPOLLOUT while it has replies it could
+    * not send.  Hang-ups and errors surface through the recv() or send()
+    * the event leads to.  Returns false if the server is not listening or
+    * epoll fails; on stop every client connection is closed.
+    */
+   bool HashTableServer::run() {
+      if (listenFd < 0 || wakeFd < 0) return false;
+      epoll_event events[MAX_EVENTS];
+      while (true) {
+         int ready = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+         if (ready < 0) {
+            if (errno == EINTR) continue;
+            return false;
+         }
+         for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+               uint64_t wakes;
+               ssize_t ignored = ::read(wakeFd, &wakes, sizeof(wakes));
+               (void) ignored;
+               for (auto& conn : connections) {
+                  if (conn) closeConnection(*conn);
+               }
+               return true;
+            }
+            if (fd == listenFd) {
+               acceptAll();
+               continue;
+            }
+            if (static_cast<size_t>(fd) >= connections.size() || !connections[fd]) continue;
+            Connection& conn = *connections[fd];
+            if (conn.writing) flush(conn);
+            else onReadable(conn);
+         }
+      }
+   }
+
+   // Async-signal-safe: one write() to the eventfd run() waits on
+   void HashTableServer::stop() {
+      uint64_t one = 1;
+      ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+      (void) ignored;
+   }
+
+   void HashTableServer::setBatchLookups(bool on) {
+      m_batchLookups = on;
+   }
+
+   // Applies from the next read on; at least READ_CHUNK so one read always fits
+   void HashTableServer::setQueryBufferLimit(size_t bytes) {
+      m_queryBufferLimit = std::max(bytes, READ_CHUNK);
+   }
+
+   // Only consistent while run() is not executing on another thread
+   HashTableServer::Counters HashTableServer::counters() const {
+      return m_counters;
+   }
+
+   size_t HashTableServer::size() const {
+      return store.size();
+   }
+
+   void HashTableServer::acceptAll() {
+      while (true) {
+         int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+         if (fd < 0) {
+            if (errno == EINTR) continue;
+            return; // EAGAIN once the backlog is empty
+         }
+         if (tcp) {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+         }
+         epoll_event event{};
+         event.events = EPOLLIN;
+         event.data.fd = fd;
+         if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+         }
+         if (connections.size() <= static_cast<size_t>(fd)) connections.resize(fd + 1);
+         connections[fd] = std::make_unique<Connection>();
+         connections[fd]->fd = fd;
+         ++m_counters.connections;
+      }
+   }
+
+   /*
+    * Take up to READ_CHUNK bytes and execute every complete request in them.
+    * When nothing is left over from the last read the requests are parsed
+    * straight out of readBuffer; only a partial request at the end is copied
+    * into the connection, to be finished by later reads.  conn.parsed keeps
+    * the parser's place in that request, so later reads resume there.  A
+    * partial request that would grow past the query buffer limit closes the
+    * connection.
+    */
+   void HashTableServer::onReadable(Connection& conn) {
+      ssize_t got = ::recv(conn.fd, readBuffer.get(), READ_CHUNK, 0);
+      if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+      if (got <= 0) {
+         closeConnection(conn);
+         return;
+      }
+      std::string_view input(readBuffer.get(), static_cast<size_t>(got));
+      if (!conn.in.empty()) {
+         if (conn.in.size() + input.size() > m_queryBufferLimit) {
+            ++m_counters.queryBufferCloses;
+            closeConnection(conn);
+            return;
+         }
+         conn.in.append(input);
+         input = conn.in;
+      }
+      const size_t used = execute(conn, input);
+      if (conn.in.empty()) conn.in.assign(input.substr(used));
+      else conn.in.erase(0, used);
+      flush(conn);
+   }
+
+   /*
+    * Run the requests in input, appending their replies to conn.out, and
+    * return the bytes they took.  Consecutive reads go through
+    * executeReads() together.  QUIT stops the requests after it; a protocol
+    * error is answered after the requests before it, and the connection is
+    * closed once the replies are sent.
+    */
+   size_t HashTableServer::execute(Connection& conn, std::string_view input) {
+      batch.clear();
+      const size_t used = HashTableResp::parse(input, batch, &conn.parsed);
+      for (size_t c = 0; c < batch.commands.size() && !conn.closing;) {
+         std::span<const std::string_view> args = batch.argsOf(batch.commands[c]);
+         if (isRead(args)) {
+            c = executeReads(conn, c);
+         } else {
+            executeCommand(conn, args);
+            ++m_counters.commands;
+            ++c;
+         }
+      }
+      if (batch.error && !conn.closing) {
+         HashTableResp::appendError(conn.out, std::string("ERR ") + batch.error);
+         ++m_counters.protocolErrors;
+         conn.closing = true;
+      }
+      return used;
+   }
+
+   /*
+    * Reply to the run of read commands starting at batch.commands[first] and
+    * return the index after it.  Every key of the run is looked up first, in
+    * one findBatch call, then the replies are written from the results.
+    */
+   size_t HashTableServer::executeReads(Connection& conn, size_t first) {
+      lookupKeys.clear();
+      size_t end = first;
+      for (; end < batch.commands.size(); ++end) {
+         std::span<const std::string_view> args = batch.argsOf(batch.commands[end]);
+         if (!isRead(args)) break;
+         lookupKeys.insert(lookupKeys.end(), args.begin() + 1, args.end());
+      }
+      lookupValues.resize(lookupKeys.size());
+      const auto& table = store;
+      if (m_batchLookups) {
+         table.findBatch(lookupKeys, lookupValues);
+         ++m_counters.lookupBatches;
+      } else {
+         for (size_t i = 0; i < lookupKeys.size(); ++i) lookupValues[i] = table.find(lookupKeys[i]);
+      }
+      m_counters.lookups += lookupKeys.size();
+      m_counters.commands += end - first;
+
+      const std::string* const* value = lookupValues.data();
+      for (size_t c = first; c < end; ++c) {
+         std::span<const std::string_view> args = batch.argsOf(batch.commands[c]);
+         const size_t keys = args.size() - 1;
+         if (commandIs(args[0], "GET")) {
+            appendValue(conn.out, *value++);
+         } else if (commandIs(args[0], "MGET")) {
+            HashTableResp::appendArray(conn.out, keys);
+            for (size_t k = 0; k < keys; ++k) appendValue(conn.out, *value++);
+         } else {
+            int64_t found = 0;
+            for (size_t k = 0; k < keys; ++k) found += *value++ != nullptr;
+            HashTableResp::appendInteger(conn.out, found);
+         }
+      }
+      return end;
+   }
+
+   // Every command other than a well-formed read, in request order
+   void HashTableServer::executeCommand(Connection& conn, std::span<const std::string_view> args) {
+      const std::string_view name = args[0];
+      if (commandIs(name, "SET")) {
+         if (args.size() < 3) {
+            appendArityError(conn.out, name);
+         } else if (args.size() > 3) {
+            HashTableResp::appendError(conn.out, "ERR syntax error"); // no EX / NX / ... options
+         } else {
+            store[args[1]].assign(args[2]);
+            HashTableResp::appendSimple(conn.out, "OK");
+         }
+      } else if (commandIs(name, "DEL")) {
+         if (args.size() < 2) {
+            appendArityError(conn.out, name);
+            return;
+         }
+         int64_t removed = 0;
+         for (size_t k = 1; k < args.size(); ++k) removed += store.remove(args[k]);
+         HashTableResp::appendInteger(conn.out, removed);
+      } else if (commandIs(name, "PING")) {
+         if (args.size() == 1) HashTableResp::appendSimple(conn.out, "PONG");
+         else if (args.size() == 2) HashTableResp::appendBulk(conn.out, args[1]);
+         else appendArityError(conn.out, name);
+      } else if (commandIs(name, "QUIT")) {
+         HashTableResp::appendSimple(conn.out, "OK");
+         conn.closing = true;
+      } else if (commandIs(name, "COMMAND")) {
+         HashTableResp::appendArray(conn.out, 0); // redis-cli asks for the command table on connect
+      } else if (commandIs(name, "GET") || commandIs(name, "MGET") || commandIs(name, "EXISTS")) {
+         appendArityError(conn.out, name);
+      } else {
+         HashTableResp::appendError(conn.out, "ERR unknown command '" + std::string(name) + "'");
+      }
+   }
+
+   /*
+    * Send as much of conn.out as the socket takes.  If some is left the
+    * connection waits on EPOLLOUT alone, so no more requests are read from
+    * it until its replies drain; once they do it goes back to EPOLLIN, or is
+    * closed if it was closing.
+    */
+   void HashTableServer::flush(Connection& conn) {
+      while (conn.outStart < conn.out.size()) {
+         ssize_t sent = ::send(conn.fd, conn.out.data() + conn.outStart, conn.out.size() - conn.outStart, MSG_NOSIGNAL);
+         if (sent > 0) {
+            conn.outStart += static_cast<size_t>(sent);
+         } else if (sent < 0 && errno == EINTR) {
+            continue;
+         } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watch(conn, true);
+            return;
+         } else {
+            closeConnection(conn);
+            return;
+         }
+      }
+      conn.out.clear();
+      conn.outStart = 0;
+      if (conn.closing) {
+         closeConnection(conn);
+         return;
+      }
+      watch(conn, false);
+   }
+
+   void HashTableServer::watch(Connection& conn, bool writing) {
+      if (conn.writing == writing) return;
+      epoll_event event{};
+      event.events = writing ? EPOLLOUT : EPOLLIN;
+      event.data.fd = conn.fd;
+      ::epoll_ctl(epollFd, EPOLL_CTL_MOD, conn.fd, &event);
+      conn.writing = writing;
+   }
+
+   // Destroys conn; callers return without touching it again
+   void HashTableServer::closeConnection(Connection& conn) {
+      const int fd = conn.fd;
+      ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+      ::close(fd);
+      connections[fd].reset();
+   }
+
+}
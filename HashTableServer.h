@@ -0,0 +1,127 @@
+/*
+// HashTableServer.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// A single-threaded key-value server in front of a PayloadHashTable<string>,
+// speaking the RESP subset in HashTableResp (GET, SET, DEL, EXISTS, MGET, plus
+// PING, QUIT and COMMAND so redis-cli and redis-benchmark can connect).  It
+// listens on a Unix-domain socket or on loopback TCP and multiplexes its
+// clients with one level-triggered epoll loop:
+// - each readable event takes up to READ_CHUNK bytes and parses every
+//   complete request in them, so a pipelining client's requests are handled
+//   together and answered with one send()
+// - within that group, consecutive reads (GET / MGET / EXISTS) have all their
+//   keys resolved through one PayloadHashTable::findBatch call, overlapping
+//   the table's cache misses; writes run one at a time, in order, so replies
+//   still see every earlier write
+// - a client that stops reading its replies is only watched for EPOLLOUT
+//   until its backlog drains, so it cannot make the server buffer without
+//   bound
+// - a request split across reads is kept in the connection with its parse
+//   progress, so each read only parses the bytes that are new; a client whose
+//   unfinished request grows past the query buffer limit is disconnected, like
+//   Redis's client-query-buffer-limit
+// stop() may be called from another thread or a signal handler.
+// Actionable members include:
+// - listenUnix / listenTcp - open the listening socket (loopback only)
+// - run - serve until stop() is called
+// - stop - wake run() and make it return
+// - setBatchLookups - turn the findBatch path off, for comparison
+// - setQueryBufferLimit - most bytes a client's unfinished request may hold
+// - counters - connections, commands, lookups and protocol errors so far
+// - size - keys stored
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLESERVER_H
+#define PROJECT4_HASHTABLE_HASHTABLESERVER_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "HashTableResp.h"
+#include "PayloadHashTable.h"
+
+namespace std {
+
+    class HashTableServer {
+    public:
+        static constexpr size_t READ_CHUNK = size_t{64} << 10; // bytes taken per readable event
+        static constexpr int MAX_EVENTS = 64;                  // epoll events handled per wakeup
+        static constexpr size_t DEFAULT_QUERY_BUFFER = size_t{1} << 30; // as Redis's client-query-buffer-limit
+
+        struct Counters {
+            uint64_t connections = 0;
+            uint64_t commands = 0;
+            uint64_t lookups = 0;        // keys read by GET / MGET / EXISTS
+            uint64_t lookupBatches = 0;  // findBatch calls those keys went through
+            uint64_t protocolErrors = 0;
+            uint64_t queryBufferCloses = 0; // clients dropped for passing the query buffer limit
+        };
+
+        explicit HashTableServer(size_t expectedKeys = 0);
+        ~HashTableServer();
+        HashTableServer(const HashTableServer&) = delete;
+        HashTableServer& operator=(const HashTableServer&) = delete;
+
+        bool listenUnix(const std::string& path);
+        bool listenTcp(uint16_t port);
+        uint16_t port() const;
+
+        bool run();
+        void stop();
+
+        void setBatchLookups(bool on);
+        void setQueryBufferLimit(size_t bytes);
+        Counters counters() const;
+        size_t size() const;
+
+    private:
+        struct Connection {
+            int fd;
+            std::string in;      // start of a request still arriving
+            HashTableResp::Resume parsed; // how far parsing of in got
+            std::string out;
+            size_t outStart = 0; // first byte of out not yet sent
+            bool writing = false; // waiting on EPOLLOUT for out to drain
+            bool closing = false; // close once out has drained
+        };
+
+        PayloadHashTable<std::string> store;
+        int epollFd = -1;
+        int wakeFd = -1;
+        int listenFd = -1;
+        bool tcp = false;
+        uint16_t m_port = 0;
+        std::string unixPath;
+        bool m_batchLookups = true;
+        size_t m_queryBufferLimit = DEFAULT_QUERY_BUFFER;
+        Counters m_counters;
+        std::vector<std::unique_ptr<Connection>> connections; // indexed by fd
+
+        // Reused from read to read
+        std::unique_ptr<char[]> readBuffer;
+        HashTableResp::Batch batch;
+        std::vector<std::string_view> lookupKeys;
+        std::vector<const std::string*> lookupValues;
+
+        bool startListening(int fd);
+        void acceptAll();
+        void onReadable(Connection& conn);
+        size_t execute(Connection& conn, std::string_view input);
+        size_t executeReads(Connection& conn, size_t first);
+        void executeCommand(Connection& conn, std::span<const std::string_view> args);
+        void flush(Connection& conn);
+        void watch(Connection& conn, bool writing);
+        void closeConnection(Connection& conn);
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLESERVER_H
@@ -0,0 +1,67 @@
+/** HashTableServerMain.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Runs a HashTableServer until SIGINT or SIGTERM.  Listens on loopback TCP
+ *  port 6380 unless told otherwise (one above Redis, so both can run).
+ *
+ *  Usage: HashTableServer [--unix PATH | --port N] [--reserve KEYS] [--no-batch]
+**/
+
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include "HashTableServer.h"
+
+using namespace std;
+
+static HashTableServer* running = nullptr;
+
+static void onSignal(int) {
+    if (running) running->stop();
+}
+
+int main(int argc, char** argv) {
+    string unixPath;
+    uint16_t port = 6380;
+    size_t reserveKeys = 0;
+    bool batchLookups = true;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--unix" && i + 1 < argc) unixPath = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) port = static_cast<uint16_t>(stoul(argv[++i]));
+        else if (arg == "--reserve" && i + 1 < argc) reserveKeys = static_cast<size_t>(stod(argv[++i]));
+        else if (arg == "--no-batch") batchLookups = false;
+        else {
+            fprintf(stderr, "Usage: %s [--unix PATH | --port N] [--reserve KEYS] [--no-batch]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    HashTableServer server(reserveKeys);
+    server.setBatchLookups(batchLookups);
+    if (!unixPath.empty() ? !server.listenUnix(unixPath) : !server.listenTcp(port)) {
+        perror("listen");
+        return 1;
+    }
+    if (!unixPath.empty()) fprintf(stderr, "listening on %s\n", unixPath.c_str());
+    else fprintf(stderr, "listening on 127.0.0.1:%u\n", static_cast<unsigned>(server.port()));
+
+    running = &server;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    bool ok = server.run();
+    running = nullptr;
+
+    HashTableServer::Counters counters = server.counters();
+    fprintf(stderr, "%zu keys; %llu connections, %llu commands, %llu lookups in %llu batches, %llu protocol errors\n",
+            server.size(), static_cast<unsigned long long>(counters.connections),
+            static_cast<unsigned long long>(counters.commands), static_cast<unsigned long long>(counters.lookups),
+            static_cast<unsigned long long>(counters.lookupBatches),
+            static_cast<unsigned long long>(counters.protocolErrors));
+    return ok ? 0 : 1;
+}
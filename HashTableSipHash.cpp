@@ -0,0 +1,81 @@
+/*
+// HashTableSipHash.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// SipHash (Aumasson and Bernstein, 2012) over little-endian 8-byte words.
+*/
+
+#include "HashTableSipHash.h"
+#include <bit>
+#include <cstring>
+#include <random>
+
+namespace std {
+
+   static inline void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+      v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+      v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+      v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+      v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+   }
+
+   // Word at p as stored on a little-endian machine
+   static inline uint64_t loadWord(const char* p) {
+      uint64_t word;
+      std::memcpy(&word, p, sizeof(word));
+      if constexpr (std::endian::native == std::endian::big) word = __builtin_bswap64(word);
+      return word;
+   }
+
+   HashTableSipHash HashTableSipHash::random() {
+      std::random_device device;
+      auto draw = [&] { return (static_cast<uint64_t>(device()) << 32) | device(); };
+      uint64_t key0 = draw();
+      return HashTableSipHash(key0, draw());
+   }
+
+   /*
+    * Each whole 8-byte word is xored into v3, mixed, then into v0.  The last
+    * 0-7 bytes go into a final word whose top byte is the length mod 256.
+    */
+   template<int CompressionRounds, int FinalRounds>
+   uint64_t HashTableSipHash::run(std::string_view key) const {
+      uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+      uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+      uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+      uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+
+      const char* p = key.data();
+      const size_t words = key.size() / 8;
+      auto absorb = [&](uint64_t m) {
+         v3 ^= m;
+         for (int r = 0; r < CompressionRounds; ++r) sipRound(v0, v1, v2, v3);
+         v0 ^= m;
+      };
+      for (size_t w = 0; w < words; ++w) absorb(loadWord(p + 8 * w));
+
+      uint64_t last = static_cast<uint64_t>(key.size()) << 56;
+      const size_t tail = key.size() % 8;
+      for (size_t b = 0; b < tail; ++b) {
+         last |= static_cast<uint64_t>(static_cast<unsigned char>(p[8 * words + b])) << (8 * b);
+      }
+      absorb(last);
+
+      v2 ^= 0xff;
+      for (int r = 0; r < FinalRounds; ++r) sipRound(v0, v1, v2, v3);
+      return v0 ^ v1 ^ v2 ^ v3;
+   }
+
+   uint64_t HashTableSipHash::hash(std::string_view key) const {
+      return run<1, 3>(key);
+   }
+
+   uint64_t HashTableSipHash::hash24(std::string_view key) const {
+      return run<2, 4>(key);
+   }
+
+}
@@ -0,0 +1,48 @@
+/*
+// HashTableSipHash.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Keyed SipHash for HashTable's flood defence.  std::hash is the same in
+// every process, so someone who picks the keys can search offline for keys
+// that share a home slot.  SipHash mixes a secret 128-bit key into every
+// hash, so without that key such collisions can't be found ahead of time.
+// hash() is SipHash-1-3 (one round per 8-byte word, three to finish), the
+// variant hash tables commonly use.  hash24() is full SipHash-2-4, which
+// has published test vectors that check the round function.
+// Actionable members include:
+// - random - a hasher keyed from std::random_device
+// - hash - SipHash-1-3 of a key
+// - hash24 - SipHash-2-4 of a key
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLESIPHASH_H
+#define PROJECT4_HASHTABLE_HASHTABLESIPHASH_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace std {
+
+    class HashTableSipHash {
+    private:
+        uint64_t k0;
+        uint64_t k1;
+
+        template<int CompressionRounds, int FinalRounds>
+        uint64_t run(std::string_view key) const;
+
+    public:
+        explicit HashTableSipHash(uint64_t key0 = 0, uint64_t key1 = 0) : k0(key0), k1(key1) {}
+
+        static HashTableSipHash random();
+
+        uint64_t hash(std::string_view key) const;
+        uint64_t hash24(std::string_view key) const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLESIPHASH_H
@@ -0,0 +1,185 @@
+/*
+// HashTableStats.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Exporters for the HashTableStats snapshot: a JSON object and the Prometheus
+// text exposition format (counters, gauges and cumulative histograms).
+*/
+
+#include "HashTableStats.h"
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace std {
+
+   // Write one histogram array as a JSON list of {"le": bound, "count": n}
+   static void histogramJSON(std::ostringstream& out, const std::array<uint64_t, HashTableStats::PROBE_BUCKETS>& h) {
+      out << "[";
+      for (size_t b = 0; b < h.size(); ++b) {
+         if (b > 0) out << ", ";
+         out << "{\"le\": ";
+         if (b + 1 == h.size()) out << "\"+Inf\"";
+         else out << HashTableStats::probeBucketBound(b);
+         out << ", \"count\": " << h[b] << "}";
+      }
+      out << "]";
+   }
+
+   // Write one histogram in Prometheus form: cumulative _bucket series, _sum and _count
+   static void histogramPrometheus(std::ostringstream& out, const std::string& name, const std::string& help,
+                                   const std::array<uint64_t, HashTableStats::PROBE_BUCKETS>& h, uint64_t sum) {
+      out << "# HELP " << name << " " << help << "\n";
+      out << "# TYPE " << name << " histogram\n";
+      uint64_t cumulative = 0;
+      for (size_t b = 0; b < h.size(); ++b) {
+         cumulative += h[b];
+         out << name << "_bucket{le=\"";
+         if (b + 1 == h.size()) out << "+Inf";
+         else out << HashTableStats::probeBucketBound(b);
+         out << "\"} " << cumulative << "\n";
+      }
+      out << name << "_sum " << sum << "\n";
+      out << name << "_count " << cumulative << "\n";
+   }
+
+   // Write one counter or gauge.  Counts are written as integers, so they stay
+   // exact past the 6 significant digits of the stream's default format
+   static void metric(std::ostringstream& out, const std::string& name, const char* type, const char* help,
+                      uint64_t value) {
+      out << "# HELP " << name << " " << help << "\n";
+      out << "# TYPE " << name << " " << type << "\n";
+      out << name << " " << value << "\n";
+   }
+
+   // Ratios and durations: enough digits to read the double back unchanged
+   static void metric(std::ostringstream& out, const std::string& name, const char* type, const char* help,
+                      double value) {
+      out << "# HELP " << name << " " << help << "\n";
+      out << "# TYPE " << name << " " << type << "\n";
+      out << name << " " << std::setprecision(std::numeric_limits<double>::max_digits10) << value
+          << std::setprecision(6) << "\n";
+   }
+
+   std::string HashTableStats::toJSON() const {
+      std::ostringstream out;
+      out << "{\n";
+      out << "  \"enabled\": " << (enabled ? "true" : "false") << ",\n";
+      out << "  \"size\": " << size << ",\n";
+      out << "  \"capacity\": " << capacity << ",\n";
+      out << "  \"tombstones\": " << tombstones << ",\n";
+      out << "  \"load_factor\": " << loadFactor << ",\n";
+      out << "  \"cache\": {"
+          << "\"enabled\": " << (cacheMode ? "true" : "false") << ", "
+          << "\"max_entries\": " << cacheMaxEntries << ", "
+          << "\"max_bytes\": " << cacheMaxBytes << ", "
+          << "\"bytes\": " << cacheBytes << ", "
+          << "\"hits\": " << cacheHits << ", "
+          << "\"misses\": " << cacheMisses << ", "
+          << "\"evictions\": " << evictions << ", "
+          << "\"compactions\": " << compactions << "},\n";
+      out << "  \"expirations\": " << expirations << ",\n";
+      out << "  \"ttl_timers\": " << ttlTimers << ",\n";
+      out << "  \"bloom\": {"
+          << "\"bits_per_key\": " << bloomBitsPerKey << ", "
+          << "\"bytes\": " << bloomBytes << ", "
+          << "\"rejects\": " << bloomRejects << ", "
+          << "\"rebuilds\": " << bloomRebuilds << "},\n";
+      out << "  \"hash\": {"
+          << "\"keyed\": " << (keyedHash ? "true" : "false") << ", "
+          << "\"reseeds\": " << hashReseeds << "},\n";
+      out << "  \"memory\": {"
+          << "\"bytes\": " << memoryBytes << ", "
+          << "\"budget\": " << memoryBudget << ", "
+          << "\"rejects\": " << budgetRejects << "},\n";
+      out << "  \"max_probe\": " << maxProbe << ",\n";
+      out << "  \"hit_probe_sum\": " << hitProbeTotal << ",\n";
+      out << "  \"miss_probe_sum\": " << missProbeTotal << ",\n";
+      out << "  \"hit_probes\": ";
+      histogramJSON(out, hitProbes);
+      out << ",\n  \"miss_probes\": ";
+      histogramJSON(out, missProbes);
+      out << ",\n";
+      out << "  \"resizes\": " << resizes << ",\n";
+      out << "  \"resize_seconds\": " << static_cast<double>(resizeNanos) / 1e9 << ",\n";
+      out << "  \"ops\": {"
+          << "\"insert\": " << inserts << ", "
+          << "\"insert_rejected\": " << insertRejects << ", "
+          << "\"remove\": " << removes << ", "
+          << "\"remove_missing\": " << removeMisses << ", "
+          << "\"get_hit\": " << getHits << ", "
+          << "\"get_miss\": " << getMisses << ", "
+          << "\"bracket_hit\": " << bracketHits << ", "
+          << "\"bracket_insert\": " << bracketInserts << "}\n";
+      out << "}\n";
+      return out.str();
+   }
+
+   std::string HashTableStats::toPrometheus(std::string_view prefix) const {
+      std::ostringstream out;
+      std::string p(prefix);
+
+      metric(out, p + "_size", "gauge", "Entries currently stored.", static_cast<uint64_t>(size));
+      metric(out, p + "_capacity", "gauge", "Bucket slots allocated.", static_cast<uint64_t>(capacity));
+      metric(out, p + "_tombstones", "gauge", "Buckets in the EAR (empty after removal) state.",
+             static_cast<uint64_t>(tombstones));
+      metric(out, p + "_load_factor", "gauge", "size / capacity.", loadFactor);
+      if (cacheMode) {
+         metric(out, p + "_cache_bytes", "gauge", "Key and value bytes counted against the cache budget.",
+                static_cast<uint64_t>(cacheBytes));
+         metric(out, p + "_cache_hits_total", "counter", "Cache lookups that found their key.", cacheHits);
+         metric(out, p + "_cache_misses_total", "counter", "Cache lookups that missed.", cacheMisses);
+         metric(out, p + "_cache_evictions_total", "counter", "Entries evicted to stay within budget.", evictions);
+         metric(out, p + "_cache_compactions_total", "counter", "Rehashes run to clear eviction tombstones.",
+                compactions);
+      }
+      metric(out, p + "_expirations_total", "counter", "Entries reclaimed after their TTL ran out.", expirations);
+      metric(out, p + "_ttl_timers", "gauge", "TTL timers waiting in the timer wheel.",
+             static_cast<uint64_t>(ttlTimers));
+      if (bloomBitsPerKey > 0) {
+         metric(out, p + "_bloom_bytes", "gauge", "Bytes held by the Bloom filter.", static_cast<uint64_t>(bloomBytes));
+         metric(out, p + "_bloom_rejects_total", "counter", "Lookups answered as misses by the Bloom filter.",
+                bloomRejects);
+         metric(out, p + "_bloom_rebuilds_total", "counter", "Times the Bloom filter was rebuilt.", bloomRebuilds);
+      }
+      metric(out, p + "_hash_reseeds_total", "counter", "Switches to a newly keyed hash after a collision flood.",
+             hashReseeds);
+      metric(out, p + "_memory_bytes", "gauge", "Bytes held by buckets, offsets, Bloom filter and keys.",
+             static_cast<uint64_t>(memoryBytes));
+      if (memoryBudget > 0) {
+         metric(out, p + "_memory_budget_bytes", "gauge", "Memory budget on those bytes.",
+                static_cast<uint64_t>(memoryBudget));
+         metric(out, p + "_memory_budget_rejects_total", "counter", "New keys refused for lack of budget.",
+                budgetRejects);
+      }
+      if (!enabled) {
+         return out.str();
+      }
+
+      metric(out, p + "_max_probe", "gauge", "Longest probe sequence observed.", maxProbe);
+      histogramPrometheus(out, p + "_hit_probe_length", "Probe length of successful lookups.", hitProbes,
+                          hitProbeTotal);
+      histogramPrometheus(out, p + "_miss_probe_length", "Probe length of unsuccessful lookups.", missProbes,
+                          missProbeTotal);
+      metric(out, p + "_resizes_total", "counter", "Resizes performed.", resizes);
+      metric(out, p + "_resize_seconds_total", "counter", "Time spent resizing.",
+             static_cast<double>(resizeNanos) / 1e9);
+
+      out << "# HELP " << p << "_operations_total Operations by type and outcome.\n";
+      out << "# TYPE " << p << "_operations_total counter\n";
+      out << p << "_operations_total{op=\"insert\",result=\"ok\"} " << inserts << "\n";
+      out << p << "_operations_total{op=\"insert\",result=\"rejected\"} " << insertRejects << "\n";
+      out << p << "_operations_total{op=\"remove\",result=\"ok\"} " << removes << "\n";
+      out << p << "_operations_total{op=\"remove\",result=\"missing\"} " << removeMisses << "\n";
+      out << p << "_operations_total{op=\"get\",result=\"hit\"} " << getHits << "\n";
+      out << p << "_operations_total{op=\"get\",result=\"miss\"} " << getMisses << "\n";
+      out << p << "_operations_total{op=\"bracket\",result=\"hit\"} " << bracketHits << "\n";
+      out << p << "_operations_total{op=\"bracket\",result=\"insert\"} " << bracketInserts << "\n";
+      return out.str();
+   }
+
+}
@@ -0,0 +1,129 @@
+/*
+// HashTableStats.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Opt-in statistics block for HashTable.  Recording is compiled in only when
+// HASHTABLE_STATS is defined; otherwise every HASHTABLE_STAT(...) site expands
+// to nothing and HashTable::stats() reports just the always-known figures
+// (size, capacity, tombstones), the cache mode counters, TTL expiry, the
+// Bloom filter counters, the hash flood reseeds and the memory budget.
+// Probe lengths are counted in slots past the home slot: 0 means the key was
+// found (or ruled out) at its home index.  Histogram bucket b holds lengths in
+// [2^(b-1), 2^b - 1], with bucket 0 holding exactly 0 and the last bucket
+// holding everything longer.
+// Actionable members include:
+// - recordHit / recordMiss - add one lookup's probe length to a histogram
+// - toJSON - JSON object for dashboards and dumps
+// - toPrometheus - Prometheus text exposition format for scraping
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLESTATS_H
+#define PROJECT4_HASHTABLE_HASHTABLESTATS_H
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef HASHTABLE_STATS
+#define HASHTABLE_STAT(stmt) do { stmt; } while (0)
+#else
+#define HASHTABLE_STAT(stmt) do { } while (0)
+#endif
+
+namespace std {
+
+    struct HashTableStats {
+        static constexpr size_t PROBE_BUCKETS = 12;
+
+        bool enabled = false;
+
+        // Table shape at snapshot time
+        size_t size = 0;
+        size_t capacity = 0;
+        size_t tombstones = 0;
+        double loadFactor = 0.0;
+
+        // Cache mode budget and counters; always kept, whatever the build
+        bool cacheMode = false;
+        size_t cacheMaxEntries = 0;
+        size_t cacheMaxBytes = 0;
+        size_t cacheBytes = 0;
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+        uint64_t evictions = 0;
+        uint64_t compactions = 0;
+
+        // TTL expiry; always kept
+        uint64_t expirations = 0;
+        size_t ttlTimers = 0;
+
+        // Bloom filter in front of lookups; always kept (bitsPerKey 0 = no filter)
+        size_t bloomBitsPerKey = 0;
+        size_t bloomBytes = 0;
+        uint64_t bloomRejects = 0;
+        uint64_t bloomRebuilds = 0;
+
+        // Hash flood defence; always kept (keyedHash = switched to SipHash)
+        bool keyedHash = false;
+        uint64_t hashReseeds = 0;
+
+        // Memory budget; always kept (memoryBytes is what the budget covers, budget 0 = none)
+        size_t memoryBytes = 0;
+        size_t memoryBudget = 0;
+        uint64_t budgetRejects = 0;
+
+        // Probe-length histograms for successful and unsuccessful lookups
+        std::array<uint64_t, PROBE_BUCKETS> hitProbes{};
+        std::array<uint64_t, PROBE_BUCKETS> missProbes{};
+        uint64_t hitProbeTotal = 0;
+        uint64_t missProbeTotal = 0;
+        uint64_t maxProbe = 0;
+
+        // Resize activity
+        uint64_t resizes = 0;
+        uint64_t resizeNanos = 0;
+
+        // Per-operation counters
+        uint64_t inserts = 0;
+        uint64_t insertRejects = 0;
+        uint64_t removes = 0;
+        uint64_t removeMisses = 0;
+        uint64_t getHits = 0;
+        uint64_t getMisses = 0;
+        uint64_t bracketHits = 0;
+        uint64_t bracketInserts = 0;
+
+        static constexpr size_t probeBucket(size_t probes) {
+            size_t b = static_cast<size_t>(std::bit_width(probes));
+            return b < PROBE_BUCKETS ? b : PROBE_BUCKETS - 1;
+        }
+
+        // Largest probe length counted by bucket b (the last bucket is unbounded)
+        static constexpr uint64_t probeBucketBound(size_t b) {
+            return (uint64_t{1} << b) - 1;
+        }
+
+        void recordHit(size_t probes) {
+            ++hitProbes[probeBucket(probes)];
+            hitProbeTotal += probes;
+            if (probes > maxProbe) maxProbe = probes;
+        }
+
+        void recordMiss(size_t probes) {
+            ++missProbes[probeBucket(probes)];
+            missProbeTotal += probes;
+            if (probes > maxProbe) maxProbe = probes;
+        }
+
+        std::string toJSON() const;
+        std::string toPrometheus(std::string_view prefix = "hashtable") const;
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLESTATS_H
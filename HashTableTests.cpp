@@ -20,6 +20,13 @@
 #include <type_traits>
 #include <optional>
 #include <string>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <random>
+#include <thread>
 
 using namespace std;
 
@@ -38,6 +45,17 @@ using HashTable = HashTable_t<key_type, value_type>;
 #else
 #include "HashTable.h" // Must match key_type/value_type of the tested HashTable
 #endif
+#include "PayloadHashTable.h"
+#include "FrozenHashTable.h"
+#include "ConstHashTable.h"
+#include "CuckooHashTable.h"
+#include "ChainedHashTable.h"
+#include "ConcurrentCounterTable.h"
+#include "SharedHashTable.h"
+#include "HashTableServer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 // -----------------------------------------------------------------------------
 /** Helpers: make_key / make_value
@@ -100,6 +118,31 @@ const string evalName{""};
 #define HT_ALPHA
 #define HT_CAPACITY
 #define HT_SIZE
+#define HT_LOG
+#define HT_PAYLOAD
+#define HT_ITERATORS
+#define HT_CACHE
+#define HT_TTL
+#define HT_BLOOM
+#define HT_BATCH
+#define HT_SETOPS
+#define HT_REOPTIMIZE
+#define HT_HASHFLOOD
+#define HT_INDEX_BITS
+#define HT_KEY_COMPARE
+#define HT_TRACE
+#define HT_MEMORY
+#define HT_REPLICATION
+#define HT_FROZEN
+#define HT_CONST
+#define HT_CUCKOO
+#define HT_CHAINED
+#define HT_COUNTER
+#define HT_SHARED
+#define HT_SERVER
+#ifdef HASHTABLE_STATS
+#define HT_STATS
+#endif
 
 // -----------------------------------------------------------------------------
 // Main
@@ -707,6 +750,1738 @@ int main(int, char**) {
     OUTSTREAM << "*** DID NOT TEST SIZE ***" << endl << endl;
 #endif
 
+    // =====================================================================
+    // WRITE-AHEAD LOG (group commit, snapshot + replay recovery)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable write-ahead log and recovery" << endl;
+    OUTSTREAM << "----------------------------------------------" << endl << endl;
+#ifdef HT_LOG
+    try {
+        const string logPath = "hashtable_test.log";
+        const string snapPath = "hashtable_test.snapshot";
+        std::remove(logPath.c_str());
+        std::remove(snapPath.c_str());
+        bool ok = true;
+
+        {
+            HashTable ht1;
+            HashTableLog wal(logPath, SyncPolicy::EVERY_OP, 4);
+            ht1.attachLog(&wal);
+
+            OUTSTREAM << "Step 1: Insert " << MAXHASH << " entries with group size 4..." << endl;
+            for (size_t i = 1; i <= MAXHASH; i++)
+                ht1.insert(make_key<key_type>(i), make_value<value_type>(i));
+            OUTSTREAM << "  commits so far = " << wal.commits() << endl;
+
+            OUTSTREAM << "Step 2: Checkpoint to snapshot, then remove one key and update another..." << endl;
+            ok &= ht1.checkpoint(snapPath);
+            ht1.remove(make_key<key_type>(1));
+            ht1[make_key<key_type>(2)] = make_value<value_type>(42);
+            ok &= ht1.syncLog();
+            ht1.attachLog(nullptr);
+        }
+
+        OUTSTREAM << "Step 3: Recover a fresh table from snapshot + log..." << endl;
+        HashTable ht1;
+        size_t replayed = ht1.recover(snapPath, logPath);
+        OUTSTREAM << "  replayed " << replayed << " log records, size() = " << ht1.size() << endl;
+
+        ok &= (ht1.size() == MAXHASH - 1);
+        ok &= !ht1.contains(make_key<key_type>(1));
+        ok &= (ht1.get(make_key<key_type>(2)) == make_value<value_type>(42));
+        for (size_t i = 3; i <= MAXHASH; i++)
+            ok &= (ht1.get(make_key<key_type>(i)) == make_value<value_type>(i));
+
+        OUTSTREAM << "Step 4: 1000 operator[] increments over 100 keys with group size 1, then drop the table attached..." << endl;
+        std::remove(logPath.c_str());
+        size_t counterCommits = 0;
+        {
+            HashTableLog wal(logPath, SyncPolicy::EVERY_OP, 1);
+            HashTable counters;
+            counters.attachLog(&wal);
+            for (size_t i = 0; i < 1000; i++)
+                counters["counter" + to_string(i % 100)] += 1;
+            counterCommits = wal.commits();
+        }
+        HashTable ht2;
+        replayed = ht2.recover("", logPath);
+        OUTSTREAM << "  commits = " << counterCommits << ", replayed " << replayed
+                  << " log records, size() = " << ht2.size() << endl;
+        ok &= (counterCommits >= 999);
+        ok &= (ht2.size() == 100);
+        for (size_t i = 0; i < 100; i++)
+            ok &= (ht2.get("counter" + to_string(i)) == size_t{10});
+
+        OUTSTREAM << "Step 5: Move a table with the log attached, drop the source, keep writing through the move..." << endl;
+        std::remove(logPath.c_str());
+        {
+            HashTableLog* wal = new HashTableLog(logPath, SyncPolicy::EVERY_OP, 1);
+            HashTable* source = new HashTable;
+            source->attachLog(wal);
+            source->insert("moved-a", 1);
+            HashTable moved(std::move(*source));
+            delete source;
+            moved.insert("moved-b", 2);
+            ok &= moved.syncLog();
+
+            OUTSTREAM << "Step 6: A copy starts with no log; its writes stay out of the WAL..." << endl;
+            HashTable copy(moved);
+            copy.insert("copy-only", 3);
+            ok &= !copy.syncLog() && copy.size() == 3;
+
+            delete wal;
+            moved.insert("moved-c", 4); // log detached itself; nothing left to append to
+        }
+        HashTable ht3;
+        replayed = ht3.recover("", logPath);
+        OUTSTREAM << "  replayed " << replayed << " log records, size() = " << ht3.size() << endl;
+        ok &= (ht3.size() == 2 && ht3.get("moved-a") == size_t{1} && ht3.get("moved-b") == size_t{2});
+        ok &= !ht3.contains("copy-only");
+
+        OUTSTREAM << "Step 7: Tear the log tail, recover, log one more insert, recover again..." << endl;
+        {
+            std::ofstream torn(logPath, std::ios::binary | std::ios::app);
+            torn << "\x01\x02\x03torn";
+        }
+        {
+            HashTable ht4;
+            ht4.recover("", logPath);
+            HashTableLog wal(logPath, SyncPolicy::EVERY_OP, 1);
+            ht4.attachLog(&wal);
+            ht4.insert("after-torn", 5);
+            ok &= ht4.syncLog();
+            ht4.attachLog(nullptr);
+        }
+        HashTable ht5;
+        replayed = ht5.recover("", logPath);
+        OUTSTREAM << "  replayed " << replayed << " log records, size() = " << ht5.size() << endl;
+        ok &= (ht5.size() == 3 && ht5.contains("after-torn") && ht5.get("moved-b") == size_t{2});
+
+        OUTSTREAM << "Step 8: Reject snapshots whose count or key length runs past the end of the file..." << endl;
+        for (uint64_t count : {uint64_t{1} << 40, uint64_t{1}}) {
+            std::ofstream corrupt(snapPath, std::ios::binary | std::ios::trunc);
+            uint32_t len = 0xFFFFFFF0u;
+            corrupt.write("HTSNAP01", 8);
+            corrupt.write(reinterpret_cast<const char *>(&count), sizeof(count));
+            corrupt.write(reinterpret_cast<const char *>(&len), sizeof(len));
+            corrupt.write("key-and-value", 13);
+            corrupt.close();
+            HashTable ht6;
+            ok &= !ht6.loadSnapshot(snapPath) && ht6.size() == 0;
+        }
+
+        OUTSTREAM << (ok ? "SUCCESS: recovered table matches the state before the crash."
+                         : "FAILURE: recovered table differs from the logged state.")
+                  << endl << endl;
+        std::remove(logPath.c_str());
+        std::remove(snapPath.c_str());
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST LOG ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // ITERATORS AND CURSOR SCAN
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable iterators and scan() cursor" << endl;
+    OUTSTREAM << "---------------------------------------------" << endl << endl;
+#ifdef HT_ITERATORS
+    try {
+        static_assert(std::forward_iterator<HashTable::iterator>);
+        static_assert(std::forward_iterator<HashTable::const_iterator>);
+        HashTable ht1;
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Insert " << MAXHASH << " entries and walk them with range-for..." << endl;
+        for (size_t i = 1; i <= MAXHASH; i++)
+            ht1.insert(make_key<key_type>(i), make_value<value_type>(i));
+        size_t visited = 0, sum = 0;
+        for (auto [key, value] : ht1) {
+            visited++;
+            sum += value;
+            value *= 10; // writes through to the bucket
+        }
+        ok &= (visited == ht1.size() && sum == MAXHASH * (MAXHASH + 1) / 2 + MAXHASH);
+        ok &= (ht1.get(make_key<key_type>(1)) == make_value<value_type>(1) * 10);
+        OUTSTREAM << "  visited " << visited << " entries, value sum " << sum << endl;
+
+        OUTSTREAM << "Step 2: Scan 3 buckets at a time while inserting enough to force resizes..." << endl;
+        vector<string> seen;
+        size_t extra = 0, capacityBefore = ht1.capacity(), calls = 0;
+        size_t cursor = 0;
+        do {
+            cursor = ht1.scan(cursor, 3, [&](string_view key, size_t) { seen.emplace_back(key); });
+            ht1.insert("scan-extra-" + to_string(extra), extra);
+            extra++;
+            calls++;
+        } while (cursor != 0);
+        OUTSTREAM << "  " << calls << " scan calls, capacity " << capacityBefore << " -> " << ht1.capacity() << endl;
+        for (size_t i = 1; i <= MAXHASH; i++)
+            ok &= (std::find(seen.begin(), seen.end(), make_key<key_type>(i)) != seen.end());
+        ok &= (ht1.capacity() > capacityBefore);
+
+        OUTSTREAM << (ok ? "SUCCESS: iterators cover every entry and scan() returned every original key."
+                         : "FAILURE: iteration or scan() missed entries.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST ITERATORS ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // PAYLOAD VALUES (INLINE and POOLED storage, stable references)
+    // =====================================================================
+    OUTSTREAM << "Testing PayloadHashTable value storage modes" << endl;
+    OUTSTREAM << "--------------------------------------------" << endl << endl;
+#ifdef HT_PAYLOAD
+    try {
+        struct Small { uint32_t a; uint32_t b; };
+        struct Large { size_t id; char text[120]; };
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: INLINE table of 8-byte structs, round-trip through get()..." << endl;
+        PayloadHashTable<Small> small;
+        ok &= (PayloadHashTable<Small>::storage == ValueStorage::INLINE);
+        for (size_t i = 1; i <= MAXHASH; i++)
+            small.insert(make_key<key_type>(i), Small{static_cast<uint32_t>(i), 9999});
+        auto s1 = small.get(make_key<key_type>(3));
+        ok &= (s1 && s1->a == 3 && s1->b == 9999);
+
+        OUTSTREAM << "Step 2: POOLED table of 128-byte structs, hold a reference across resizes..." << endl;
+        PayloadHashTable<Large> large;
+        ok &= (PayloadHashTable<Large>::storage == ValueStorage::POOLED);
+        Large& held = large["held"];
+        held.id = 42;
+        Large* address = &held;
+        size_t capacityBefore = large.capacity();
+        for (size_t i = 0; i < 64 * MAXHASH; i++)
+            large.insert("filler" + to_string(i), Large{i, {}});
+        OUTSTREAM << "  capacity " << capacityBefore << " -> " << large.capacity() << endl;
+        ok &= (large.capacity() > capacityBefore);
+        ok &= (large.find("held") == address && held.id == 42);
+
+        OUTSTREAM << "Step 3: remove and re-add reuses pool slots..." << endl;
+        ok &= large.remove("filler0");
+        ok &= !large.contains("filler0");
+        ok &= large.set("filler0", Large{7, {}});
+        ok &= (large.get("filler0")->id == 7);
+
+        OUTSTREAM << "Step 4: A throwing constructor leaves the pool unchanged..." << endl;
+        static int constructed = 0, destroyed = 0;
+        struct Fragile {
+            explicit Fragile(bool fail) {
+                if (fail) throw runtime_error("constructor failed");
+                ++constructed;
+            }
+            ~Fragile() { ++destroyed; }
+        };
+        {
+            HashTableValuePool<Fragile, 4> fragile;
+            size_t first = fragile.allocate(false);
+            fragile.release(first);
+            bool threw = false;
+            try {
+                fragile.allocate(true);
+            } catch (runtime_error&) {
+                threw = true;
+            }
+            for (size_t i = 0; i < 4; i++) {
+                try {
+                    fragile.allocate(true);
+                } catch (runtime_error&) {
+                }
+            }
+            ok &= (threw && fragile.size() == 0 && fragile.allocate(false) == first);
+            ok &= (fragile.allocate(false) == 1 && fragile.size() == 2);
+        }
+        ok &= (constructed == 3 && destroyed == 3);
+
+        OUTSTREAM << (ok ? "SUCCESS: INLINE values round-trip and POOLED references survive resize."
+                         : "FAILURE: payload storage lost a value or moved a pooled reference.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST PAYLOAD ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // CACHE MODE (entry/byte budget, CLOCK eviction, counters)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::setCacheBudget() CLOCK eviction" << endl;
+    OUTSTREAM << "--------------------------------------------------" << endl << endl;
+#ifdef HT_CACHE
+    try {
+        HashTable ht1;
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Budget of " << MAXHASH << " entries, insert " << 3 * MAXHASH << " keys..." << endl;
+        ht1.setCacheBudget(MAXHASH);
+        size_t capacityBefore = ht1.capacity();
+        for (size_t i = 1; i <= 3 * MAXHASH; i++)
+            ok &= ht1.insert(make_key<key_type>(i), make_value<value_type>(i));
+        HashTableStats st = ht1.stats();
+        OUTSTREAM << "  size " << ht1.size() << ", capacity " << capacityBefore << " -> " << ht1.capacity()
+                  << ", evictions " << st.evictions << ", compactions " << st.compactions << endl;
+        ok &= (ht1.size() == MAXHASH && ht1.capacity() == capacityBefore);
+        ok &= (st.evictions == 2 * MAXHASH && st.cacheMode);
+
+        OUTSTREAM << "Step 2: Touch two survivors, insert " << MAXHASH / 2 << " more, touched keys stay..." << endl;
+        vector<string> survivors;
+        for (auto [key, value] : ht1) survivors.emplace_back(key);
+        ok &= ht1.contains(survivors[0]) && ht1.contains(survivors[1]);
+        for (size_t i = 1; i <= MAXHASH / 2; i++)
+            ok &= ht1.insert("late" + to_string(i), make_value<value_type>(i));
+        ok &= ht1.contains(survivors[0]) && ht1.contains(survivors[1]);
+        ok &= !ht1.contains("never-inserted");
+        st = ht1.stats();
+        OUTSTREAM << "  hits " << st.cacheHits << ", misses " << st.cacheMisses << endl;
+        ok &= (st.cacheHits == 4 && st.cacheMisses == 1 && ht1.size() == MAXHASH);
+
+        OUTSTREAM << "Step 3: Byte budget of 64 (entries cost key length + 8)..." << endl;
+        HashTable ht2;
+        ht2.setCacheBudget(100, 64);
+        for (size_t i = 0; i < 20; i++)
+            ht2.insert("key" + to_string(i), i); // 4-5 byte keys, 12-13 bytes each
+        st = ht2.stats();
+        OUTSTREAM << "  size " << ht2.size() << ", bytes " << st.cacheBytes << endl;
+        ok &= (st.cacheBytes <= 64 && ht2.size() >= 4 && ht2.contains("key19"));
+        size_t sizeBefore = ht2.size();
+        ok &= !ht2.insert(string(64, 'x'), 1); // larger than the whole budget
+        ok &= (ht2.size() == sizeBefore);
+
+        OUTSTREAM << (ok ? "SUCCESS: cache stays within budget and CLOCK keeps referenced keys."
+                         : "FAILURE: cache exceeded its budget or evicted a referenced key.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST CACHE ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // TTL EXPIRY (lazy on lookup, timer wheel reclaim, manual clock)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable TTLs and expireTick()" << endl;
+    OUTSTREAM << "---------------------------------------" << endl << endl;
+#ifdef HT_TTL
+    try {
+        using namespace std::chrono_literals;
+        ManualClock clock;
+        HashTable ht1;
+        ht1.setClock(&clock);
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Insert session (100ms), token (5s) and config (no TTL)..." << endl;
+        ok &= ht1.insert("session", 1, 100ms);
+        ok &= ht1.insert("token", 2, 5000ms);
+        ok &= ht1.insert("config", 3);
+        ok &= (ht1.ttl("token") == 5000ms && !ht1.ttl("config"));
+
+        OUTSTREAM << "Step 2: Advance 150ms; session is gone from lookups before any reclaim..." << endl;
+        clock.advance(150ms);
+        ok &= (!ht1.get("session") && ht1.contains("token") && ht1.size() == 3);
+        ok &= (ht1.ttl("token") == 4850ms);
+        size_t reclaimed = ht1.expireTick();
+        OUTSTREAM << "  expireTick() reclaimed " << reclaimed << ", size " << ht1.size() << endl;
+        ok &= (reclaimed == 1 && ht1.size() == 2 && ht1.tombstones() == 1);
+        ok &= ht1.insert("session", 7); // no TTL this time
+        clock.advance(10s);
+        ok &= (ht1.get("session") == 7u && !ht1.contains("token"));
+        ok &= !ht1.remove("token"); // expired entries are reclaimed but not "removed"
+
+        OUTSTREAM << "Step 3: 1000 random TTLs up to 30h, reclaimed 16 at a time per simulated minute..." << endl;
+        mt19937_64 rng(5);
+        vector<uint64_t> deadlines;
+        for (size_t i = 0; i < 1000; i++) {
+            auto ttl = chrono::milliseconds(1 + rng() % (30ull * 3600 * 1000));
+            deadlines.push_back(clock.nowMillis() + static_cast<uint64_t>(ttl.count()));
+            ht1.insert("ttl" + to_string(i), i, ttl);
+        }
+        size_t calls = 0;
+        for (size_t minute = 1; minute <= 30 * 60; minute++) {
+            clock.advance(1min);
+            while (ht1.expireTick(16) > 0) calls++;
+            calls++;
+            size_t live = 0;
+            for (uint64_t d : deadlines) live += d > clock.nowMillis();
+            ok &= (ht1.size() == 2 + live); // "session" and "config" have no TTL
+        }
+        HashTableStats st = ht1.stats();
+        OUTSTREAM << "  " << calls << " expireTick() calls, " << st.expirations << " expirations, "
+                  << st.ttlTimers << " timers left" << endl;
+        ok &= (ht1.size() == 2 && st.expirations == 1002 && st.ttlTimers == 0);
+
+        OUTSTREAM << "Step 4: Refresh one key's 1s TTL 100000 times, 1ms apart, ticking the wheel as we go..." << endl;
+        ok &= ht1.insert("refreshed", 9, 1000ms);
+        size_t maxTimers = 0;
+        for (size_t i = 0; i < 100000; i++) {
+            clock.advance(1ms);
+            ok &= ht1.expire("refreshed", 1000ms);
+            if (i % 100 == 0) ht1.expireTick();
+            maxTimers = std::max(maxTimers, ht1.stats().ttlTimers);
+        }
+        ok &= ht1.contains("refreshed");
+        clock.advance(1001ms);
+        ht1.expireTick();
+        st = ht1.stats();
+        OUTSTREAM << "  at most " << maxTimers << " timers pending, " << st.ttlTimers << " left after it expired" << endl;
+        ok &= (maxTimers == 1 && st.ttlTimers == 0 && !ht1.contains("refreshed") && st.expirations == 1003);
+
+        OUTSTREAM << (ok ? "SUCCESS: entries expire on time and the wheel reclaims every one."
+                         : "FAILURE: an entry outlived its TTL or was reclaimed early.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST TTL ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // BLOOM FILTER (negative lookups, rebuild after removes)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::setBloomFilter()" << endl;
+    OUTSTREAM << "-----------------------------------" << endl << endl;
+#ifdef HT_BLOOM
+    try {
+        HashTable ht1;
+        ht1.setBloomFilter(10);
+        bool ok = ht1.hasBloomFilter();
+
+        OUTSTREAM << "Step 1: Insert 1000 keys, then churn 4000 remove+insert steps to pile up tombstones..." << endl;
+        const size_t count = 1000;
+        vector<string> live;
+        for (size_t i = 0; i < count; i++) {
+            live.push_back("bloom" + to_string(i));
+            ok &= ht1.insert(live.back(), 2 * i);
+        }
+        mt19937_64 rng(17);
+        vector<string> removed;
+        for (size_t i = 0; i < 4000; i++) {
+            size_t slot = rng() % count;
+            ok &= ht1.remove(live[slot]);
+            removed.push_back(live[slot]);
+            live[slot] = "churn" + to_string(i);
+            ok &= ht1.insert(live[slot], 2 * i);
+        }
+
+        OUTSTREAM << "Step 2: No false negatives: every live key found, every removed key gone..." << endl;
+        for (const auto& key : live) ok &= ht1.contains(key);
+        for (const auto& key : removed) ok &= !ht1.contains(key);
+
+        OUTSTREAM << "Step 3: 5000 never-inserted keys all miss, most of them turned away by the filter..." << endl;
+        for (size_t i = 0; i < 5000; i++) ok &= !ht1.contains("absent" + to_string(i));
+        HashTableStats st = ht1.stats();
+        OUTSTREAM << "  tombstones " << ht1.tombstones() << ", filter " << st.bloomBytes << " bytes, "
+                  << st.bloomRejects << " rejects, " << st.bloomRebuilds << " rebuilds" << endl;
+        ok &= (st.bloomBitsPerKey == 10 && st.bloomRejects > 0 && st.bloomRebuilds > 1);
+        ok &= (st.toJSON().find("\"bloom\"") != string::npos);
+
+        OUTSTREAM << "Step 4: Remove the filter; lookups are unchanged..." << endl;
+        ht1.setBloomFilter(0);
+        ok &= !ht1.hasBloomFilter() && ht1.stats().bloomBytes == 0;
+        for (const auto& key : live) ok &= ht1.contains(key);
+        ok &= !ht1.contains("absent0");
+
+        OUTSTREAM << (ok ? "SUCCESS: Bloom filter rejects misses without hiding any live key."
+                         : "FAILURE: Bloom filter hid a live key or never rejected a miss.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST BLOOM ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // BATCHED LOOKUPS (interleaved coroutines)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::getBatch()" << endl;
+    OUTSTREAM << "-----------------------------" << endl << endl;
+#ifdef HT_BATCH
+    try {
+        using namespace std::chrono_literals;
+        ManualClock clock;
+        HashTable ht1;
+        ht1.setClock(&clock);
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Insert 3000 short and long keys, 100 with a TTL, and remove every tenth..." << endl;
+        const size_t count = 3000;
+        vector<string> keys;
+        for (size_t i = 0; i < count; i++) {
+            keys.push_back(i % 2 ? "batch" + to_string(i) : string(40, 'b') + to_string(i));
+            if (i < 100) ok &= ht1.insert(keys.back(), 2 * i, 50ms);
+            else ok &= ht1.insert(keys.back(), 2 * i);
+        }
+        for (size_t i = 0; i < count; i += 10) ok &= ht1.remove(keys[i]);
+        clock.advance(100ms);
+        for (size_t i = 0; i < 1000; i++) keys.push_back("absent" + to_string(i));
+
+        OUTSTREAM << "Step 2: getBatch() at group sizes 1, 8, 32 and 500 (clamped) matches get() key by key..." << endl;
+        vector<string_view> views(keys.begin(), keys.end());
+        vector<optional<size_t>> out(views.size());
+        size_t expectedHits = 0;
+        for (const auto& key : views) expectedHits += ht1.get(key).has_value();
+        for (size_t group : {1, 8, 32, 500}) {
+            size_t hits = ht1.getBatch(views, out, group);
+            ok &= (hits == expectedHits);
+            for (size_t i = 0; i < views.size(); i++) ok &= (out[i] == ht1.get(views[i]));
+        }
+        OUTSTREAM << "  " << expectedHits << " hits of " << views.size() << " keys" << endl;
+        ok &= (expectedHits == count - count / 10 - 90);
+
+        OUTSTREAM << "Step 3: Same answers with a Bloom filter and in cache mode..." << endl;
+        ht1.setBloomFilter(10);
+        ok &= (ht1.getBatch(views, out) == expectedHits);
+        ht1.setCacheBudget(count);
+        uint64_t hitsBefore = ht1.stats().cacheHits;
+        ok &= (ht1.getBatch(views, out) == expectedHits);
+        ok &= (ht1.stats().cacheHits - hitsBefore == expectedHits);
+        ok &= (ht1.getBatch(span<const string_view>(), span<optional<size_t>>()) == 0);
+
+        OUTSTREAM << (ok ? "SUCCESS: getBatch() agrees with get() for hits, misses and expired keys."
+                         : "FAILURE: getBatch() disagreed with get().")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST BATCH ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // SET OPERATIONS (mergeFrom, intersectWith, subtract, eraseIf)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::mergeFrom / intersectWith / subtract / eraseIf" << endl;
+    OUTSTREAM << "-----------------------------------------------------------------" << endl << endl;
+#ifdef HT_SETOPS
+    try {
+        using namespace std::chrono_literals;
+        ManualClock clock;
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: A holds keys 0-1999, B holds 1000-2999 with a Bloom filter; A's key 1500 expires..." << endl;
+        auto key = [](size_t i) { return i % 2 ? "set" + to_string(i) : string(32, 's') + to_string(i); };
+        HashTable a, b;
+        a.setClock(&clock);
+        b.setBloomFilter(10);
+        for (size_t i = 0; i < 2000; i++) ok &= (i == 1500 ? a.insert(key(i), i, 10ms) : a.insert(key(i), i));
+        for (size_t i = 1000; i < 3000; i++) ok &= b.insert(key(i), 2 * i);
+        clock.advance(20ms);
+
+        OUTSTREAM << "Step 2: Union: A gains B's 1000 new keys plus the expired one, existing values kept..." << endl;
+        HashTable merged = a;
+        size_t added = merged.mergeFrom(b);
+        OUTSTREAM << "  added " << added << ", size " << merged.size() << endl;
+        ok &= (added == 1001 && merged.mergeFrom(b) == 0 && merged.mergeFrom(merged) == 0);
+        for (size_t i = 0; i < 3000; i++) {
+            size_t expected = (i < 1000 || (i < 2000 && i != 1500)) ? i : 2 * i;
+            ok &= (merged.get(key(i)) == expected);
+        }
+
+        OUTSTREAM << "Step 3: Intersection and difference of A with B..." << endl;
+        HashTable both = a, onlyA = a;
+        size_t dropped = both.intersectWith(b);
+        size_t subtracted = onlyA.subtract(b);
+        OUTSTREAM << "  intersect removed " << dropped << ", subtract removed " << subtracted << endl;
+        ok &= (dropped == 1000 && subtracted == 999);
+        for (size_t i = 0; i < 2000; i++) {
+            bool live = i != 1500;
+            ok &= (both.contains(key(i)) == (live && i >= 1000));
+            ok &= (onlyA.contains(key(i)) == (live && i < 1000));
+        }
+        HashTable small;
+        small.insert(key(5), 1);
+        small.insert(key(2500), 1);
+        ok &= (onlyA.subtract(small) == 1 && !onlyA.contains(key(5)) && onlyA.contains(key(7)));
+
+        OUTSTREAM << "Step 4: eraseIf drops the odd values, then the rest; the second sweep compacts..." << endl;
+        size_t erased = merged.eraseIf([](string_view, size_t value) { return value % 2 == 1; });
+        OUTSTREAM << "  erased " << erased << ", size " << merged.size() << ", tombstones " << merged.tombstones() << endl;
+        ok &= (erased == 1000 && merged.size() == 2000 && merged.tombstones() >= erased && merged.tombstones() <= merged.capacity() / 4);
+        for (const auto& [k, v] : merged) ok &= (v % 2 == 0);
+        ok &= (merged.eraseIf([](string_view, size_t) { return false; }) == 0);
+        ok &= (merged.eraseIf([](string_view k, size_t) { return !k.empty(); }) == 2000);
+        ok &= (merged.size() == 0 && merged.tombstones() == 0 && !merged.contains(key(2)));
+
+        OUTSTREAM << (ok ? "SUCCESS: bulk set operations agree with key-by-key results."
+                         : "FAILURE: a bulk set operation kept or lost the wrong keys.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST SETOPS ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // REOPTIMIZE (access-weighted layout)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::reoptimize()" << endl;
+    OUTSTREAM << "-------------------------------" << endl << endl;
+#ifdef HT_REOPTIMIZE
+    try {
+        bool ok = true;
+        const size_t count = 3000, hot = 300;
+        vector<string> keys;
+        for (size_t i = 0; i < count; i++) keys.push_back("layout" + to_string(i));
+
+        OUTSTREAM << "Step 1: Insert 3000 keys cold-first, then hit the last 300 keys 20 times each..." << endl;
+        auto build = [&](HashTable& ht) {
+            ht.setAccessSampling(1);
+            for (size_t i = 0; i < count; i++) ok &= ht.insert(keys[i], 2 * i);
+            for (size_t r = 0; r < 20; r++)
+                for (size_t i = count - hot; i < count; i++) ok &= ht.get(keys[i]).has_value();
+        };
+        HashTable ht1, ht2;
+        build(ht1);
+        build(ht2);
+        double unweighted = 0;
+        {
+            HashTable plain;
+            for (size_t i = 0; i < count; i++) plain.insert(keys[i], 2 * i);
+            unweighted = plain.weightedProbeLength();
+        }
+
+        OUTSTREAM << "Step 2: Full reoptimize() moves the hot keys nearer their home slots..." << endl;
+        HashTableLayoutReport report = ht1.reoptimize();
+        OUTSTREAM << "  weighted probes " << report.probesBefore << " -> " << report.probesAfter
+                  << " (unweighted " << unweighted << ")" << endl;
+        ok &= (report.probesAfter < report.probesBefore && report.probesAfter < 1.05);
+        for (size_t i = 0; i < count; i++) ok &= (ht1.get(keys[i]) == 2 * i);
+        ok &= (ht1.size() == count && ht1.tombstones() == 0);
+
+        OUTSTREAM << "Step 3: Incremental reoptimize(cursor, 64) over the whole table..." << endl;
+        double before = ht2.weightedProbeLength();
+        size_t cursor = 0, calls = 0;
+        do {
+            cursor = ht2.reoptimize(cursor, 64);
+            calls++;
+        } while (cursor != 0);
+        double after = ht2.weightedProbeLength();
+        OUTSTREAM << "  weighted probes " << before << " -> " << after << " in " << calls << " calls" << endl;
+        ok &= (after < before && calls == ht2.capacity() / 64);
+        for (size_t i = 0; i < count; i++) ok &= (ht2.get(keys[i]) == 2 * i);
+
+        OUTSTREAM << "Step 4: rehashBackwards() still keeps every entry..." << endl;
+        ht2[keys[0]] = 9999; // only operator[] stores the sentinel value
+        ht2.rehashBackwards();
+        ok &= (ht2.size() == count && ht2.get(keys[0]) == 9999u && ht2.get(keys[1]) == 2u);
+
+        OUTSTREAM << (ok ? "SUCCESS: reoptimize() lowers the weighted probe length without losing entries."
+                         : "FAILURE: reoptimize() lost an entry or did not help the hot keys.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST REOPTIMIZE ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // HASH FLOOD (collision attack detection and reseed)
+    // =====================================================================
+    OUTSTREAM << "Testing hash flood detection and SipHash reseed" << endl;
+    OUTSTREAM << "-----------------------------------------------" << endl << endl;
+#ifdef HT_HASHFLOOD
+    try {
+        bool ok = true;
+        const size_t count = 600;
+
+        OUTSTREAM << "Step 1: SipHash-2-4 matches the published test vectors..." << endl;
+        HashTableSipHash sip(0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL);
+        string message;
+        for (char c = 0; c < 15; c++) message.push_back(c);
+        ok &= (sip.hash24("") == 0x726fdb47dd0e0e31ULL && sip.hash24(message) == 0xa129ca6149be45e5ULL);
+
+        OUTSTREAM << "Step 2: Craft 600 keys whose std::hash all land on one home slot..." << endl;
+        HashTable sizing;
+        sizing.reserve(count);
+        const size_t mask = sizing.capacity() - 1;
+        vector<string> attack;
+        for (size_t n = 0; attack.size() < count; n++) {
+            string key = "flood" + to_string(n);
+            if ((hash<string_view>{}(key) & mask) == 0) attack.push_back(key);
+        }
+
+        auto timeGets = [&](const HashTable& ht) {
+            auto start = chrono::steady_clock::now();
+            size_t found = 0;
+            for (size_t r = 0; r < 5; r++)
+                for (const auto& key : attack) found += ht.get(key).has_value();
+            ok &= (found == 5 * count);
+            return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+        };
+        auto meanHitProbes = [](const HashTable& ht) {
+            HashTableStats st = ht.stats();
+            return st.getHits > 0 ? static_cast<double>(st.hitProbeTotal) / static_cast<double>(st.getHits) : 0.0;
+        };
+
+        OUTSTREAM << "Step 3: Without protection every lookup walks the whole chain..." << endl;
+        HashTable exposed;
+        exposed.setFloodProtection(false);
+        exposed.reserve(count);
+        for (size_t i = 0; i < count; i++) ok &= exposed.insert(attack[i], i);
+        exposed.resetStats();
+        double exposedMicros = timeGets(exposed);
+        ok &= (!exposed.keyedHash() && exposed.stats().hashReseeds == 0);
+
+        OUTSTREAM << "Step 4: With protection the table reseeds once and lookups recover..." << endl;
+        HashTable guarded;
+        guarded.reserve(count);
+        for (size_t i = 0; i < count; i++) ok &= guarded.insert(attack[i], i);
+        guarded.resetStats();
+        double guardedMicros = timeGets(guarded);
+        ok &= (guarded.keyedHash() && guarded.stats().hashReseeds == 1 && guarded.capacity() == sizing.capacity());
+        for (size_t i = 0; i < count; i++) ok &= (guarded.get(attack[i]) == i);
+        OUTSTREAM << "  5 passes of gets: " << exposedMicros << " us exposed, " << guardedMicros << " us guarded"
+                  << endl;
+        if (guarded.stats().enabled) {
+            OUTSTREAM << "  mean hit probes: " << meanHitProbes(exposed) << " exposed, " << meanHitProbes(guarded)
+                      << " guarded" << endl;
+            ok &= (meanHitProbes(exposed) > 100 && meanHitProbes(guarded) < 2);
+        } else {
+            ok &= (guardedMicros * 5 < exposedMicros);
+        }
+
+        OUTSTREAM << "Step 5: operator[] and mergeFrom() detect the flood too..." << endl;
+        HashTable counted;
+        for (const auto& key : attack) counted[key] += 3;
+        ok &= (counted.keyedHash() && counted.size() == count);
+        HashTable merged;
+        merged.insert("resident", 1);
+        ok &= (merged.mergeFrom(exposed) == count);
+        ok &= (merged.keyedHash() && merged.size() == count + 1 && merged.get("resident") == 1u);
+        for (size_t i = 0; i < count; i++) ok &= (counted.get(attack[i]) == 3u && merged.get(attack[i]) == i);
+
+        OUTSTREAM << "Step 6: Ordinary keys keep the unkeyed hash..." << endl;
+        HashTable ordinary;
+        for (size_t i = 0; i < 3000; i++) ordinary["plain" + to_string(i)] = i;
+        ok &= (!ordinary.keyedHash() && ordinary.stats().hashReseeds == 0);
+
+        OUTSTREAM << "Step 7: A scan that sees hashEpoch() change mid-walk restarts and still finds every key..." << endl;
+        vector<string> scanned;
+        uint64_t epoch = ordinary.hashEpoch();
+        size_t cursor = 0, calls = 0, restarts = 0;
+        for (;;) {
+            if (++calls == 4) ordinary.useKeyedHash();
+            cursor = ordinary.scan(cursor, 64, [&](string_view key, size_t) { scanned.emplace_back(key); });
+            if (ordinary.hashEpoch() != epoch) {
+                epoch = ordinary.hashEpoch();
+                cursor = 0;
+                ++restarts;
+            } else if (cursor == 0) {
+                break;
+            }
+        }
+        std::sort(scanned.begin(), scanned.end());
+        scanned.erase(std::unique(scanned.begin(), scanned.end()), scanned.end());
+        ok &= (restarts == 1 && scanned.size() == 3000);
+
+        OUTSTREAM << (ok ? "SUCCESS: colliding keys switch the table to SipHash and lookups go back to O(1)."
+                         : "FAILURE: the flood was not detected or entries were lost.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST HASH FLOOD ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // INDEX WIDTH (HASHTABLE_INDEX_BITS)
+    // =====================================================================
+    OUTSTREAM << "Testing HASHTABLE_INDEX_BITS slot indices" << endl;
+    OUTSTREAM << "-----------------------------------------" << endl << endl;
+#ifdef HT_INDEX_BITS
+    try {
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Offsets are " << HASHTABLE_INDEX_BITS << "-bit and MAX_CAPACITY matches..." << endl;
+        ok &= (sizeof(HashTableIndex) * 8 == HASHTABLE_INDEX_BITS);
+        ok &= (HashTable::MAX_CAPACITY == (size_t{1} << (HASHTABLE_INDEX_BITS == 64 ? 63 : HASHTABLE_INDEX_BITS)));
+
+        OUTSTREAM << "Step 2: generateOffsets(4096) is still a permutation of 1..4095..." << endl;
+        vector<HashTableIndex> offsets = HashTable::generateOffsets(4096);
+        vector<bool> seen(4096, false);
+        for (HashTableIndex offset : offsets) {
+            ok &= (offset >= 1 && offset < 4096 && !seen[offset]);
+            if (offset < 4096) seen[offset] = true;
+        }
+        ok &= (offsets.size() == 4095);
+
+        OUTSTREAM << "Step 3: A table at MAX_CAPACITY fills past load 0.5 instead of growing..." << endl;
+#if HASHTABLE_INDEX_BITS == 16
+        HashTable full;
+        for (size_t i = 0; i < HashTable::MAX_CAPACITY; i++) full["slot" + to_string(i)] = i;
+        ok &= (full.capacity() == HashTable::MAX_CAPACITY && full.size() == HashTable::MAX_CAPACITY);
+        ok &= (full.get("slot12345") == 12345u && !full.insert("one-too-many", 1));
+        bool threw = false;
+        try {
+            full["one-too-many"] = 1;
+        } catch (length_error&) {
+            threw = true;
+        }
+        ok &= threw;
+        full.remove("slot7");
+        ok &= full.insert("one-too-many", 1);
+
+        OUTSTREAM << "Step 4: mergeFrom() past MAX_CAPACITY counts only the keys it placed..." << endl;
+        HashTable left, right;
+        for (size_t i = 0; i < 40000; i++) {
+            left.insert("left" + to_string(i), i);
+            right.insert("right" + to_string(i), i);
+        }
+        size_t merged = left.mergeFrom(right);
+        ok &= (left.size() == HashTable::MAX_CAPACITY && merged == HashTable::MAX_CAPACITY - 40000);
+#else
+        OUTSTREAM << "  (only checked in 16-bit builds; 2^" << HASHTABLE_INDEX_BITS << " slots do not fit in memory)"
+                  << endl;
+#endif
+
+        OUTSTREAM << (ok ? "SUCCESS: slot indices use the configured width."
+                         : "FAILURE: slot indices do not match HASHTABLE_INDEX_BITS.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST INDEX BITS ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // KEY COMPARISON (hash tag + length + SIMD equality)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTableBucket key comparison" << endl;
+    OUTSTREAM << "--------------------------------------" << endl << endl;
+#ifdef HT_KEY_COMPARE
+    try {
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: equalBytes() at lengths 0..80, one differing byte at every position..." << endl;
+        for (size_t n = 0; n <= 80; n++) {
+            string a(n, 'u'), b(n, 'u');
+            for (size_t i = 0; i < n; i++) a[i] = b[i] = static_cast<char>('a' + (i * 7) % 26);
+            ok &= HashTableBucket::equalBytes(a.data(), b.data(), n);
+            for (size_t i = 0; i < n; i++) {
+                b[i] ^= 0x20;
+                ok &= !HashTableBucket::equalBytes(a.data(), b.data(), n);
+                b[i] ^= 0x20;
+            }
+        }
+
+        OUTSTREAM << "Step 2: holds() needs the state, the tag, the length and the bytes to match..." << endl;
+        const string url = "https://shop.example.com/api/v2/catalog/items/0000004242/reviews";
+        HashTableBucket bucket;
+        ok &= !bucket.holds(url, 0);
+        bucket.load(url, 1, 0xC0FFEE);
+        ok &= (bucket.holds(url, 0xC0FFEE) && !bucket.holds(url, 0xC0FFEF));
+        ok &= !bucket.holds(url.substr(0, url.size() - 1), 0xC0FFEE);
+        string other = url;
+        other[50] = '5';
+        ok &= (bucket.mayHold(other, 0xC0FFEE) && !bucket.holds(other, 0xC0FFEE));
+        bucket.markRemoved();
+        ok &= !bucket.holds(url, 0xC0FFEE);
+
+        OUTSTREAM << "Step 3: 3000 URL keys sharing a 46-byte prefix round-trip through the table..." << endl;
+        HashTable ht;
+        vector<string> urls;
+        for (size_t i = 0; i < 3000; i++) {
+            string id = to_string(i);
+            urls.push_back("https://shop.example.com/api/v2/catalog/items/" + string(10 - id.size(), '0') + id +
+                           "/reviews");
+        }
+        for (size_t i = 0; i < urls.size(); i++) ht[urls[i]] = i;
+        ht.rehashBackwards(); // rebuilt buckets keep working tags
+        for (size_t i = 0; i < urls.size(); i++) ok &= (ht.get(urls[i]) == i);
+        string missing = urls[0];
+        missing[missing.size() - 9] = 'x';
+        ok &= !ht.contains(missing) && ht.remove(urls[7]) && !ht.contains(urls[7]);
+
+        OUTSTREAM << (ok ? "SUCCESS: key comparison rejects on tag and length and matches byte for byte."
+                         : "FAILURE: key comparison gave a wrong answer.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST KEY COMPARE ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // OPERATION TRACE (ring-buffer record file for replay)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::attachTrace() and HashTableTrace::load()" << endl;
+    OUTSTREAM << "------------------------------------------------------------" << endl << endl;
+#ifdef HT_TRACE
+    try {
+        bool ok = true;
+        const string path = "/tmp/hashtable-test-" + to_string(getpid()) + ".trace";
+
+        OUTSTREAM << "Step 1: Trace insert / get / contains / getBatch / remove / operator[] on a 64-record ring..." << endl;
+        {
+            HashTable ht;
+            HashTableTrace trace(path, 50); // rounded up to 64
+            ok &= (trace.isOpen() && trace.capacity() == 64);
+            ht.attachTrace(&trace);
+            ht.insert("alpha", 1);
+            ht.get("alpha");
+            ht.contains("beta");
+            string_view batchKeys[] = {"alpha", "gamma"};
+            optional<size_t> found[2];
+            ht.getBatch(batchKeys, found);
+            ht.remove("alpha");
+            ht["delta"] = 4;
+            ok &= (trace.recorded() == 7 && trace.flush());
+
+            optional<HashTableTraceData> data = HashTableTrace::load(path);
+            const TraceOp expectOps[] = {TraceOp::INSERT, TraceOp::GET, TraceOp::GET, TraceOp::GET,
+                                         TraceOp::GET, TraceOp::REMOVE, TraceOp::ASSIGN};
+            const char* expectKeys[] = {"alpha", "alpha", "beta", "alpha", "gamma", "alpha", "delta"};
+            ok &= (data && data->records.size() == 7 && data->overwritten == 0 && data->tickNanos > 0);
+            for (size_t i = 0; data && i < data->records.size() && i < 7; i++) {
+                const HashTableTraceRecord& r = data->records[i];
+                ok &= (static_cast<TraceOp>(r.op) == expectOps[i] && r.keyLength == strlen(expectKeys[i]) &&
+                       r.keyHash == hash<string_view>{}(expectKeys[i]));
+                ok &= (i == 0 || r.ticks >= data->records[i - 1].ticks);
+            }
+            if (data) {
+                ok &= (HashTableTrace::keyFor(data->records[0]) == HashTableTrace::keyFor(data->records[1]) &&
+                       HashTableTrace::keyFor(data->records[0]).size() == 5 &&
+                       HashTableTrace::keyFor(data->records[0]) != HashTableTrace::keyFor(data->records[2]));
+            }
+
+            OUTSTREAM << "Step 2: 100 more gets wrap the ring; load() keeps the newest 64 in order..." << endl;
+            for (size_t i = 0; i < 100; i++) ht.get("k" + to_string(i));
+            trace.flush();
+            data = HashTableTrace::load(path);
+            ok &= (data && data->records.size() == 64 && data->overwritten == 43);
+            ok &= (data && data->records.back().keyHash == hash<string_view>{}("k99") &&
+                   data->records.front().keyHash == hash<string_view>{}("k" + to_string(99 - 63)));
+
+            OUTSTREAM << "Step 3: Detaching stops recording; the table itself is unaffected..." << endl;
+            ht.attachTrace(nullptr);
+            ht.insert("epsilon", 5);
+            ok &= (trace.recorded() == 107 && ht.get("delta") == 4u && ht.get("epsilon") == 5u);
+        }
+
+        OUTSTREAM << "Step 4: A trace that cannot be created records nothing; a non-trace file does not load..." << endl;
+        HashTableTrace broken("/nonexistent-dir/x.trace");
+        HashTable ht2;
+        ht2.attachTrace(&broken);
+        ht2["zeta"] = 6;
+        ok &= (!broken.isOpen() && broken.recorded() == 0 && ht2.get("zeta") == 6u);
+        ok &= !HashTableTrace::load("/nonexistent-dir/x.trace");
+        { ofstream junk(path, ios::binary | ios::trunc); junk << "not a trace at all, just some bytes to fill 64+"; }
+        ok &= !HashTableTrace::load(path);
+        remove(path.c_str());
+
+        OUTSTREAM << "Step 5: useKeyedHash() switches to SipHash and keeps every entry..." << endl;
+        for (size_t i = 0; i < 500; i++) ht2["keyed" + to_string(i)] = i;
+        ht2.useKeyedHash();
+        ok &= ht2.keyedHash();
+        for (size_t i = 0; i < 500; i++) ok &= (ht2.get("keyed" + to_string(i)) == i);
+
+        OUTSTREAM << (ok ? "SUCCESS: traced operations read back in order, with their hashes and lengths."
+                         : "FAILURE: the trace lost, reordered or misrecorded an operation.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST TRACE ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // MEMORY ACCOUNTING AND BUDGET (memoryUsage, setMemoryBudget policies)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::memoryUsage() and setMemoryBudget()" << endl;
+    OUTSTREAM << "------------------------------------------------------" << endl << endl;
+#ifdef HT_MEMORY
+    try {
+        bool ok = true;
+        const size_t bucketBytes = sizeof(HashTableBucket), indexBytes = sizeof(HashTableIndex);
+        auto keyOf = [](size_t i) { return (i % 2 ? "a-key-past-the-inline-buffer-" : "k") + to_string(i); };
+
+        OUTSTREAM << "Step 1: 600 keys, half of them long; the breakdown adds up..." << endl;
+        HashTable ht1;
+        size_t longKeyBytes = 0;
+        for (size_t i = 0; i < 600; i++) {
+            ht1.insert(keyOf(i), i);
+            if (keyOf(i).size() > string().capacity()) longKeyBytes += keyOf(i).size() + 1;
+        }
+        HashTableMemoryUsage usage = ht1.memoryUsage();
+        const size_t cap = ht1.capacity();
+        OUTSTREAM << "  buckets " << usage.buckets << ", offsets " << usage.offsets << ", keys " << usage.keys
+                  << ", total " << usage.total() << ", next resize peaks at " << usage.resizePeak << endl;
+        ok &= (usage.buckets == cap * bucketBytes && usage.offsets == (cap - 1) * indexBytes);
+        ok &= (usage.keys == longKeyBytes && usage.filter == 0 && usage.timers == 0 && usage.pending == 0);
+        ok &= (usage.total() == usage.buckets + usage.offsets + usage.keys);
+        ok &= (ht1.stats().memoryBytes == usage.buckets + usage.offsets + usage.keys);
+        // Doubling: the new bucket array while the old one is live, and offsets for twice the slots
+        ok &= (usage.resizePeak == usage.total() + 2 * cap * bucketBytes + cap * indexBytes);
+
+        OUTSTREAM << "Step 2: A Bloom filter and TTL timers show up as their own components..." << endl;
+        ht1.setBloomFilter(10);
+        ht1.expire(keyOf(1), chrono::hours(1));
+        usage = ht1.memoryUsage();
+        ok &= (usage.filter > 0 && usage.filter == ht1.stats().bloomBytes && usage.timers > 0);
+        ok &= (ht1.stats().memoryBytes == usage.buckets + usage.offsets + usage.keys + usage.filter);
+
+        const size_t BUDGET = 150000;
+        OUTSTREAM << "Step 3: FAIL policy, " << BUDGET << "-byte budget: inserts stop before a doubling would pass it..." << endl;
+        HashTable ht2;
+        ht2.setMemoryBudget(BUDGET);
+        size_t inserted = 0;
+        for (size_t i = 0; i < 5000; i++) inserted += ht2.insert(keyOf(i), i);
+        usage = ht2.memoryUsage();
+        HashTableStats st = ht2.stats();
+        OUTSTREAM << "  " << inserted << " inserted, capacity " << ht2.capacity() << ", " << st.memoryBytes
+                  << " bytes, next doubling would peak at " << usage.resizePeak << endl;
+        ok &= (inserted == ht2.size() && ht2.size() == ht2.capacity() / 2 && st.memoryBytes <= BUDGET);
+        ok &= (usage.resizePeak > BUDGET && st.budgetRejects == 5000 - inserted && st.memoryBudget == BUDGET);
+        ok &= !ht2.insert("one-more-key-that-does-not-fit", 1);
+        bool threw = false;
+        try {
+            ht2["one-more-key-that-does-not-fit"] = 1;
+        } catch (length_error&) {
+            threw = true;
+        }
+        ht2[keyOf(0)] = 42; // existing keys are always returned
+        ok &= (threw && ht2.get(keyOf(0)) == 42u && ht2.size() == inserted);
+        ok &= (ht2.remove(keyOf(1)) && ht2.insert("a-new-long-key-in-its-place", 1));
+        ok &= (ht2.stats().memoryBytes <= BUDGET && ht2.memoryUsage().keys <= usage.keys);
+
+        OUTSTREAM << "Step 4: EVICT policy: every insert lands, CLOCK evicts to stay in budget..." << endl;
+        HashTable ht3;
+        ht3.setMemoryBudget(BUDGET, MemoryPolicy::EVICT);
+        inserted = 0;
+        for (size_t i = 0; i < 5000; i++) {
+            inserted += ht3.insert(keyOf(i), i);
+            if (i == 4990) ht3.get(keyOf(4990)); // referenced: survives the next few evictions
+        }
+        st = ht3.stats();
+        OUTSTREAM << "  size " << ht3.size() << ", capacity " << ht3.capacity() << ", evictions " << st.evictions
+                  << ", " << st.memoryBytes << " bytes" << endl;
+        ok &= (inserted == 5000 && st.evictions > 0 && st.memoryBytes <= BUDGET && st.budgetRejects == 0);
+        ok &= (ht3.contains(keyOf(4999)) && ht3.contains(keyOf(4990)) && ht3.size() <= ht3.capacity() / 2);
+        ok &= (ht3.memoryUsage().resizePeak > BUDGET);
+
+        OUTSTREAM << "Step 5: FILL policy: the table fills to MAX_FILL_LOAD instead of doubling..." << endl;
+        HashTable ht4;
+        ht4.setMemoryBudget(BUDGET, MemoryPolicy::FILL);
+        inserted = 0;
+        for (size_t i = 0; i < 5000; i++) inserted += ht4.insert(keyOf(i), i);
+        OUTSTREAM << "  " << inserted << " inserted, load " << ht4.alpha() << endl;
+        ok &= (ht4.capacity() == ht2.capacity() && ht4.alpha() >= HashTable::MAX_FILL_LOAD);
+        ok &= (inserted > ht2.size() && ht4.stats().memoryBytes <= BUDGET);
+        for (size_t i = 0; i < inserted; i++) ok &= ht4.contains(keyOf(i));
+
+        OUTSTREAM << "Step 6: Lifting the budget lets the table double again..." << endl;
+        ht4.setMemoryBudget(0);
+        ok &= (ht4.insert("after-the-budget", 1) && ht4.capacity() == 2 * ht2.capacity() && ht4.memoryBudget() == 0);
+
+        OUTSTREAM << (ok ? "SUCCESS: memory is accounted by component and every policy keeps the resize peak in budget."
+                         : "FAILURE: memory accounting is off or a policy let the table pass its budget.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST MEMORY ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // REPLICATION (HashTableChangeFeed, serveReplica, HashTableReplica)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::serveReplica() and HashTableReplica::pull()" << endl;
+    OUTSTREAM << "---------------------------------------------------------------" << endl << endl;
+#ifdef HT_REPLICATION
+    try {
+        bool ok = true;
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) throw runtime_error("socketpair failed");
+        // One round trip: the replica pulls on its own thread while the primary serves
+        auto sync = [&](HashTable& primary, HashTableReplica& replica, size_t maxChanges) {
+            bool pulled = false;
+            thread pull([&] { pulled = replica.pull(fds[1], fds[1], maxChanges); });
+            bool served = primary.serveReplica(fds[0], fds[0]);
+            pull.join();
+            return pulled && served;
+        };
+        auto same = [](const HashTable& a, const HashTable& b) {
+            if (a.size() != b.size()) return false;
+            for (auto [key, value] : a) {
+                if (b.get(key) != value) return false;
+            }
+            return true;
+        };
+
+        OUTSTREAM << "Step 1: 300 inserts get versions 1..300; a new replica starts from a snapshot..." << endl;
+        HashTableChangeFeed feed(1000);
+        HashTable primary, copy;
+        primary.attachFeed(&feed);
+        HashTableReplica replica(copy);
+        for (size_t i = 0; i < 300; i++) primary.insert("key" + to_string(i), i);
+        ok &= (feed.version() == 300 && feed.size() == 300 && feed.oldestVersion() == 0);
+        ok &= (sync(primary, replica, 1000) && replica.snapshots() == 1 && replica.upToDate());
+        ok &= (replica.version() == 300 && same(primary, copy));
+
+        OUTSTREAM << "Step 2: 200 operator[] writes to 10 hot keys compact to 10 changes..." << endl;
+        for (size_t i = 0; i < 200; i++) ++primary["hot" + to_string(i % 10)];
+        OUTSTREAM << "  version " << feed.version() << ", " << feed.size() << " live changes, "
+                  << feed.superseded() << " superseded" << endl;
+        ok &= (feed.version() == 500 && feed.size() == 310 && feed.superseded() == 190);
+        ok &= (sync(primary, replica, 1000) && replica.snapshots() == 1 && replica.changesApplied() == 10);
+        ok &= (copy.get("hot3") == 20u && replica.version() == 500 && same(primary, copy));
+
+        OUTSTREAM << "Step 3: Removes, eraseIf and evictions reach the replica as removes..." << endl;
+        for (size_t i = 0; i < 50; i++) primary.remove("key" + to_string(i));
+        primary.eraseIf([](string_view key, size_t) { return key.back() == '7'; });
+        primary.setCacheBudget(200);
+        ok &= (primary.size() == 200 && primary.stats().evictions > 0);
+        ok &= (sync(primary, replica, 1000) && replica.snapshots() == 1 && same(primary, copy));
+
+        OUTSTREAM << "Step 4: A replica asking for 30 changes at a time takes several pulls..." << endl;
+        primary.setCacheBudget(0);
+        for (size_t i = 0; i < 100; i++) primary.insert("batch" + to_string(i), i);
+        size_t pulls = 0;
+        do {
+            ok &= sync(primary, replica, 30);
+            ++pulls;
+        } while (ok && !replica.upToDate() && pulls < 10);
+        OUTSTREAM << "  " << pulls << " pulls to catch up to version " << replica.version() << endl;
+        ok &= (pulls == 4 && replica.version() == feed.version() && same(primary, copy));
+
+        OUTSTREAM << "Step 5: A replica behind the feed's oldest change gets a snapshot instead..." << endl;
+        HashTableChangeFeed smallFeed(100);
+        HashTable primary2, copy2;
+        primary2.attachFeed(&smallFeed);
+        HashTableReplica replica2(copy2);
+        primary2.insert("early", 1);
+        ok &= sync(primary2, replica2, 1000);
+        for (size_t i = 0; i < 500; i++) primary2.insert("late" + to_string(i), i);
+        OUTSTREAM << "  " << smallFeed.dropped() << " changes dropped, oldest version " << smallFeed.oldestVersion() << endl;
+        ok &= (smallFeed.size() == 100 && smallFeed.dropped() == 401 && smallFeed.oldestVersion() == 401);
+        ok &= (sync(primary2, replica2, 1000) && replica2.snapshots() == 2 && same(primary2, copy2));
+        for (size_t i = 0; i < 20; i++) primary2.remove("late" + to_string(i));
+        ok &= (sync(primary2, replica2, 1000) && replica2.snapshots() == 2 && same(primary2, copy2));
+
+        OUTSTREAM << "Step 6: Once the primary closes its end, pull returns false..." << endl;
+        close(fds[0]);
+        ok &= !replica.pull(fds[1], fds[1]);
+        close(fds[1]);
+        HashTable unfed;
+        ok &= !unfed.serveReplica(-1, -1);
+
+        OUTSTREAM << "Step 7: Frames claiming a huge body are refused before anything is allocated..." << endl;
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) throw runtime_error("socketpair failed");
+        auto forge = [](int fd, ReplicationFrame type) {
+            char header[9];
+            const uint64_t len = uint64_t{1} << 62;
+            memcpy(header, &len, sizeof(len));
+            header[8] = static_cast<char>(type);
+            return write(fd, header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+        };
+        ok &= forge(fds[1], ReplicationFrame::PULL) && !primary.serveReplica(fds[0], fds[0]);
+        ok &= forge(fds[0], ReplicationFrame::SNAPSHOT) && !replica.pull(fds[1], fds[1]);
+        close(fds[0]);
+        close(fds[1]);
+
+        OUTSTREAM << (ok ? "SUCCESS: replicas follow the primary through compacted deltas and snapshot fallback."
+                         : "FAILURE: a replica diverged from its primary or the feed miscounted.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST REPLICATION ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // FROZEN TABLE (minimal perfect hash snapshot)
+    // =====================================================================
+    OUTSTREAM << "Testing FrozenHashTable::build() and lookups" << endl;
+    OUTSTREAM << "--------------------------------------------" << endl << endl;
+#ifdef HT_FROZEN
+    try {
+        using namespace std::chrono_literals;
+        ManualClock clock;
+        HashTable ht1;
+        ht1.setClock(&clock);
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Freeze an empty table..." << endl;
+        optional<FrozenHashTable> empty = FrozenHashTable::build(ht1);
+        ok &= (empty && empty->size() == 0 && !empty->contains("anything"));
+
+        OUTSTREAM << "Step 2: Insert 5000 keys (value 2i, never the rejected 9999), remove every 10th, give every 7th a 50ms TTL..." << endl;
+        const size_t count = 5000;
+        for (size_t i = 0; i < count; i++) {
+            if (i % 7 == 0) ht1.insert("frozen" + to_string(i), 2 * i, 50ms);
+            else ht1.insert("frozen" + to_string(i), 2 * i);
+        }
+        for (size_t i = 0; i < count; i += 10) ht1.remove("frozen" + to_string(i));
+        clock.advance(100ms);
+
+        OUTSTREAM << "Step 3: Freeze; only live, unexpired entries are carried over..." << endl;
+        optional<FrozenHashTable> frozen = FrozenHashTable::build(ht1);
+        ok &= frozen.has_value();
+        if (frozen) {
+            size_t live = 0;
+            for (size_t i = 0; i < count; i++) {
+                bool expected = (i % 10 != 0 && i % 7 != 0);
+                optional<size_t> value = frozen->get("frozen" + to_string(i));
+                live += expected;
+                ok &= (value.has_value() == expected);
+                ok &= (!expected || *value == 2 * i);
+            }
+            for (size_t i = 0; i < 1000; i++) ok &= !frozen->contains("missing" + to_string(i));
+            OUTSTREAM << "  size " << frozen->size() << ", " << frozen->pilotBitsPerKey() << " pilot bits/key, "
+                      << frozen->bytes() << " bytes" << endl;
+            while (ht1.expireTick(1000) > 0) {}
+            ok &= (frozen->size() == live && frozen->size() == ht1.size());
+            ok &= (frozen->pilotBitsPerKey() < 8.0);
+        }
+
+        OUTSTREAM << (ok ? "SUCCESS: frozen table answers every hit and miss like its source."
+                         : "FAILURE: frozen table disagreed with its source table.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST FROZEN ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // CONST TABLE (compile-time perfect hash)
+    // =====================================================================
+    OUTSTREAM << "Testing ConstHashTable get() / contains()" << endl;
+    OUTSTREAM << "-----------------------------------------" << endl << endl;
+#ifdef HT_CONST
+    try {
+        static constexpr ConstHashTable commands({
+            {"GET", 1}, {"SET", 2}, {"DEL", 3}, {"EXISTS", 4}, {"EXPIRE", 5}, {"TTL", 6}, {"INCR", 7},
+            {"DECR", 8}, {"MGET", 9}, {"MSET", 10}, {"SCAN", 11}, {"KEYS", 12}, {"PING", 13}, {"ECHO", 14},
+            {"INFO", 15}, {"QUIT", 16}, {"HGET", 17}, {"HSET", 18}, {"LPUSH", 19}, {"RPUSH", 20},
+            {"LPOP", 21}, {"RPOP", 22}, {"SADD", 23}, {"SREM", 24}, {"ZADD", 25}, {"ZREM", 26},
+            {"APPEND", 27}, {"STRLEN", 28}, {"FLUSHALL", 29}, {"DBSIZE", 30}, {"SELECT", 31},
+            {"AUTH", 32}, {"MULTI", 33}, {"EXEC", 34}, {"WATCH", 35}, {"PUBLISH", 36}
+        });
+        static constexpr ConstHashTable<0> none({});
+
+        OUTSTREAM << "Step 1: Lookups evaluated by the compiler (static_assert)..." << endl;
+        static_assert(commands.size() == 36);
+        static_assert(commands.get("SET") == 2u && commands.get("PUBLISH") == 36u);
+        static_assert(!commands.contains("set") && !commands.contains("") && !none.contains("GET"));
+
+        OUTSTREAM << "Step 2: The same lookups at run time agree with a HashTable loaded by insert()..." << endl;
+        const char* names[] = {"GET", "SET", "DEL", "EXISTS", "EXPIRE", "TTL", "INCR", "DECR", "MGET", "MSET",
+                               "SCAN", "KEYS", "PING", "ECHO", "INFO", "QUIT", "HGET", "HSET", "LPUSH", "RPUSH",
+                               "LPOP", "RPOP", "SADD", "SREM", "ZADD", "ZREM", "APPEND", "STRLEN", "FLUSHALL",
+                               "DBSIZE", "SELECT", "AUTH", "MULTI", "EXEC", "WATCH", "PUBLISH"};
+        HashTable ht1;
+        for (size_t i = 0; i < size(names); i++) ht1.insert(names[i], i + 1);
+        bool ok = true;
+        for (const char* name : names) ok &= (commands.get(name) == ht1.get(name));
+        for (const char* miss : {"GETS", "SE", "PUBLISHX", "get", "ZZZZ"}) {
+            ok &= (!commands.contains(miss) && !ht1.contains(miss));
+        }
+
+        OUTSTREAM << "Step 3: Build a 300-key table (header-name-0 .. header-name-299) at compile time..." << endl;
+        struct HeaderText { char name[300][16]; };
+        static constexpr HeaderText headerText = [] {
+            HeaderText text{};
+            for (size_t i = 0; i < 300; i++) {
+                size_t len = 0;
+                for (char c : string_view("header-name-")) text.name[i][len++] = c;
+                if (i >= 100) text.name[i][len++] = static_cast<char>('0' + i / 100);
+                if (i >= 10) text.name[i][len++] = static_cast<char>('0' + i / 10 % 10);
+                text.name[i][len++] = static_cast<char>('0' + i % 10);
+            }
+            return text;
+        }();
+        struct HeaderEntries { ConstHashTable<300>::Entry entry[300]; };
+        static constexpr HeaderEntries headerEntries = [] {
+            HeaderEntries entries{};
+            for (size_t i = 0; i < 300; i++) entries.entry[i] = {string_view(headerText.name[i]), i};
+            return entries;
+        }();
+        static constexpr ConstHashTable<300> headers(headerEntries.entry);
+        static_assert(headers.get("header-name-0") == 0u && headers.get("header-name-299") == 299u);
+        for (size_t i = 0; i < 300; i++) ok &= (headers.get("header-name-" + to_string(i)) == i);
+        ok &= !headers.contains("header-name-300") && !headers.contains("header-name-");
+
+        OUTSTREAM << (ok ? "SUCCESS: compile-time table matches HashTable on every hit and miss."
+                         : "FAILURE: compile-time table disagreed with HashTable.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST CONST ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // CUCKOO TABLE (4-way buckets, BFS displacement)
+    // =====================================================================
+    OUTSTREAM << "Testing CuckooHashTable insert / remove / get" << endl;
+    OUTSTREAM << "---------------------------------------------" << endl << endl;
+#ifdef HT_CUCKOO
+    try {
+        CuckooHashTable ht1;
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Insert 20000 keys, noting the load factor each time the table resizes..." << endl;
+        const size_t count = 20000;
+        double lowestFill = 1.0;
+        for (size_t i = 0; i < count; i++) {
+            size_t before = ht1.capacity();
+            double fill = ht1.alpha();
+            ok &= ht1.insert("cuckoo" + to_string(i), i);
+            if (ht1.capacity() != before && before >= 1024) lowestFill = min(lowestFill, fill);
+        }
+        ok &= !ht1.insert("cuckoo7", 1); // duplicate
+        OUTSTREAM << "  capacity " << ht1.capacity() << ", lowest load at a resize " << lowestFill << ", "
+                  << ht1.displacements() << " displacements" << endl;
+        ok &= (ht1.size() == count && lowestFill > 0.9 && ht1.displacements() > 0);
+
+        OUTSTREAM << "Step 2: Every key found with its value; misses and duplicates rejected..." << endl;
+        for (size_t i = 0; i < count; i++) ok &= (ht1.get("cuckoo" + to_string(i)) == i);
+        for (size_t i = 0; i < 1000; i++) ok &= !ht1.contains("absent" + to_string(i));
+
+        OUTSTREAM << "Step 3: Remove the even keys, then reuse their slots through operator[]..." << endl;
+        for (size_t i = 0; i < count; i += 2) ok &= ht1.remove("cuckoo" + to_string(i));
+        ok &= !ht1.remove("cuckoo0");
+        for (size_t i = 0; i < count; i += 2) ht1["again" + to_string(i)] += 9999;
+        ok &= (ht1.size() == count && ht1.keys().size() == count);
+        for (size_t i = 0; i < count; i++) {
+            ok &= (i % 2 == 0) ? (!ht1.contains("cuckoo" + to_string(i)) && ht1.get("again" + to_string(i)) == 9999u)
+                               : (ht1.get("cuckoo" + to_string(i)) == i);
+        }
+
+        OUTSTREAM << (ok ? "SUCCESS: cuckoo table stays correct above 0.9 load through churn."
+                         : "FAILURE: cuckoo table lost, duplicated or misreported a key.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST CUCKOO ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // CHAINED TABLE (inline buckets, pooled overflow blocks)
+    // =====================================================================
+    OUTSTREAM << "Testing ChainedHashTable insert / remove / get" << endl;
+    OUTSTREAM << "----------------------------------------------" << endl << endl;
+#ifdef HT_CHAINED
+    try {
+        ChainedHashTable ht1;
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: Insert 20000 keys, noting the load factor each time the table resizes..." << endl;
+        const size_t count = 20000;
+        double lowestFill = 2.0;
+        for (size_t i = 0; i < count; i++) {
+            size_t before = ht1.capacity();
+            double fill = ht1.alpha();
+            ok &= ht1.insert("chained" + to_string(i), i);
+            if (ht1.capacity() != before && before >= 1024) lowestFill = min(lowestFill, fill);
+        }
+        ok &= !ht1.insert("chained7", 1); // duplicate
+        ok &= ht1.insert("nines", 9999) && ht1.get("nines") == 9999u && ht1.remove("nines");
+        OUTSTREAM << "  capacity " << ht1.capacity() << ", lowest load at a resize " << lowestFill << ", "
+                  << ht1.overflowBlocks() << " overflow blocks" << endl;
+        ok &= (ht1.size() == count && lowestFill > 0.99 && ht1.overflowBlocks() > 0);
+        for (size_t i = 0; i < count; i++) ok &= (ht1.get("chained" + to_string(i)) == i);
+        for (size_t i = 0; i < 1000; i++) ok &= !ht1.contains("absent" + to_string(i));
+
+        OUTSTREAM << "Step 2: 200000 random removes and inserts, checked against a plain array..." << endl;
+        vector<optional<size_t>> expected(2 * count);
+        for (size_t i = 0; i < count; i++) expected[i] = i;
+        mt19937_64 rng(17);
+        size_t live = count;
+        for (size_t step = 0; step < 200000; step++) {
+            size_t k = rng() % expected.size();
+            string key = "chained" + to_string(k);
+            if (expected[k]) {
+                ok &= ht1.remove(key) && !ht1.remove(key);
+                expected[k].reset();
+                --live;
+            } else {
+                ok &= ht1.insert(key, step);
+                expected[k] = step;
+                ++live;
+            }
+        }
+        for (size_t k = 0; k < expected.size(); k++) ok &= (ht1.get("chained" + to_string(k)) == expected[k]);
+        ok &= (ht1.size() == live && ht1.keys().size() == live);
+        OUTSTREAM << "  " << live << " keys, " << ht1.overflowBlocks() << " overflow blocks, "
+                  << ht1.resizes() << " resizes" << endl;
+
+        OUTSTREAM << "Step 3: Remove all but 100 keys; the table shrinks and frees its blocks..." << endl;
+        size_t kept = 0;
+        for (size_t k = 0; k < expected.size(); k++) {
+            if (!expected[k]) continue;
+            if (kept < 100) {
+                ++kept;
+                continue;
+            }
+            ok &= ht1.remove("chained" + to_string(k));
+            expected[k].reset();
+        }
+        OUTSTREAM << "  capacity " << ht1.capacity() << ", " << ht1.overflowBlocks() << " overflow blocks" << endl;
+        ok &= (ht1.size() == 100 && ht1.capacity() <= 512 && ht1.overflowBlocks() < 10);
+        for (size_t k = 0; k < expected.size(); k++) ok &= (ht1.get("chained" + to_string(k)) == expected[k]);
+
+        OUTSTREAM << "Step 4: operator[] adds and updates; a reserved table keeps its size when emptied..." << endl;
+        for (size_t i = 0; i < 1000; i++) ht1["bracket" + to_string(i % 100)] += 1;
+        for (size_t i = 0; i < 100; i++) ok &= (ht1.get("bracket" + to_string(i)) == 10u);
+        ChainedHashTable ht2(8, 2.0);
+        ht2.reserve(4000);
+        const size_t reserved = ht2.capacity();
+        for (size_t i = 0; i < 4000; i++) ok &= ht2.insert("r" + to_string(i), i);
+        ok &= (ht2.capacity() == reserved && ht2.alpha() > 1.0);
+        for (size_t i = 0; i < 4000; i++) ok &= ht2.remove("r" + to_string(i));
+        ok &= (ht2.capacity() == reserved && ht2.size() == 0 && ht2.overflowBlocks() == 0);
+
+        OUTSTREAM << (ok ? "SUCCESS: chained table stays correct through churn, growth and shrinking."
+                         : "FAILURE: chained table lost, duplicated or misreported a key.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST CHAINED ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // CONCURRENT COUNTER TABLE (atomic counts, CAS claims, merge)
+    // =====================================================================
+    OUTSTREAM << "Testing ConcurrentCounterTable increment / merge" << endl;
+    OUTSTREAM << "------------------------------------------------" << endl << endl;
+#ifdef HT_COUNTER
+    try {
+        ConcurrentCounterTable counts(500);
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: 4 threads each count 300 words 50 times over, starting at different words..." << endl;
+        const size_t words = 300, rounds = 50, threads = 4;
+        vector<string> vocab;
+        for (size_t i = 0; i < words; i++) vocab.push_back(i % 3 ? "word" + to_string(i) : string(30, 'w') + to_string(i));
+        vector<thread> workers;
+        vector<char> threadOk(threads, 1);
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                for (size_t r = 0; r < rounds; r++)
+                    for (size_t i = 0; i < words; i++) threadOk[t] &= counts.increment(vocab[(i + 77 * t) % words]);
+            });
+        }
+        for (auto& w : workers) w.join();
+        for (char t : threadOk) ok &= (t != 0);
+        ok &= (counts.size() == words);
+        for (const auto& w : vocab) ok &= (counts.get(w) == threads * rounds);
+        ok &= !counts.contains("absent");
+
+        OUTSTREAM << "Step 2: Merge two thread-local HashTables built with ht[key]++..." << endl;
+        HashTable local1, local2;
+        for (size_t i = 0; i < words; i++) {
+            local1[vocab[i]] += i;
+            local2["new" + to_string(i)]++;
+        }
+        ok &= counts.merge(local1) && counts.merge(local2);
+        for (size_t i = 0; i < words; i++) {
+            ok &= (counts.get(vocab[i]) == threads * rounds + i);
+            ok &= (counts.get("new" + to_string(i)) == 1u);
+        }
+        size_t visited = 0, total = 0;
+        counts.forEach([&](string_view, size_t c) { visited++; total += c; });
+        OUTSTREAM << "  " << counts.size() << " keys in " << counts.capacity() << " slots, " << total << " counted" << endl;
+        ok &= (visited == 2 * words && total == words * threads * rounds + words * (words - 1) / 2 + words);
+
+        OUTSTREAM << "Step 3: A full table refuses new keys but keeps counting existing ones..." << endl;
+        ConcurrentCounterTable tiny(4);
+        size_t accepted = 0;
+        for (size_t i = 0; i < 100; i++) accepted += tiny.increment("k" + to_string(i));
+        ok &= (accepted == tiny.size() && accepted < 100 && tiny.increment("k0", 5) && tiny.get("k0") == 6u);
+        ConcurrentCounterTable copy(1000);
+        ok &= copy.merge(counts) && copy.get(vocab[1]) == counts.get(vocab[1]) && copy.size() == counts.size();
+
+        OUTSTREAM << (ok ? "SUCCESS: concurrent counts are exact and merges add up."
+                         : "FAILURE: a concurrent count or merge was lost.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST COUNTER ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // SHARED MEMORY TABLE (one writer, read-only attachments, seqlock)
+    // =====================================================================
+    OUTSTREAM << "Testing SharedHashTable insert / get across mappings" << endl;
+    OUTSTREAM << "----------------------------------------------------" << endl << endl;
+#ifdef HT_SHARED
+    try {
+        bool ok = true;
+        const string name = "/hashtable-test-" + to_string(getpid());
+        auto keyOf = [](size_t i) { return (i % 2 ? "a-key-past-the-inline-buffer-" : "k") + to_string(i); };
+
+        OUTSTREAM << "Step 1: The writer adds 1000 keys; a second mapping attached by name sees them..." << endl;
+        SharedHashTable writer(name, 1000, 32 * 1000);
+        ok &= writer.isOpen() && writer.isWriter();
+        for (size_t i = 0; i < 1000; i++) ok &= writer.insert(keyOf(i), i);
+        ok &= !writer.insert(keyOf(7), 70) && writer.get(keyOf(7)) == 7u;
+        SharedHashTable reader(name);
+        OUTSTREAM << "  " << reader.size() << " keys in " << reader.capacity() << " slots, "
+                  << reader.segmentBytes() << "-byte segment" << endl;
+        ok &= reader.isOpen() && !reader.isWriter() && reader.size() == 1000 && reader.capacity() == 2048;
+        for (size_t i = 0; i < 1000; i++) ok &= (reader.get(keyOf(i)) == i);
+        ok &= !reader.contains("absent") && !reader.insert("absent", 1) && !reader.remove(keyOf(0));
+
+        OUTSTREAM << "Step 2: remove and assign by the writer show through the reader's mapping..." << endl;
+        for (size_t i = 0; i < 1000; i += 3) ok &= writer.remove(keyOf(i));
+        for (size_t i = 1; i < 1000; i += 3) ok &= writer.assign(keyOf(i), i + 5000);
+        ok &= writer.assign("added-by-assign", 9);
+        ok &= (reader.size() == 1000 - 334 + 1 && reader.get("added-by-assign") == 9u);
+        for (size_t i = 0; i < 1000; i++) {
+            optional<size_t> expected;
+            if (i % 3 == 1) expected = i + 5000;
+            else if (i % 3 == 2) expected = i;
+            ok &= (reader.get(keyOf(i)) == expected);
+        }
+
+        OUTSTREAM << "Step 3: The table refuses keys past maxEntries or past the key arena..." << endl;
+        const string small = name + "-small";
+        SharedHashTable full(small, 16, 64);
+        size_t accepted = 0;
+        for (size_t i = 0; i < 40; i++) accepted += full.insert("s" + to_string(i), i);
+        ok &= (accepted == 16 && full.size() == 16);
+        ok &= full.remove("s0") && !full.insert(string(70, 'x'), 1) && full.insert("s99", 99);
+
+        OUTSTREAM << "Step 4: Churn reuses removed slots and arena bytes by rewriting the segment..." << endl;
+        for (size_t round = 0; round < 200; round++) {
+            for (size_t i = 0; i < 8; i++) ok &= full.remove("s" + to_string(i + 1));
+            for (size_t i = 0; i < 8; i++) ok &= full.insert("s" + to_string(i + 1), round);
+        }
+        SharedHashTable smallReader(small);
+        ok &= (smallReader.size() == 16 && smallReader.get("s8") == 199u && smallReader.get("s99") == 99u);
+
+        OUTSTREAM << "Step 5: A reader thread never sees a torn value while the writer keeps assigning..." << endl;
+        atomic<bool> done{false};
+        size_t bad = 0, reads = 0;
+        thread readerThread([&] {
+            while (!done.load()) {
+                for (size_t i = 1; i < 1000; i += 3) {
+                    optional<size_t> v = reader.get(keyOf(i));
+                    bad += !v || *v % 1000 != i % 1000;
+                    ++reads;
+                }
+            }
+        });
+        for (size_t round = 0; round < 200; round++) {
+            for (size_t i = 1; i < 1000; i += 3) writer.assign(keyOf(i), round * 1000 + i);
+            writer.insert("churn" + to_string(round), round);
+            writer.remove("churn" + to_string(round));
+        }
+        done = true;
+        readerThread.join();
+        OUTSTREAM << "  " << reads << " reads, " << reader.retries() << " retried, " << bad << " wrong" << endl;
+        ok &= (bad == 0 && reads > 0 && reader.get(keyOf(1)) == 199001u);
+
+        OUTSTREAM << "Step 6: Attaching to a missing segment leaves the table closed..." << endl;
+        ok &= SharedHashTable::unlink(name) && SharedHashTable::unlink(small);
+        SharedHashTable missing(name);
+        ok &= !missing.isOpen() && !missing.get("k0") && missing.size() == 0;
+        ok &= (reader.get(keyOf(2)) == 2u); // existing mappings outlive the name
+
+        OUTSTREAM << (ok ? "SUCCESS: every mapping of the segment agrees with its writer."
+                         : "FAILURE: a reader missed or misread an entry of the shared segment.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST SHARED ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // SERVER (RESP parsing, pipelined commands over a Unix socket)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTableResp and HashTableServer" << endl;
+    OUTSTREAM << "-----------------------------------------" << endl << endl;
+#ifdef HT_SERVER
+    try {
+        bool ok = true;
+
+        OUTSTREAM << "Step 1: parse() takes every complete request and leaves a partial one..." << endl;
+        const string pipelined = "*2\r\n$3\r\nGET\r\n$1\r\nk\r\nEXISTS a  b\r\n*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$5\r\nhe";
+        HashTableResp::Batch batch;
+        size_t used = HashTableResp::parse(pipelined, batch);
+        ok &= (batch.commands.size() == 2 && !batch.error && used == pipelined.find("*3"));
+        ok &= (batch.argsOf(batch.commands[1]).size() == 3 && batch.args[4] == "b");
+        batch.clear();
+        ok &= (HashTableResp::parse("*1\r\n$x\r\n", batch) == 0 && batch.error != nullptr);
+        ok &= (HashTableResp::replyLength("*2\r\n$1\r\na\r\n$-1\r\n:1") == 16 && HashTableResp::replyLength("$5\r\nab") == 0);
+
+        OUTSTREAM << "Step 1b: A request fed a few bytes at a time resumes where parsing stopped..." << endl;
+        const string whole = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\nvalue\r\nPING\r\n";
+        HashTableResp::Resume resume;
+        string arrived;
+        size_t commands = 0;
+        for (size_t at = 0; at < whole.size(); at += 3) {
+            arrived += whole.substr(at, 3);
+            batch.clear();
+            size_t taken = HashTableResp::parse(arrived, batch, &resume);
+            if (arrived.size() == 21) ok &= (resume.argsLeft == 2 && resume.pos == 13 && resume.args.size() == 1);
+            for (const auto& command : batch.commands) {
+                auto args = batch.argsOf(command);
+                ok &= commands++ == 0 ? (args.size() == 3 && args[1] == "key" && args[2] == "value")
+                                      : (args.size() == 1 && args[0] == "PING");
+            }
+            arrived.erase(0, taken);
+        }
+        ok &= (commands == 2 && arrived.empty() && resume.argsLeft == 0 && !batch.error);
+
+        OUTSTREAM << "Step 2: Serve on a Unix socket; send one pipeline split mid-request..." << endl;
+        const string path = "/tmp/hashtable-test-" + to_string(getpid()) + ".sock";
+        HashTableServer server;
+        server.setQueryBufferLimit(HashTableServer::READ_CHUNK);
+        ok &= server.listenUnix(path);
+        thread serving([&] { ok &= server.run(); });
+
+        auto connectClient = [&] {
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+            if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) throw runtime_error("connect failed");
+            return fd;
+        };
+        auto sendText = [](int fd, const string& text) { return send(fd, text.data(), text.size(), 0) == ssize_t(text.size()); };
+        auto receive = [](int fd, size_t length) { // until length bytes, or end of stream
+            string in;
+            char chunk[4096];
+            while (in.size() < length) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) break;
+                in.append(chunk, n);
+            }
+            return in;
+        };
+
+        int client = connectClient();
+        const string requests = "*3\r\n$3\r\nSET\r\n$5\r\nalpha\r\n$5\r\nfirst\r\n"
+                                "SET beta second\r\n"
+                                "GET alpha\r\nGET gamma\r\n*3\r\n$4\r\nMGET\r\n$4\r\nbeta\r\n$5\r\ngamma\r\n"
+                                "EXISTS alpha beta gamma\r\nDEL alpha gamma\r\nget alpha\r\nPING\r\nFLUSHALL\r\nGET\r\n";
+        const string expected = "+OK\r\n+OK\r\n$5\r\nfirst\r\n$-1\r\n*2\r\n$6\r\nsecond\r\n$-1\r\n:2\r\n:1\r\n$-1\r\n+PONG\r\n"
+                                "-ERR unknown command 'FLUSHALL'\r\n-ERR wrong number of arguments for 'get' command\r\n";
+        const size_t split = requests.find("first") + 2;
+        ok &= sendText(client, requests.substr(0, split));
+        this_thread::sleep_for(chrono::milliseconds(20));
+        ok &= sendText(client, requests.substr(split));
+        string replies = receive(client, expected.size());
+        OUTSTREAM << "  " << replies.size() << " reply bytes, " << (replies == expected ? "as expected" : "NOT as expected") << endl;
+        ok &= (replies == expected);
+
+        OUTSTREAM << "Step 3: QUIT answers +OK and closes; a protocol error is answered, then closes..." << endl;
+        ok &= sendText(client, "QUIT\r\nGET beta\r\n");
+        ok &= (receive(client, SIZE_MAX) == "+OK\r\n");
+        close(client);
+        client = connectClient();
+        ok &= sendText(client, "GET beta\r\n*1\r\n$x\r\n");
+        ok &= (receive(client, SIZE_MAX) == "$6\r\nsecond\r\n-ERR Protocol error: invalid bulk length\r\n");
+        close(client);
+
+        OUTSTREAM << "Step 3b: A request growing past the query buffer limit closes the connection..." << endl;
+        client = connectClient();
+        const string huge = "*3\r\n$3\r\nSET\r\n$4\r\nhuge\r\n$200000\r\n" + string(100000, 'x');
+        ssize_t sent = send(client, huge.data(), huge.size(), MSG_NOSIGNAL);
+        ok &= (sent > 0 && receive(client, SIZE_MAX).empty());
+        close(client);
+
+        OUTSTREAM << "Step 4: stop() from this thread ends run()..." << endl;
+        server.stop();
+        serving.join();
+        HashTableServer::Counters counters = server.counters();
+        OUTSTREAM << "  " << counters.connections << " connections, " << counters.commands << " commands, "
+                  << counters.lookups << " lookups in " << counters.lookupBatches << " batches" << endl;
+        ok &= (counters.connections == 3 && counters.protocolErrors == 1 && server.size() == 1);
+        ok &= (counters.queryBufferCloses == 1);
+        ok &= (counters.lookups == 9 && counters.lookupBatches == 3);
+
+        OUTSTREAM << (ok ? "SUCCESS: pipelined requests get their replies in order, byte for byte."
+                         : "FAILURE: the server's replies were wrong or out of order.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST SERVER ***" << endl << endl;
+#endif
+
+    // =====================================================================
+    // STATISTICS (probe histograms, counters, exporters)
+    // =====================================================================
+    OUTSTREAM << "Testing HashTable::stats() and exporters" << endl;
+    OUTSTREAM << "----------------------------------------" << endl << endl;
+#ifdef HT_STATS
+    try {
+        HashTable ht1;
+        OUTSTREAM << "Inserting " << MAXHASH << " entries, removing one, then looking up hits and misses..." << endl;
+        for (size_t i = 1; i <= MAXHASH; i++)
+            ht1.insert(make_key<key_type>(i), make_value<value_type>(i));
+        ht1.remove(make_key<key_type>(1));
+        for (size_t i = 2; i <= MAXHASH; i++)
+            ht1.get(make_key<key_type>(i));
+        ht1.get(make_key<key_type>(MAXHASH + 5));
+        ht1.contains(make_key<key_type>(MAXHASH + 6));
+
+        HashTableStats st = ht1.stats();
+        uint64_t hits = 0, misses = 0;
+        for (size_t b = 0; b < HashTableStats::PROBE_BUCKETS; b++) {
+            hits += st.hitProbes[b];
+            misses += st.missProbes[b];
+        }
+        OUTSTREAM << "  inserts = " << st.inserts << ", removes = " << st.removes
+                  << ", tombstones = " << st.tombstones << ", resizes = " << st.resizes << endl;
+        OUTSTREAM << "  hit histogram total = " << hits << ", miss histogram total = " << misses
+                  << ", max probe = " << st.maxProbe << endl;
+
+        string prom = st.toPrometheus();
+        string json = st.toJSON();
+        HashTableStats large = st;
+        large.size = 1234567;
+        large.resizes = 98765432123;
+        string largeProm = large.toPrometheus();
+        bool ok = st.enabled && st.inserts == MAXHASH && st.removes == 1 && st.tombstones == ht1.tombstones()
+                  && hits == MAXHASH - 1 && misses == 2 && st.getHits == MAXHASH - 1
+                  && prom.find("hashtable_hit_probe_length_bucket{le=\"+Inf\"} " + to_string(MAXHASH - 1)) != string::npos
+                  && json.find("\"tombstones\": " + to_string(st.tombstones)) != string::npos
+                  && largeProm.find("\nhashtable_size 1234567\n") != string::npos
+                  && largeProm.find("\nhashtable_resizes_total 98765432123\n") != string::npos;
+        OUTSTREAM << (ok ? "SUCCESS: stats() counters, histograms and exporters agree."
+                         : "FAILURE: stats() reported inconsistent figures.")
+                  << endl << endl;
+    } catch (exception& e) {
+        OUTSTREAM << "Exception: " << e.what() << endl << endl;
+    }
+#else
+    OUTSTREAM << "*** DID NOT TEST STATS ***" << endl << endl;
+#endif
+
     OUTSTREAM << "All tests complete." << endl;
     return 0;
 }
@@ -0,0 +1,159 @@
+/*
+// HashTableTimerWheel.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Hierarchical timing wheel used for active TTL expiry.  Slot index at level L
+// is (tick >> (L * LEVEL_BITS)) % SLOTS, as in the classic Linux timer wheel.
+*/
+
+#include "HashTableTimerWheel.h"
+#include <algorithm>
+#include <utility>
+
+namespace std {
+
+   HashTableTimerWheel::HashTableTimerWheel(uint64_t tickMillis)
+       : tickMillis(tickMillis > 0 ? tickMillis : 1) {}
+
+   // Round up so a timer never fires before its expiry
+   uint64_t HashTableTimerWheel::tickOf(uint64_t expiresAt) const {
+      return (expiresAt + tickMillis - 1) / tickMillis;
+   }
+
+   // File a timer at the lowest level whose span covers its distance from now
+   void HashTableTimerWheel::place(Timer&& timer) {
+      uint64_t tick = tickOf(timer.expiresAt);
+      if (tick < current) {
+         overdue.push_back(std::move(timer));
+         return;
+      }
+      uint64_t distance = tick - current;
+      size_t level = 0;
+      while (level + 1 < LEVELS && distance >= (uint64_t{1} << ((level + 1) * LEVEL_BITS))) {
+         ++level;
+      }
+      // Beyond the top level's span: park in its farthest slot until a cascade
+      uint64_t span = uint64_t{1} << (LEVELS * LEVEL_BITS);
+      if (distance >= span) {
+         tick = current + span - 1;
+      }
+      size_t slot = (tick >> (level * LEVEL_BITS)) & (SLOTS - 1);
+      slots[level * SLOTS + slot].push_back(std::move(timer));
+      ++counts[level];
+   }
+
+   // Re-file every timer in the level's slot for the current tick one level down
+   void HashTableTimerWheel::cascade(size_t level) {
+      size_t slot = (current >> (level * LEVEL_BITS)) & (SLOTS - 1);
+      std::vector<Timer> moving = std::move(slots[level * SLOTS + slot]);
+      slots[level * SLOTS + slot].clear();
+      counts[level] -= moving.size();
+      for (auto& timer : moving) {
+         place(std::move(timer));
+      }
+   }
+
+   void HashTableTimerWheel::schedule(std::string_view key, uint64_t expiresAt, uint64_t now) {
+      if (slots.empty()) {
+         slots.resize(LEVELS * SLOTS);
+         current = now / tickMillis;
+      }
+      place(Timer{std::string(key), expiresAt});
+   }
+
+   /*
+    * Process ticks up to now, calling fire for each due timer.  Stops after
+    * maxFired timers and picks up from the same spot on the next call.  Runs
+    * of ticks with nothing filed at the lower levels are skipped in one step.
+    * Returns the number of timers fired.
+    */
+   size_t HashTableTimerWheel::advance(uint64_t now, size_t maxFired, const FireFn& fire) {
+      if (slots.empty()) return 0;
+      uint64_t target = now / tickMillis;
+      size_t fired = 0;
+
+      while (!overdue.empty()) {
+         if (fired == maxFired) return fired;
+         Timer timer = std::move(overdue.back());
+         overdue.pop_back();
+         fire(timer.key, timer.expiresAt);
+         ++fired;
+      }
+
+      while (current <= target) {
+         if (!cascaded) {
+            for (size_t level = LEVELS - 1; level > 0; --level) {
+               if ((current & ((uint64_t{1} << (level * LEVEL_BITS)) - 1)) == 0) {
+                  cascade(level);
+               }
+            }
+            cascaded = true;
+         }
+
+         std::vector<Timer>& due = slots[current & (SLOTS - 1)];
+         while (drained < due.size()) {
+            if (fired == maxFired) return fired;
+            // Moved out first: fire may schedule into this same slot
+            Timer timer = std::move(due[drained++]);
+            fire(timer.key, timer.expiresAt);
+            ++fired;
+         }
+         counts[0] -= due.size();
+         due.clear();
+         drained = 0;
+
+         // With levels below L empty, nothing happens until the next level-L
+         // boundary (or at all, when every level is empty)
+         size_t empty = 0;
+         while (empty < LEVELS && counts[empty] == 0) ++empty;
+         uint64_t next = current + 1;
+         if (empty == LEVELS) {
+            next = target + 1;
+         } else if (empty > 0) {
+            uint64_t width = uint64_t{1} << (empty * LEVEL_BITS);
+            next = std::min((current / width + 1) * width, target + 1);
+         }
+         current = std::max(next, current + 1);
+         cascaded = false;
+      }
+      return fired;
+   }
+
+   size_t HashTableTimerWheel::pending() const {
+      size_t total = 0;
+      for (size_t c : counts) total += c;
+      return total - drained + overdue.size();
+   }
+
+   /*
+    * Walks every slot, so it costs O(timers); keys past the inline string
+    * buffer count their heap storage too.
+    */
+   size_t HashTableTimerWheel::bytes() const {
+      static const size_t inlineCapacity = std::string().capacity();
+      auto timerBytes = [&](const std::vector<Timer>& timers) {
+         size_t total = timers.capacity() * sizeof(Timer);
+         for (const auto& timer : timers) {
+            if (timer.key.capacity() > inlineCapacity) total += timer.key.capacity() + 1;
+         }
+         return total;
+      };
+      size_t total = slots.capacity() * sizeof(std::vector<Timer>) + timerBytes(overdue);
+      for (const auto& slot : slots) total += timerBytes(slot);
+      return total;
+   }
+
+   void HashTableTimerWheel::clear() {
+      slots.clear();
+      overdue.clear();
+      counts.fill(0);
+      current = 0;
+      cascaded = false;
+      drained = 0;
+   }
+
+}
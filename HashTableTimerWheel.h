@@ -0,0 +1,78 @@
+/*
+// HashTableTimerWheel.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Hierarchical timing wheel that tells a HashTable which keys are due to
+// expire, so expired entries are reclaimed without scanning the bucket array.
+// Time is cut into ticks of tickMillis.  Level 0 has one slot per tick for the
+// next SLOTS ticks; each higher level has slots SLOTS times as wide.  A timer
+// is filed at the lowest level whose span reaches its expiry, and when the
+// current tick enters a wider slot, that slot is cascaded down a level.
+// Timers past the top level's span wait in its farthest slot and are filed
+// again on each cascade.  advance() fires at most maxFired timers per call and
+// resumes where it stopped, so expiry work comes in small, bounded steps.
+// Timers are never cancelled: the owner checks each fired key against the
+// entry's current expiry and ignores stale ones.
+// Actionable members include:
+// - schedule - file a key to fire once the clock reaches expiresAt
+// - advance - fire due timers up to now, at most maxFired of them
+// - pending - timers filed and not yet fired
+// - bytes - heap memory held by the slots and their timers
+// - clear - drop every timer
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLETIMERWHEEL_H
+#define PROJECT4_HASHTABLE_HASHTABLETIMERWHEEL_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    class HashTableTimerWheel {
+    public:
+        static constexpr size_t LEVEL_BITS = 6;
+        static constexpr size_t SLOTS = size_t{1} << LEVEL_BITS;
+        static constexpr size_t LEVELS = 4;
+
+        using FireFn = std::function<void(std::string_view key, uint64_t expiresAt)>;
+
+    private:
+        struct Timer {
+            std::string key;
+            uint64_t expiresAt;
+        };
+
+        uint64_t tickMillis;
+        uint64_t current = 0;     // next tick to process
+        bool cascaded = false;    // current tick's cascades already done
+        size_t drained = 0;       // timers of the current level-0 slot already fired
+        std::array<size_t, LEVELS> counts{};
+        std::vector<std::vector<Timer>> slots; // LEVELS * SLOTS, allocated on first schedule
+        std::vector<Timer> overdue;            // filed for a tick already processed
+
+        uint64_t tickOf(uint64_t expiresAt) const;
+        void place(Timer&& timer);
+        void cascade(size_t level);
+
+    public:
+        explicit HashTableTimerWheel(uint64_t tickMillis = 1);
+
+        void schedule(std::string_view key, uint64_t expiresAt, uint64_t now);
+        size_t advance(uint64_t now, size_t maxFired, const FireFn& fire);
+
+        size_t pending() const;
+        size_t bytes() const;
+        void clear();
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLETIMERWHEEL_H
@@ -0,0 +1,125 @@
+/*
+// HashTableTrace.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Memory-mapped ring file behind HashTableTrace, and reading it back.
+*/
+
+#include "HashTableTrace.h"
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace std {
+
+   static constexpr char TRACE_MAGIC[8] = {'H', 'T', 'T', 'R', 'A', 'C', 'E', '1'};
+
+   /*
+    * Create (or truncate) path and map it: a 64-byte header, then capacity
+    * records, rounded up to a power of two.  If the file cannot be created
+    * or mapped the trace stays closed and record() does nothing.
+    */
+   HashTableTrace::HashTableTrace(const std::string& path, size_t capacity) {
+      const size_t slots = std::bit_ceil(std::max<size_t>(capacity, 1));
+      fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      if (fd < 0) return;
+      mappedBytes = sizeof(Header) + slots * sizeof(HashTableTraceRecord);
+      if (::ftruncate(fd, static_cast<off_t>(mappedBytes)) < 0) return;
+      void* mapping = ::mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (mapping == MAP_FAILED) return;
+
+      header = static_cast<Header*>(mapping);
+      std::memcpy(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+      header->capacity = slots;
+      header->written = 0;
+      startTime = std::chrono::steady_clock::now();
+      startTicks = nowTicks();
+      header->startTicks = startTicks;
+      header->tickNanos = 0;
+      records = reinterpret_cast<HashTableTraceRecord*>(header + 1);
+      mask = slots - 1;
+   }
+
+   HashTableTrace::~HashTableTrace() {
+      if (header) {
+         flush();
+         ::munmap(header, mappedBytes);
+      }
+      if (fd >= 0) ::close(fd);
+   }
+
+   bool HashTableTrace::isOpen() const {
+      return records != nullptr;
+   }
+
+   /*
+    * Record how long a tick is, measured against steady_clock since the
+    * trace was opened, and sync the mapping to the file.
+    */
+   bool HashTableTrace::flush() {
+      if (!header) return false;
+      const uint64_t ticks = nowTicks() - startTicks;
+      const double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+      if (ticks > 0) header->tickNanos = nanos / static_cast<double>(ticks);
+      return ::msync(header, mappedBytes, MS_SYNC) == 0;
+   }
+
+   uint64_t HashTableTrace::recorded() const {
+      return written;
+   }
+
+   size_t HashTableTrace::capacity() const {
+      return records ? mask + 1 : 0;
+   }
+
+   /*
+    * Read a trace file, unrolling the ring so the oldest surviving record
+    * comes first.  Returns nullopt if the file is missing, is not a trace,
+    * or is shorter than its header says.
+    */
+   std::optional<HashTableTraceData> HashTableTrace::load(const std::string& path) {
+      std::ifstream file(path, std::ios::binary);
+      Header h;
+      if (!file.read(reinterpret_cast<char*>(&h), sizeof(h))) return std::nullopt;
+      if (std::memcmp(h.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || !std::has_single_bit(h.capacity)) {
+         return std::nullopt;
+      }
+
+      std::vector<HashTableTraceRecord> ring(std::min<uint64_t>(h.written, h.capacity));
+      if (!file.read(reinterpret_cast<char*>(ring.data()),
+                     static_cast<std::streamsize>(ring.size() * sizeof(HashTableTraceRecord)))) {
+         return std::nullopt;
+      }
+
+      HashTableTraceData data;
+      data.tickNanos = h.tickNanos;
+      if (h.written > h.capacity) {
+         data.overwritten = h.written - h.capacity;
+         std::rotate(ring.begin(), ring.begin() + static_cast<ptrdiff_t>(h.written & (h.capacity - 1)), ring.end());
+      }
+      data.records = std::move(ring);
+      return data;
+   }
+
+   /*
+    * A key of the record's length made of its hash bytes, repeated.  Equal
+    * keys get equal replay keys.  Two different keys can share one only if
+    * they are under 8 bytes long and their hashes agree on that many bytes.
+    */
+   std::string HashTableTrace::keyFor(const HashTableTraceRecord& record) {
+      char bytes[sizeof(record.keyHash)];
+      const uint64_t keyHash = record.keyHash;
+      std::memcpy(bytes, &keyHash, sizeof(bytes));
+      std::string key(record.keyLength, '\0');
+      for (size_t i = 0; i < key.size(); ++i) key[i] = bytes[i % sizeof(bytes)];
+      return key;
+   }
+
+}
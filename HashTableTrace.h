@@ -0,0 +1,133 @@
+/*
+// HashTableTrace.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Optional operation trace for a HashTable, for replaying real traffic
+// against other table configurations offline (HashTableTraceReplay).  Every
+// insert, get, remove and operator[] call on a table with a trace attached
+// becomes one 16-byte record: the key's std::hash and length, the operation,
+// and a timestamp.  Keys themselves are not kept, so a trace is safe to copy
+// off a production box; replay makes up a key of the same length from the
+// hash, which keeps the key distribution and access pattern intact.
+// Records go into a memory-mapped file used as a ring: once it is full the
+// oldest records are overwritten, so a trace always holds the most recent
+// capacity() operations.  Recording is a few stores into the mapping with
+// no system call; the kernel writes the pages back.  Timestamps are raw
+// ticks (the TSC on x86) whose length in nanoseconds is measured between
+// opening the trace and flush(); the clock is read once per 16 records.
+// Actionable members include:
+// - record - append one operation (HashTable calls this)
+// - flush - write the tick rate to the header and sync the file
+// - recorded / capacity - operations seen so far, and records kept
+// - load - read a trace file back in chronological order
+// - keyFor - the replay key for a record
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLETRACE_H
+#define PROJECT4_HASHTABLE_HASHTABLETRACE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace std {
+
+    enum class TraceOp : uint8_t {
+        INSERT = 1, // insert(key, value)
+        GET = 2,    // get(key), contains(key), or a key of getBatch()
+        REMOVE = 3, // remove(key)
+        ASSIGN = 4  // operator[](key)
+    };
+
+    struct HashTableTraceRecord {
+        uint64_t keyHash;        // std::hash<string_view> of the key
+        uint64_t ticks : 40;     // since the trace was opened
+        uint64_t keyLength : 16; // clamped to 65535
+        uint64_t op : 8;         // a TraceOp
+    };
+    static_assert(sizeof(HashTableTraceRecord) == 16);
+
+    // A trace file read back by HashTableTrace::load
+    struct HashTableTraceData {
+        std::vector<HashTableTraceRecord> records; // oldest first
+        double tickNanos = 0;                      // 0 if the trace was never flushed
+        uint64_t overwritten = 0;                  // records lost to the ring wrapping
+    };
+
+    class HashTableTrace {
+    public:
+        static constexpr size_t DEFAULT_RECORDS = size_t{1} << 20; // 16 MB of records
+
+        explicit HashTableTrace(const std::string& path, size_t capacity = DEFAULT_RECORDS);
+        ~HashTableTrace();
+
+        HashTableTrace(const HashTableTrace&) = delete;
+        HashTableTrace& operator=(const HashTableTrace&) = delete;
+
+        bool isOpen() const;
+
+        void record(TraceOp op, std::string_view key) {
+            if (!records) return;
+            HashTableTraceRecord& r = records[written & mask];
+            r.keyHash = std::hash<std::string_view>{}(key);
+            if ((written & (CLOCK_EVERY - 1)) == 0) lastTicks = nowTicks() - startTicks;
+            r.ticks = lastTicks;
+            r.keyLength = std::min<size_t>(key.size(), 0xFFFF);
+            r.op = static_cast<uint8_t>(op);
+            header->written = ++written;
+        }
+
+        bool flush();
+        uint64_t recorded() const;
+        size_t capacity() const;
+
+        static std::optional<HashTableTraceData> load(const std::string& path);
+        static std::string keyFor(const HashTableTraceRecord& record);
+
+    private:
+        struct Header {
+            char magic[8];
+            uint64_t capacity;
+            uint64_t written;
+            uint64_t startTicks;
+            double tickNanos;
+            uint64_t reserved[3];
+        };
+        static_assert(sizeof(Header) == 64);
+
+        // TSC ticks are shifted down so 40 bits span about a day
+        static constexpr unsigned TICK_SHIFT = 8;
+        // Reading the clock can cost more than the rest of record(), so it is
+        // read once per CLOCK_EVERY records and the others share that time
+        static constexpr uint64_t CLOCK_EVERY = 16;
+
+        int fd = -1;
+        size_t mappedBytes = 0;
+        Header* header = nullptr;
+        HashTableTraceRecord* records = nullptr;
+        size_t mask = 0;
+        uint64_t written = 0;
+        uint64_t startTicks = 0;
+        uint64_t lastTicks = 0;
+        std::chrono::steady_clock::time_point startTime;
+
+        static uint64_t nowTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __builtin_ia32_rdtsc() >> TICK_SHIFT;
+#else
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) >> TICK_SHIFT;
+#endif
+        }
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLETRACE_H
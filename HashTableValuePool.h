@@ -0,0 +1,137 @@
+/*
+// HashTableValuePool.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Chunked object pool that gives large values a permanent address.  Values
+// live in fixed-size chunks that are allocated once and never moved, so a
+// reference to a pooled value stays valid until that value is released, no
+// matter how often the table holding its handle resizes.  Released slots go on
+// a free list and are reused by the next allocation.
+// A handle is the slot number: chunk * CHUNK_SLOTS + slot within the chunk.
+// Actionable members include:
+// - allocate - construct a value in a free slot and return its handle
+// - release - destroy the value and recycle its slot
+// - at - reference to the value behind a handle
+// - size / bytes - live values and bytes reserved by the chunks
+// - clear - destroy every value and return the chunks
+*/
+#ifndef PROJECT4_HASHTABLE_HASHTABLEVALUEPOOL_H
+#define PROJECT4_HASHTABLE_HASHTABLEVALUEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace std {
+
+    template<typename T, size_t CHUNK_SLOTS = 256>
+    class HashTableValuePool {
+    private:
+        struct alignas(T) Slot {
+            std::byte storage[sizeof(T)];
+        };
+
+        std::vector<std::unique_ptr<Slot[]>> chunks;
+        std::vector<size_t> freeList;
+        size_t nextUnused = 0;
+        size_t live = 0;
+
+        Slot& slot(size_t handle) const {
+            return chunks[handle / CHUNK_SLOTS][handle % CHUNK_SLOTS];
+        }
+
+        // Live values are destroyed here; free slots hold no object
+        void destroyAll() {
+            if (live > 0) {
+                std::vector<bool> isFree(nextUnused, false);
+                for (size_t h : freeList) isFree[h] = true;
+                for (size_t h = 0; h < nextUnused; ++h) {
+                    if (!isFree[h]) at(h).~T();
+                }
+            }
+            chunks.clear();
+            freeList.clear();
+            nextUnused = 0;
+            live = 0;
+        }
+
+    public:
+        HashTableValuePool() = default;
+        HashTableValuePool(const HashTableValuePool&) = delete;
+        HashTableValuePool& operator=(const HashTableValuePool&) = delete;
+
+        HashTableValuePool(HashTableValuePool&& other) noexcept
+            : chunks(std::move(other.chunks)), freeList(std::move(other.freeList)),
+              nextUnused(std::exchange(other.nextUnused, 0)), live(std::exchange(other.live, 0)) {}
+
+        HashTableValuePool& operator=(HashTableValuePool&& other) noexcept {
+            if (this != &other) {
+                destroyAll();
+                chunks = std::move(other.chunks);
+                freeList = std::move(other.freeList);
+                nextUnused = std::exchange(other.nextUnused, 0);
+                live = std::exchange(other.live, 0);
+            }
+            return *this;
+        }
+
+        ~HashTableValuePool() {
+            destroyAll();
+        }
+
+        void clear() {
+            destroyAll();
+        }
+
+        // The slot is only taken off the free list (or past nextUnused) once
+        // T's constructor has returned, so a throwing constructor leaves the
+        // pool as it was and destroyAll never sees an unconstructed slot
+        template<typename... Args>
+        size_t allocate(Args&&... args) {
+            const bool reuse = !freeList.empty();
+            if (!reuse && nextUnused == chunks.size() * CHUNK_SLOTS) {
+                chunks.push_back(std::make_unique<Slot[]>(CHUNK_SLOTS));
+            }
+            const size_t handle = reuse ? freeList.back() : nextUnused;
+            ::new (static_cast<void*>(slot(handle).storage)) T(std::forward<Args>(args)...);
+            if (reuse) {
+                freeList.pop_back();
+            } else {
+                ++nextUnused;
+            }
+            ++live;
+            return handle;
+        }
+
+        void release(size_t handle) {
+            at(handle).~T();
+            freeList.push_back(handle);
+            --live;
+        }
+
+        T& at(size_t handle) {
+            return *std::launder(reinterpret_cast<T*>(slot(handle).storage));
+        }
+
+        const T& at(size_t handle) const {
+            return *std::launder(reinterpret_cast<const T*>(slot(handle).storage));
+        }
+
+        size_t size() const {
+            return live;
+        }
+
+        size_t bytes() const {
+            return chunks.size() * CHUNK_SLOTS * sizeof(Slot) + freeList.capacity() * sizeof(size_t);
+        }
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_HASHTABLEVALUEPOOL_H
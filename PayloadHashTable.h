@@ -0,0 +1,216 @@
+/*
+// PayloadHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// HashTable front end for values other than size_t.  The HashTable buckets
+// still only hold a size_t, and how that word is used depends on the storage
+// mode:
+// - INLINE: small trivially copyable values (up to 8 bytes) are bit-copied
+//   straight into the bucket.  Nothing extra is allocated, but like
+//   HashTable::operator[], any reference into the table dies on resize, so
+//   INLINE mode only hands out copies.
+// - POOLED: larger values live in a HashTableValuePool and the bucket holds a
+//   handle.  A resize moves only the 8-byte handles, never the payloads, and
+//   references returned by find()/operator[] stay valid until that key is
+//   removed.
+// The mode is picked from the value type by default and can be forced.
+// Actionable members include:
+// - insert / emplace - add a key with a value, rejecting duplicates
+// - set - insert or overwrite
+// - remove / contains / get - same meaning as on HashTable
+// - find / operator[] (POOLED only) - stable pointer / reference to the value
+// - findBatch (POOLED only) - find() for many keys, through HashTable::getBatch
+*/
+#ifndef PROJECT4_HASHTABLE_PAYLOADHASHTABLE_H
+#define PROJECT4_HASHTABLE_PAYLOADHASHTABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "HashTable.h"
+#include "HashTableValuePool.h"
+
+namespace std {
+
+    enum class ValueStorage {
+        INLINE, // value bits stored in the bucket itself
+        POOLED  // value stored in a pool, bucket holds a stable handle
+    };
+
+    template<typename T>
+    inline constexpr bool fitsInline = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> &&
+                                       sizeof(T) <= sizeof(size_t);
+
+    template<typename T>
+    inline constexpr ValueStorage defaultValueStorage = fitsInline<T> ? ValueStorage::INLINE : ValueStorage::POOLED;
+
+    template<typename T, ValueStorage Storage = defaultValueStorage<T>>
+    class PayloadHashTable {
+        static_assert(Storage == ValueStorage::POOLED || fitsInline<T>,
+                      "INLINE storage needs a trivially copyable value of at most sizeof(size_t) bytes");
+
+    private:
+        static constexpr bool pooled = Storage == ValueStorage::POOLED;
+
+        HashTable index;
+        HashTableValuePool<T> pool;
+
+        static size_t encode(const T& value) {
+            size_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            return bits;
+        }
+
+        static T decode(size_t bits) {
+            T value;
+            std::memcpy(&value, &bits, sizeof(T));
+            return value;
+        }
+
+        // Store a freshly allocated pool handle under key.  If the index
+        // cannot take the key (a table full at MAX_CAPACITY, or out of
+        // memory), the value goes back to the pool before the error propagates.
+        size_t adopt(std::string_view key, size_t handle) {
+            try {
+                index[key] = handle;
+            } catch (...) {
+                pool.release(handle);
+                throw;
+            }
+            return handle;
+        }
+
+    public:
+        static constexpr ValueStorage storage = Storage;
+
+        explicit PayloadHashTable(size_t initCapacity = 8) : index(initCapacity) {}
+
+        // Values go in through operator[] on the index, which unlike
+        // HashTable::insert accepts every word (handles and bit patterns may be 9999)
+        template<typename... Args>
+        bool emplace(std::string_view key, Args&&... args) {
+            if (index.contains(key)) return false;
+            if constexpr (pooled) {
+                adopt(key, pool.allocate(std::forward<Args>(args)...));
+            } else {
+                index[key] = encode(T(std::forward<Args>(args)...));
+            }
+            return true;
+        }
+
+        bool insert(std::string_view key, const T& value) {
+            return emplace(key, value);
+        }
+
+        // Insert or overwrite; returns true if the key was new
+        bool set(std::string_view key, const T& value) {
+            if constexpr (pooled) {
+                if (std::optional<size_t> handle = index.get(key)) {
+                    pool.at(*handle) = value;
+                    return false;
+                }
+                adopt(key, pool.allocate(value));
+                return true;
+            } else {
+                bool added = !index.contains(key);
+                index[key] = encode(value);
+                return added;
+            }
+        }
+
+        bool remove(std::string_view key) {
+            if constexpr (pooled) {
+                std::optional<size_t> handle = index.get(key);
+                if (!handle) return false;
+                index.remove(key);
+                pool.release(*handle);
+                return true;
+            } else {
+                return index.remove(key);
+            }
+        }
+
+        bool contains(std::string_view key) const {
+            return index.contains(key);
+        }
+
+        std::optional<T> get(std::string_view key) const {
+            std::optional<size_t> word = index.get(key);
+            if (!word) return std::nullopt;
+            if constexpr (pooled) {
+                return pool.at(*word);
+            } else {
+                return decode(*word);
+            }
+        }
+
+        // Stable pointer to the stored value, or nullptr if key is absent
+        T* find(std::string_view key) requires (Storage == ValueStorage::POOLED) {
+            std::optional<size_t> handle = index.get(key);
+            return handle ? &pool.at(*handle) : nullptr;
+        }
+
+        const T* find(std::string_view key) const requires (Storage == ValueStorage::POOLED) {
+            std::optional<size_t> handle = index.get(key);
+            return handle ? &pool.at(*handle) : nullptr;
+        }
+
+        // find() for every key; out[i] is nullptr if keys[i] is absent.  The
+        // handles come from HashTable::getBatch, so the lookups' cache
+        // misses overlap instead of following one another.
+        void findBatch(std::span<const std::string_view> keys, std::span<const T*> out) const
+            requires (Storage == ValueStorage::POOLED) {
+            std::array<std::optional<size_t>, HashTable::MAX_BATCH_GROUP> handles;
+            for (size_t at = 0; at < keys.size(); at += handles.size()) {
+                const size_t count = std::min(handles.size(), keys.size() - at);
+                index.getBatch(keys.subspan(at, count), std::span(handles).first(count));
+                for (size_t i = 0; i < count; ++i) out[at + i] = handles[i] ? &pool.at(*handles[i]) : nullptr;
+            }
+        }
+
+        // Stable reference; a missing key is added with a value-initialized T
+        T& operator[](std::string_view key) requires (Storage == ValueStorage::POOLED) {
+            if (std::optional<size_t> handle = index.get(key)) {
+                return pool.at(*handle);
+            }
+            return pool.at(adopt(key, pool.allocate()));
+        }
+
+        void reserve(size_t count, size_t keyCapacity = 0) {
+            index.reserve(count, keyCapacity);
+        }
+
+        size_t size() const {
+            return index.size();
+        }
+
+        size_t capacity() const {
+            return index.capacity();
+        }
+
+        double alpha() const {
+            return index.alpha();
+        }
+
+        std::vector<std::string> keys() const {
+            return index.keys();
+        }
+
+        // Bytes held by the value pool (0 for INLINE)
+        size_t poolBytes() const {
+            return pooled ? pool.bytes() : 0;
+        }
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_PAYLOADHASHTABLE_H
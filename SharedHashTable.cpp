@@ -0,0 +1,308 @@
+/*
+// SharedHashTable.cpp
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Segment layout, the seqlock, and linear probing over control bytes.
+*/
+
+#include "SharedHashTable.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace std {
+
+   static constexpr char SHARED_MAGIC[8] = {'H', 'T', 'S', 'H', 'A', 'R', 'E', '1'};
+
+   // Fields the writer changes while readers may be probing are read and
+   // written as relaxed atomics; the seqlock decides whether a read counts
+   template<typename T>
+   static T loadRelaxed(const T& field) {
+      return __atomic_load_n(&field, __ATOMIC_RELAXED);
+   }
+
+   template<typename T>
+   static void storeRelaxed(T& field, T value) {
+      __atomic_store_n(&field, value, __ATOMIC_RELAXED);
+   }
+
+   /*
+    * Create (or replace) the segment called name, sized for maxEntries keys
+    * at MAX_LOAD and keyBytes of key text, and map it read-write.  If the
+    * segment cannot be created or mapped the table stays closed.
+    */
+   SharedHashTable::SharedHashTable(const std::string& name, size_t maxEntries, size_t keyBytes) : writer(true) {
+      const size_t slotCount =
+         std::bit_ceil(std::max<size_t>(static_cast<size_t>(static_cast<double>(maxEntries) / MAX_LOAD), 8));
+      size_t controlAt, slotsAt, arenaAt;
+      const size_t bytes = layout(slotCount, keyBytes, controlAt, slotsAt, arenaAt);
+      fd = ::shm_open(segmentName(name).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+      if (fd < 0 || ::ftruncate(fd, static_cast<off_t>(bytes)) < 0) return;
+      void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (mapping == MAP_FAILED) return;
+      mappedBytes = bytes;
+
+      // A new segment is zero-filled, so every control byte is already EMPTY
+      Header* h = static_cast<Header*>(mapping);
+      h->sequence.store(0, std::memory_order_relaxed);
+      h->capacity = slotCount;
+      h->maxEntries = std::min(maxEntries, slotCount / 2);
+      h->size = 0;
+      h->removed = 0;
+      h->arenaBytes = keyBytes;
+      h->arenaUsed = 0;
+      std::atomic_thread_fence(std::memory_order_release);
+      std::memcpy(h->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC));
+      attach(mapping);
+   }
+
+   /*
+    * Attach to the segment called name read-only.  The table stays closed if
+    * there is no such segment or it is not a complete SharedHashTable.
+    */
+   SharedHashTable::SharedHashTable(const std::string& name) {
+      fd = ::shm_open(segmentName(name).c_str(), O_RDONLY, 0);
+      struct stat st;
+      if (fd < 0 || ::fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) return;
+      const size_t bytes = static_cast<size_t>(st.st_size);
+      void* mapping = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+      if (mapping == MAP_FAILED) return;
+
+      const Header* h = static_cast<const Header*>(mapping);
+      size_t controlAt, slotsAt, arenaAt;
+      if (std::memcmp(h->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) != 0 || !std::has_single_bit(h->capacity) ||
+          layout(h->capacity, h->arenaBytes, controlAt, slotsAt, arenaAt) != bytes) {
+         ::munmap(mapping, bytes);
+         return;
+      }
+      mappedBytes = bytes;
+      attach(mapping);
+   }
+
+   SharedHashTable::~SharedHashTable() {
+      if (header) ::munmap(header, mappedBytes);
+      if (fd >= 0) ::close(fd);
+   }
+
+   // Segment size for capacity slots and keyBytes of arena; sets where each part starts
+   size_t SharedHashTable::layout(size_t capacity, size_t keyBytes, size_t& controlAt, size_t& slotsAt,
+                                  size_t& arenaAt) {
+      auto lineUp = [](size_t at) { return (at + 63) & ~size_t{63}; };
+      controlAt = sizeof(Header);
+      slotsAt = lineUp(controlAt + capacity);
+      arenaAt = slotsAt + capacity * sizeof(Slot);
+      return arenaAt + keyBytes;
+   }
+
+   // Point the member views at a mapping whose header is valid
+   void SharedHashTable::attach(void* mapping) {
+      char* base = static_cast<char*>(mapping);
+      header = static_cast<Header*>(mapping);
+      size_t controlAt, slotsAt, arenaAt;
+      layout(header->capacity, header->arenaBytes, controlAt, slotsAt, arenaAt);
+      control = reinterpret_cast<uint8_t*>(base + controlAt);
+      slots = reinterpret_cast<Slot*>(base + slotsAt);
+      arena = base + arenaAt;
+      mask = header->capacity - 1;
+      arenaBytes = header->arenaBytes;
+   }
+
+   bool SharedHashTable::isOpen() const {
+      return header != nullptr;
+   }
+
+   bool SharedHashTable::isWriter() const {
+      return header != nullptr && writer;
+   }
+
+   uint64_t SharedHashTable::hashOf(std::string_view key) {
+      return std::hash<std::string_view>{}(key);
+   }
+
+   std::string SharedHashTable::segmentName(const std::string& name) {
+      return name.starts_with('/') ? name : "/" + name;
+   }
+
+   /*
+    * Slot holding key, or capacity().  Probing stops at the first EMPTY
+    * control byte.  A slot's key is read only when its control byte carries
+    * the key's tag, and only after its offset and length are checked against
+    * the arena, since a reader may see them half written.
+    */
+   size_t SharedHashTable::find(std::string_view key, uint64_t hash) const {
+      const uint8_t tag = tagOf(hash);
+      for (size_t i = 0, index = hash & mask; i <= mask; ++i, index = (index + 1) & mask) {
+         const uint8_t c = loadRelaxed(control[index]);
+         if (c == EMPTY) break;
+         if (c != tag) continue;
+         const uint64_t offset = loadRelaxed(slots[index].keyOffset);
+         const uint64_t length = loadRelaxed(slots[index].keyLength);
+         if (length == key.size() && offset <= arenaBytes && length <= arenaBytes - offset &&
+             std::memcmp(arena + offset, key.data(), length) == 0) {
+            return index;
+         }
+      }
+      return capacity();
+   }
+
+   /*
+    * Value of key, if present.  The writer reads directly.  Other processes
+    * read between two loads of the sequence number and retry if the writer
+    * was in the middle of a change; while it is, they yield rather than spin.
+    */
+   std::optional<size_t> SharedHashTable::get(std::string_view key) const {
+      if (!header) return std::nullopt;
+      const uint64_t hash = hashOf(key);
+      if (writer) {
+         const size_t index = find(key, hash);
+         return index == capacity() ? std::nullopt : std::optional<size_t>(slots[index].value);
+      }
+      for (;;) {
+         const uint64_t before = header->sequence.load(std::memory_order_acquire);
+         if ((before & 1) == 0) {
+            const size_t index = find(key, hash);
+            std::optional<size_t> value;
+            if (index != capacity()) value = loadRelaxed(slots[index].value);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (header->sequence.load(std::memory_order_relaxed) == before) return value;
+         } else {
+            std::this_thread::yield();
+         }
+         retryCount.fetch_add(1, std::memory_order_relaxed);
+      }
+   }
+
+   bool SharedHashTable::contains(std::string_view key) const {
+      return get(key).has_value();
+   }
+
+   // Make the sequence number odd: readers that overlap what follows retry
+   void SharedHashTable::beginWrite() {
+      header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+   }
+
+   void SharedHashTable::endWrite() {
+      header->sequence.store(header->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+   }
+
+   // Add a key known to be absent at the first EMPTY or REMOVED slot of its probe
+   void SharedHashTable::place(std::string_view key, uint64_t hash, size_t value) {
+      size_t index = hash & mask;
+      while (control[index] & FULL) index = (index + 1) & mask;
+      if (control[index] == REMOVED) storeRelaxed(header->removed, header->removed - 1);
+      const uint64_t offset = header->arenaUsed;
+      std::memcpy(arena + offset, key.data(), key.size());
+      storeRelaxed(header->arenaUsed, offset + key.size());
+      storeRelaxed(slots[index].value, static_cast<uint64_t>(value));
+      storeRelaxed(slots[index].keyOffset, offset);
+      storeRelaxed(slots[index].keyLength, static_cast<uint64_t>(key.size()));
+      storeRelaxed(control[index], tagOf(hash));
+      storeRelaxed(header->size, header->size + 1);
+      liveKeyBytes += key.size();
+   }
+
+   /*
+    * Reinsert every entry into cleared slots and a compacted arena, dropping
+    * REMOVED slots and the bytes of removed keys.  The keys are copied out of
+    * the segment first, so the writer briefly holds them twice.
+    */
+   void SharedHashTable::rewrite() {
+      struct Entry {
+         std::string key;
+         size_t value;
+      };
+      std::vector<Entry> live;
+      live.reserve(header->size);
+      for (size_t i = 0; i <= mask; ++i) {
+         if (control[i] & FULL) live.push_back({std::string(arena + slots[i].keyOffset, slots[i].keyLength), slots[i].value});
+      }
+      for (size_t i = 0; i <= mask; ++i) storeRelaxed(control[i], EMPTY);
+      storeRelaxed(header->size, uint64_t{0});
+      storeRelaxed(header->removed, uint64_t{0});
+      storeRelaxed(header->arenaUsed, uint64_t{0});
+      liveKeyBytes = 0;
+      for (const auto& entry : live) place(entry.key, hashOf(entry.key), entry.value);
+   }
+
+   /*
+    * Add key -> value.  Returns false if the key is present, the table
+    * holds maxEntries keys, the key text does not fit in the arena even
+    * after a rewrite, or this process is not the writer.
+    */
+   bool SharedHashTable::insert(std::string_view key, size_t value) {
+      if (!isWriter()) return false;
+      const uint64_t hash = hashOf(key);
+      if (find(key, hash) != capacity()) return false;
+      if (header->size >= header->maxEntries || key.size() > arenaBytes - liveKeyBytes) return false;
+      beginWrite();
+      if (key.size() > arenaBytes - header->arenaUsed || header->removed > capacity() / 4) rewrite();
+      place(key, hash, value);
+      endWrite();
+      return true;
+   }
+
+   // Set key's value, adding the key if it is absent
+   bool SharedHashTable::assign(std::string_view key, size_t value) {
+      if (!isWriter()) return false;
+      const size_t index = find(key, hashOf(key));
+      if (index == capacity()) return insert(key, value);
+      beginWrite();
+      storeRelaxed(slots[index].value, static_cast<uint64_t>(value));
+      endWrite();
+      return true;
+   }
+
+   /*
+    * Remove key.  Its control byte goes back to EMPTY when the next slot is
+    * EMPTY, since no probe can pass through it; otherwise it is REMOVED.
+    */
+   bool SharedHashTable::remove(std::string_view key) {
+      if (!isWriter()) return false;
+      const size_t index = find(key, hashOf(key));
+      if (index == capacity()) return false;
+      beginWrite();
+      if (control[(index + 1) & mask] == EMPTY) {
+         storeRelaxed(control[index], EMPTY);
+      } else {
+         storeRelaxed(control[index], REMOVED);
+         storeRelaxed(header->removed, header->removed + 1);
+      }
+      storeRelaxed(header->size, header->size - 1);
+      liveKeyBytes -= slots[index].keyLength;
+      endWrite();
+      return true;
+   }
+
+   size_t SharedHashTable::size() const {
+      return header ? loadRelaxed(header->size) : 0;
+   }
+
+   size_t SharedHashTable::capacity() const {
+      return header ? mask + 1 : 0;
+   }
+
+   size_t SharedHashTable::segmentBytes() const {
+      return mappedBytes;
+   }
+
+   uint64_t SharedHashTable::retries() const {
+      return retryCount.load(std::memory_order_relaxed);
+   }
+
+   bool SharedHashTable::unlink(const std::string& name) {
+      return ::shm_unlink(segmentName(name).c_str()) == 0;
+   }
+
+}
@@ -0,0 +1,131 @@
+/*
+// SharedHashTable.h
+// Charlie Must
+// CS3100 Data Structures and Algorithms
+// Dr. James Anderson
+// Fall 2025
+// project4-HashTable
+//
+// Key -> value table in a POSIX shared memory segment, so worker processes
+// on one host can look keys up in a single copy instead of each building
+// its own.  One process creates the segment and is its only writer; any
+// number of processes attach to it read-only by name.  Everything in the
+// segment is addressed by offset from its start, never by pointer, so each
+// process can map it at a different address.  The segment holds:
+// - a header: sizes, and the seqlock's sequence number
+// - one control byte per slot: empty, removed, or full with 7 bits of the
+//   key's hash, so a probe reads a key only on a tag match
+// - the slots: value, key offset and key length
+// - the key arena, which keys are appended to
+// The writer makes each change between two increments of the sequence
+// number, so it is odd while a change is half done.  A reader notes the
+// number, looks the key up without locks or stores, and retries if the
+// number was odd or has moved.  Every offset a reader follows is checked
+// against the segment first, so a lookup that races a write can read stale
+// bytes but never outside the mapping.
+// Slots are probed linearly, and capacity is fixed when the segment is
+// created.  Removed slots and the bytes of removed keys are reclaimed by
+// rewriting the segment in place, in one write, once they are in the way.
+// Keys are hashed with std::hash, so every process must use the same
+// standard library build.
+// Actionable members include:
+// - SharedHashTable(name, maxEntries, keyBytes) - create a segment and become its writer
+// - SharedHashTable(name) - attach to an existing segment read-only
+// - insert / assign / remove - change entries (writer only)
+// - get / contains - lock-free lookups from any process
+// - size / capacity / segmentBytes / retries - entries, slots, mapping size, lookups retried
+// - unlink - remove a segment's name once no new process needs to attach
+*/
+#ifndef PROJECT4_HASHTABLE_SHAREDHASHTABLE_H
+#define PROJECT4_HASHTABLE_SHAREDHASHTABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace std {
+
+    class SharedHashTable {
+    public:
+        // Slots per entry is at least 1 / MAX_LOAD, as in HashTable
+        static constexpr double MAX_LOAD = 0.5;
+
+        SharedHashTable(const std::string& name, size_t maxEntries, size_t keyBytes);
+        explicit SharedHashTable(const std::string& name);
+        ~SharedHashTable();
+
+        SharedHashTable(const SharedHashTable&) = delete;
+        SharedHashTable& operator=(const SharedHashTable&) = delete;
+
+        bool isOpen() const;
+        bool isWriter() const;
+
+        bool insert(std::string_view key, size_t value);
+        bool assign(std::string_view key, size_t value);
+        bool remove(std::string_view key);
+
+        std::optional<size_t> get(std::string_view key) const;
+        bool contains(std::string_view key) const;
+
+        size_t size() const;
+        size_t capacity() const;
+        size_t segmentBytes() const;
+        uint64_t retries() const;
+
+        static bool unlink(const std::string& name);
+
+    private:
+        struct Header {
+            char magic[8];
+            std::atomic<uint64_t> sequence; // odd while the writer is changing the segment
+            uint64_t capacity;
+            uint64_t maxEntries;
+            uint64_t size;
+            uint64_t removed;      // control bytes marked REMOVED
+            uint64_t arenaBytes;
+            uint64_t arenaUsed;    // bytes appended to the arena
+        };
+        static_assert(sizeof(Header) == 64);
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "the seqlock must work across processes");
+
+        struct Slot {
+            uint64_t value;
+            uint64_t keyOffset; // into the arena
+            uint64_t keyLength;
+        };
+
+        // Control byte values; a full slot is FULL | the top 7 bits of its hash
+        static constexpr uint8_t EMPTY = 0;
+        static constexpr uint8_t REMOVED = 1;
+        static constexpr uint8_t FULL = 0x80;
+
+        int fd = -1;
+        size_t mappedBytes = 0;
+        bool writer = false;
+        Header* header = nullptr;
+        uint8_t* control = nullptr;
+        Slot* slots = nullptr;
+        char* arena = nullptr;
+        size_t mask = 0;
+        uint64_t arenaBytes = 0;
+        uint64_t liveKeyBytes = 0; // writer only: arena bytes of keys still present
+        mutable std::atomic<uint64_t> retryCount{0};
+
+        static uint64_t hashOf(std::string_view key);
+        static uint8_t tagOf(uint64_t hash) { return static_cast<uint8_t>(FULL | (hash >> 57)); }
+        static std::string segmentName(const std::string& name);
+        static size_t layout(size_t capacity, size_t keyBytes, size_t& controlAt, size_t& slotsAt, size_t& arenaAt);
+
+        void attach(void* mapping);
+        size_t find(std::string_view key, uint64_t hash) const;
+        void beginWrite();
+        void endWrite();
+        void place(std::string_view key, uint64_t hash, size_t value);
+        void rewrite();
+    };
+
+}
+
+#endif // PROJECT4_HASHTABLE_SHAREDHASHTABLE_H
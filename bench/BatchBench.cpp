@@ -0,0 +1,110 @@
+/** BatchBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  HashTable::getBatch() against a plain get() loop on tables much larger
+ *  than the last-level cache, where nearly every probe is a DRAM miss.  For
+ *  each group size it reports ns per lookup and the speedup over get(), for
+ *  hits and for misses (keys in random order, batches of BATCH keys).  Each
+ *  figure is the best of RUNS passes.
+ *
+ *  Usage: HashTableBatchBench [n ...] [--keylen L] [--lookups M]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../HashTable.h"
+
+using namespace std;
+
+static constexpr size_t BATCH = 4096;
+static constexpr size_t RUNS = 3;
+
+static volatile size_t g_sink = 0;
+
+static string makeKey(size_t i, size_t len) {
+    string key = "k" + to_string(i) + ":";
+    key.resize(max(len, key.size()), 'x');
+    return key;
+}
+
+template<typename Pass>
+static double bestNsPerLookup(size_t lookups, Pass pass) {
+    double best = 1e300;
+    for (size_t r = 0; r < RUNS; ++r) {
+        auto start = chrono::steady_clock::now();
+        g_sink = pass();
+        auto stop = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, nano>(stop - start).count() / static_cast<double>(lookups));
+    }
+    return best;
+}
+
+static void runSize(size_t n, size_t keyLen, size_t lookups) {
+    vector<string> keys;
+    for (size_t i = 0; i < n; ++i) keys.push_back(makeKey(i, keyLen));
+    mt19937_64 rng(7);
+    vector<string> hits, misses;
+    for (size_t i = 0; i < lookups; ++i) {
+        hits.push_back(keys[rng() % n]);
+        misses.push_back(makeKey(n + rng() % n, keyLen));
+    }
+
+    HashTable table;
+    table.reserve(n);
+    for (size_t i = 0; i < n; ++i) table[keys[i]] = i; // operator[] takes every value, unlike insert (9999)
+    fprintf(stderr, "n=%zu: %zu buckets, %.0f MB of buckets\n", n, table.capacity(),
+            static_cast<double>(table.capacity() * sizeof(HashTableBucket)) / 1e6);
+
+    for (const auto* probes : {&hits, &misses}) {
+        const char* kind = probes == &hits ? "hit" : "miss";
+        vector<string_view> views(probes->begin(), probes->end());
+        vector<optional<size_t>> out(BATCH);
+
+        double getNs = bestNsPerLookup(lookups, [&] {
+            size_t found = 0;
+            for (string_view key : views) found += table.get(key).has_value();
+            return found;
+        });
+        printf("%zu,%zu,%s,get,%.1f,1.00\n", n, keyLen, kind, getNs);
+
+        for (size_t group : {1, 2, 4, 8, 16, 32, 64}) {
+            double batchNs = bestNsPerLookup(lookups, [&] {
+                size_t found = 0;
+                for (size_t at = 0; at < views.size(); at += BATCH) {
+                    size_t len = min(BATCH, views.size() - at);
+                    found += table.getBatch(span(views).subspan(at, len), span(out).first(len), group);
+                }
+                return found;
+            });
+            printf("%zu,%zu,%s,%zu,%.1f,%.2f\n", n, keyLen, kind, group, batchNs, getNs / batchNs);
+        }
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes;
+    size_t keyLen = 16;
+    size_t lookups = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--keylen" && i + 1 < argc) keyLen = stoul(argv[++i]);
+        else if (arg == "--lookups" && i + 1 < argc) lookups = stoul(argv[++i]);
+        else sizes.push_back(stoul(arg));
+    }
+    if (sizes.empty()) sizes = {2000000};
+
+    printf("n,key_len,kind,group,ns_per_lookup,speedup_vs_get\n");
+    for (size_t n : sizes) runSize(n, keyLen, lookups);
+    return 0;
+}
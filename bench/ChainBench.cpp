@@ -0,0 +1,280 @@
+/** ChainBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Open addressing (HashTable, CuckooHashTable) against separate chaining
+ *  (ChainedHashTable) where open addressing is weakest:
+ *  - churn: N keys, then R x N steps that each remove a random live key and
+ *           insert a fresh one, so HashTable keeps leaving tombstones
+ *  - waves: the size rises and falls; R waves that insert fresh keys up to
+ *           N live, then remove random keys down to N/32
+ *  - full:  each table grown from empty to the most keys (at least N) it
+ *           holds before its next resize, so each runs at its own ceiling
+ *  After each scenario the table answers L lookups of live keys and L of
+ *  absent ones.  Columns: the load factor at the end (keys per slot; inline
+ *  slots for ChainedHashTable), ns per insert/remove and per lookup, heap
+ *  bytes per key at the end, and peak heap while the scenario ran.
+ *  HashTable only reclaims tombstones when it grows, so once churn has used
+ *  up its never-filled buckets every miss and insert probes the whole table;
+ *  keep N x R modest or its rows take minutes.
+ *
+ *  Usage: HashTableChainBench [--n N] [--rounds R] [--lookups L] [--filter substring]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <malloc.h>
+#include "../ChainedHashTable.h"
+#include "../CuckooHashTable.h"
+#include "../HashTable.h"
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Live and peak heap accounting.  CuckooHashTable and ChainedHashTable keep
+// cache-line aligned buckets, so the aligned forms are counted too.
+// -----------------------------------------------------------------------------
+static size_t g_liveBytes = 0;
+static size_t g_peakBytes = 0;
+static volatile size_t g_sink = 0; // keeps results of timed ops observable
+
+static void* counted(void* p) {
+    if (!p) throw std::bad_alloc();
+    g_liveBytes += malloc_usable_size(p);
+    g_peakBytes = max(g_peakBytes, g_liveBytes);
+    return p;
+}
+
+static void release(void* p) {
+    if (!p) return;
+    g_liveBytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+[[gnu::noinline]] void* operator new(size_t n) {
+    return counted(std::malloc(n ? n : 1));
+}
+
+[[gnu::noinline]] void* operator new(size_t n, align_val_t a) {
+    const size_t align = static_cast<size_t>(a);
+    return counted(std::aligned_alloc(align, (max<size_t>(n, 1) + align - 1) / align * align));
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+    release(p);
+}
+
+// Keys are "user:" and 12 digits: past the inline string buffer, like real keys
+static string keyOf(size_t i) {
+    char buffer[18] = "user:";
+    for (size_t d = 17; d-- > 5; i /= 10) buffer[d] = static_cast<char>('0' + i % 10);
+    return string(buffer, 17);
+}
+
+// HashTable::insert refuses the value 9999, so no key gets it
+static size_t valueOf(size_t i) {
+    return 2 * i;
+}
+
+struct Options {
+    size_t n = 20000;
+    size_t rounds = 4;
+    size_t lookups = 100000;
+    string filter;
+};
+
+struct Result {
+    size_t keys = 0;
+    double alpha = 0;
+    double writeNs = 0, hitNs = 0, missNs = 0;
+    double bytesPerKey = 0, peakMB = 0;
+};
+
+// Key ids [0, count) may be inserted; ids from count on never are
+struct Keys {
+    vector<string> text;
+    size_t count;
+    explicit Keys(size_t count) : count(count) {
+        text.reserve(2 * count);
+        for (size_t i = 0; i < 2 * count; ++i) text.push_back(keyOf(i));
+    }
+    const string& operator[](size_t i) const { return text[i]; }
+    const string& absent(size_t i) const { return text[count + i % count]; }
+};
+
+static double nanosSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+// L hits on the live ids and L misses, then the table's load and heap use
+template<typename Table>
+static void finish(const Table& t, const Keys& keys, const vector<uint32_t>& live, const Options& o,
+                   size_t heapBefore, Result& r) {
+    mt19937_64 rng(5);
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < o.lookups; ++i) found += t.get(keys[live[rng() % live.size()]]).has_value();
+    r.hitNs = nanosSince(start) / static_cast<double>(o.lookups);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < o.lookups; ++i) found += t.get(keys.absent(rng())).has_value();
+    r.missNs = nanosSince(start) / static_cast<double>(o.lookups);
+    if (found != o.lookups) fprintf(stderr, "lookups found %zu of %zu live keys\n", found, o.lookups);
+
+    r.keys = t.size();
+    r.alpha = t.alpha();
+    r.bytesPerKey = static_cast<double>(g_liveBytes - heapBefore) / static_cast<double>(max<size_t>(r.keys, 1));
+    r.peakMB = static_cast<double>(g_peakBytes - heapBefore) / (1 << 20);
+    g_sink = found;
+}
+
+// Remove a random live key and insert a fresh one, R x N times
+template<typename Table>
+static Result churn(const Options& o) {
+    const size_t n = o.n, steps = o.rounds * o.n;
+    Keys keys(n + steps);
+    vector<uint32_t> live(n);
+    for (size_t i = 0; i < n; ++i) live[i] = static_cast<uint32_t>(i);
+    mt19937_64 rng(11);
+    vector<size_t> slots(steps);
+    for (auto& s : slots) s = rng() % n;
+
+    Result r;
+    const size_t heapBefore = g_peakBytes = g_liveBytes;
+    {
+        Table t;
+        for (size_t i = 0; i < n; ++i) t.insert(keys[i], valueOf(i));
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < steps; ++i) {
+            t.remove(keys[live[slots[i]]]);
+            live[slots[i]] = static_cast<uint32_t>(n + i);
+            t.insert(keys[n + i], valueOf(n + i));
+        }
+        r.writeNs = nanosSince(start) / static_cast<double>(2 * steps);
+        finish(t, keys, live, o, heapBefore, r);
+    }
+    return r;
+}
+
+// R waves of fresh inserts up to N live keys and random removes down to N / 32
+template<typename Table>
+static Result waves(const Options& o) {
+    const size_t n = o.n, low = max<size_t>(o.n / 32, 1);
+    Keys keys(n + o.rounds * (n - low));
+    mt19937_64 rng(13);
+
+    Result r;
+    const size_t heapBefore = g_peakBytes = g_liveBytes;
+    {
+        Table t;
+        vector<uint32_t> live;
+        live.reserve(n);
+        size_t next = 0, ops = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t wave = 0; wave < o.rounds; ++wave) {
+            for (; live.size() < n; ++ops) {
+                t.insert(keys[next], valueOf(next));
+                live.push_back(static_cast<uint32_t>(next++));
+            }
+            for (; live.size() > low; ++ops) {
+                size_t at = rng() % live.size();
+                t.remove(keys[live[at]]);
+                live[at] = live.back();
+                live.pop_back();
+            }
+        }
+        r.writeNs = nanosSince(start) / static_cast<double>(max<size_t>(ops, 1));
+        finish(t, keys, live, o, heapBefore, r);
+    }
+    return r;
+}
+
+// Grown from empty to the most keys, at least N, held before the next resize
+template<typename Table>
+static Result full(const Options& o) {
+    size_t count = 0;
+    {
+        Table probe;
+        for (size_t i = 0;; ++i) {
+            const size_t before = probe.capacity();
+            probe.insert(keyOf(i), valueOf(i));
+            if (i >= o.n && probe.capacity() != before) {
+                count = i;
+                break;
+            }
+        }
+    }
+    Keys keys(count);
+    vector<uint32_t> live(count);
+    for (size_t i = 0; i < count; ++i) live[i] = static_cast<uint32_t>(i);
+
+    Result r;
+    const size_t heapBefore = g_peakBytes = g_liveBytes;
+    {
+        Table t;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) t.insert(keys[i], valueOf(i));
+        r.writeNs = nanosSince(start) / static_cast<double>(count);
+        finish(t, keys, live, o, heapBefore, r);
+    }
+    return r;
+}
+
+static void run(const char* engine, const char* scenario, Result (*body)(const Options&), const Options& o) {
+    if (!o.filter.empty() && string(scenario).find(o.filter) == string::npos) return;
+    const Result r = body(o);
+    printf("%s,%s,%zu,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f\n", engine, scenario, r.keys, r.alpha, r.writeNs, r.hitNs,
+           r.missNs, r.bytesPerKey, r.peakMB);
+    fflush(stdout);
+}
+
+template<typename Table>
+static void runAll(const char* engine, const Options& o) {
+    run(engine, "churn", churn<Table>, o);
+    run(engine, "waves", waves<Table>, o);
+    run(engine, "full", full<Table>, o);
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        if (arg == "--n") o.n = max<size_t>(stoul(argv[i + 1]), 2);
+        else if (arg == "--rounds") o.rounds = max<size_t>(stoul(argv[i + 1]), 1);
+        else if (arg == "--lookups") o.lookups = max<size_t>(stoul(argv[i + 1]), 1);
+        else if (arg == "--filter") o.filter = argv[i + 1];
+        else {
+            fprintf(stderr, "Usage: %s [--n N] [--rounds R] [--lookups L] [--filter substring]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("engine,scenario,keys,alpha,write_ns,hit_ns,miss_ns,bytes_per_key,peak_heap_mb\n");
+    fflush(stdout);
+    runAll<HashTable>("HashTable", o);
+    runAll<CuckooHashTable>("CuckooHashTable", o);
+    runAll<ChainedHashTable>("ChainedHashTable", o);
+    return 0;
+}
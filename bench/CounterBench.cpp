@@ -0,0 +1,125 @@
+/** CounterBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Concurrent word counting three ways, at 1 to 64 threads:
+ *  - locked: one HashTable behind a mutex, `ht[word]++` per token
+ *  - atomic: one ConcurrentCounterTable, increment() per token
+ *  - merge:  a local HashTable per thread, merged into a ConcurrentCounterTable
+ *            at the end (the merge is included in the time)
+ *  Tokens are drawn from a Zipfian vocabulary (s = 1), so a few words take
+ *  most of the increments, as in real text.  Every run checks that the
+ *  counts add up to the number of tokens.
+ *
+ *  Usage: HashTableCounterBench [--tokens N] [--vocab V] [--threads T ...]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ConcurrentCounterTable.h"
+
+using namespace std;
+
+static constexpr size_t STREAM = size_t{1} << 22;
+
+// Token stream of vocabulary indices, Zipfian with exponent 1
+static vector<uint32_t> makeStream(size_t vocab) {
+    vector<double> cdf(vocab);
+    double total = 0;
+    for (size_t i = 0; i < vocab; ++i) cdf[i] = total += 1.0 / static_cast<double>(i + 1);
+    mt19937_64 rng(11);
+    uniform_real_distribution<double> uniform(0, total);
+    vector<uint32_t> stream(STREAM);
+    for (auto& token : stream) {
+        token = static_cast<uint32_t>(lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+    }
+    return stream;
+}
+
+// Run body(t, begin, end) on each thread's share of the tokens; seconds taken
+template<typename Body>
+static double runThreads(size_t threads, size_t tokens, Body body) {
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back(body, t, tokens * t / threads, tokens * (t + 1) / threads);
+    }
+    for (auto& w : workers) w.join();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t tokens = 1000000000, vocabSize = 100000;
+    vector<size_t> threadCounts;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--tokens" && i + 1 < argc) tokens = static_cast<size_t>(stod(argv[++i]));
+        else if (arg == "--vocab" && i + 1 < argc) vocabSize = stoul(argv[++i]);
+        else if (arg == "--threads") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') threadCounts.push_back(stoul(argv[++i]));
+        }
+    }
+    if (threadCounts.empty()) threadCounts = {1, 2, 4, 8, 16, 32, 64};
+
+    vector<string> vocab;
+    for (size_t i = 0; i < vocabSize; ++i) vocab.push_back("w" + to_string(i));
+    const vector<uint32_t> stream = makeStream(vocabSize);
+    auto word = [&](size_t i) -> const string& { return vocab[stream[i & (STREAM - 1)]]; };
+
+    printf("mode,threads,tokens,seconds,mtokens_per_s,counts_ok\n");
+    for (size_t threads : threadCounts) {
+        auto report = [&](const char* mode, double seconds, size_t counted) {
+            printf("%s,%zu,%zu,%.3f,%.1f,%s\n", mode, threads, tokens, seconds,
+                   static_cast<double>(tokens) / seconds / 1e6, counted == tokens ? "yes" : "NO");
+            fflush(stdout);
+        };
+
+        {
+            HashTable table;
+            mutex lock;
+            double seconds = runThreads(threads, tokens, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    lock_guard<mutex> guard(lock);
+                    table[word(i)]++;
+                }
+            });
+            size_t counted = 0;
+            for (const auto& [key, count] : table) counted += count;
+            report("locked", seconds, counted);
+        }
+
+        {
+            ConcurrentCounterTable table(vocabSize);
+            double seconds = runThreads(threads, tokens, [&](size_t, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) table.increment(word(i));
+            });
+            size_t counted = 0;
+            table.forEach([&](string_view, size_t count) { counted += count; });
+            report("atomic", seconds, counted);
+        }
+
+        {
+            ConcurrentCounterTable table(vocabSize);
+            double seconds = runThreads(threads, tokens, [&](size_t, size_t begin, size_t end) {
+                HashTable local;
+                for (size_t i = begin; i < end; ++i) local[word(i)]++;
+                table.merge(local);
+            });
+            size_t counted = 0;
+            table.forEach([&](string_view, size_t count) { counted += count; });
+            report("merge", seconds, counted);
+        }
+    }
+    return 0;
+}
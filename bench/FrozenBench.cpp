@@ -0,0 +1,99 @@
+/** FrozenBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  FrozenHashTable (minimal perfect hash) against the HashTable it was built
+ *  from and std::unordered_map, for build-once / query-many tables.  For each
+ *  size n it reports the freeze time, the perfect hash's bits per key, total
+ *  bytes per entry and lookup ns for hits and misses (keys in random order).
+ *
+ *  Usage: HashTableFrozenBench [n ...] [--keylen L]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../FrozenHashTable.h"
+
+using namespace std;
+
+static volatile size_t g_sink = 0;
+
+static string makeKey(size_t i, size_t len) {
+    string key = "k" + to_string(i) + ":";
+    key.resize(max(len, key.size()), 'x');
+    return key;
+}
+
+template<typename Lookup>
+static double nsPerLookup(const vector<string>& probes, Lookup lookup) {
+    size_t found = 0;
+    auto start = chrono::steady_clock::now();
+    for (const auto& key : probes) found += lookup(key);
+    auto stop = chrono::steady_clock::now();
+    g_sink = found;
+    return chrono::duration<double, nano>(stop - start).count() / static_cast<double>(probes.size());
+}
+
+static void runSize(size_t n, size_t keyLen) {
+    vector<string> keys, misses;
+    for (size_t i = 0; i < n; ++i) {
+        keys.push_back(makeKey(i, keyLen));
+        misses.push_back(makeKey(i + n, keyLen));
+    }
+    mt19937_64 rng(3);
+    vector<string> hits = keys;
+    shuffle(hits.begin(), hits.end(), rng);
+
+    HashTable table;
+    unordered_map<string, size_t> map;
+    table.reserve(n);
+    map.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        table[keys[i]] = i; // operator[] takes every value, unlike insert (9999)
+        map.emplace(keys[i], i);
+    }
+
+    auto start = chrono::steady_clock::now();
+    optional<FrozenHashTable> frozen = FrozenHashTable::build(table);
+    double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (!frozen) {
+        printf("%zu,%zu,build failed\n", n, keyLen);
+        return;
+    }
+
+    auto frozenGet = [&](const string& k) { return frozen->get(k).has_value(); };
+    auto tableGet = [&](const string& k) { return table.get(k).has_value(); };
+    auto mapGet = [&](const string& k) { return map.find(k) != map.end(); };
+
+    printf("%zu,%zu,%.1f,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", n, keyLen, buildMs, frozen->pilotBitsPerKey(),
+           static_cast<double>(frozen->bytes()) / static_cast<double>(n),
+           nsPerLookup(hits, frozenGet), nsPerLookup(misses, frozenGet),
+           nsPerLookup(hits, tableGet), nsPerLookup(misses, tableGet),
+           nsPerLookup(hits, mapGet));
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes;
+    size_t keyLen = 16;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--keylen" && i + 1 < argc) keyLen = stoul(argv[++i]);
+        else sizes.push_back(stoul(arg));
+    }
+    if (sizes.empty()) sizes = {1000, 100000, 1000000};
+
+    printf("n,key_len,build_ms,mph_bits_per_key,frozen_bytes_per_entry,frozen_hit_ns,frozen_miss_ns,"
+           "hashtable_hit_ns,hashtable_miss_ns,unordered_map_hit_ns\n");
+    for (size_t n : sizes) runSize(n, keyLen);
+    return 0;
+}
@@ -0,0 +1,666 @@
+/** HashTableBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Parameterized benchmark suite for HashTable, CuckooHashTable and
+ *  ChainedHashTable, with std::unordered_map as a baseline.  Every (engine, workload, key length)
+ *  case runs in a forked child so peak RSS is measured per case.  Each case
+ *  builds its table, then runs the operation stream twice: once untimed per
+ *  op for ns/op and ops/s, once with every op timed for the p50/p99/p99.9
+ *  latencies.
+ *  HashTable also runs with its Bloom filter on ("HashTable+bloom"); the
+ *  get/tombstones workload is mostly misses against a table full of
+ *  tombstones, the case the filter is for.
+ *  The get/url workloads use URL-like keys that share a long prefix and
+ *  differ only in a fixed-width id, so every key has the same length; key
+ *  lengths below 56 bytes are raised to fit the prefix and id.
+ *  The get/zipf-hot workload trains HashTable's access counters on untimed
+ *  lookups, then compares it before and after reoptimize() ("HashTable+reopt").
+ *  The cache/zipf workloads compare HashTable's CLOCK cache mode with a
+ *  std::list + std::unordered_map LRU at the same entry budget and also
+ *  report the hit rate.
+ *  HashTable's slot indices are HASHTABLE_INDEX_BITS wide; the width is
+ *  printed first and recorded in every CSV/JSON row.  HashTableBench64 is
+ *  the same suite with 64-bit indices, for comparing bytes/entry.
+ *
+ *  Usage: HashTableBench [--n N] [--ops M] [--filter substring]
+ *                        [--keylens 4,16,64] [--csv file] [--json file]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../HashTable.h"
+#include "../ChainedHashTable.h"
+#include "../CuckooHashTable.h"
+
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Live heap accounting, used for bytes/entry.  Counts the usable size malloc
+// actually handed out, so allocator rounding is included.  The aligned forms
+// are counted too, for the cache-line buckets of the cuckoo and chained tables.
+// -----------------------------------------------------------------------------
+static size_t g_liveBytes = 0;
+static volatile size_t g_sink = 0; // keeps results of timed ops observable
+
+[[gnu::noinline]] void* operator new(size_t n) {
+    void* p = std::malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    g_liveBytes += malloc_usable_size(p);
+    return p;
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    if (!p) return;
+    g_liveBytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+[[gnu::noinline]] void* operator new(size_t n, align_val_t a) {
+    const size_t align = static_cast<size_t>(a);
+    void* p = std::aligned_alloc(align, (max<size_t>(n, 1) + align - 1) / align * align);
+    if (!p) throw std::bad_alloc();
+    g_liveBytes += malloc_usable_size(p);
+    return p;
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+    operator delete(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+    operator delete(p);
+}
+
+// -----------------------------------------------------------------------------
+// Engines under test share this adapter shape: reserve / insert / get / remove
+// -----------------------------------------------------------------------------
+struct HashTableEngine {
+    static constexpr const char* name = "HashTable";
+    HashTable table;
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+};
+
+// Same table with a 10 bits/key Bloom filter in front of lookups
+struct HashTableBloomEngine {
+    static constexpr const char* name = "HashTable+bloom";
+    HashTable table;
+    HashTableBloomEngine() { table.setBloomFilter(10); }
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+};
+
+// Samples every hit during the untimed setup, then re-places hot keys first
+struct HashTableReoptEngine {
+    static constexpr const char* name = "HashTable+reopt";
+    HashTable table;
+    HashTableReoptEngine() { table.setAccessSampling(1); }
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+    void afterSetup() {
+        table.reoptimize();
+        table.setAccessSampling(0);
+    }
+};
+
+struct CuckooEngine {
+    static constexpr const char* name = "CuckooHashTable";
+    CuckooHashTable table;
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+};
+
+struct ChainedEngine {
+    static constexpr const char* name = "ChainedHashTable";
+    ChainedHashTable table;
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+};
+
+struct UnorderedMapEngine {
+    static constexpr const char* name = "std::unordered_map";
+    unordered_map<string, size_t> table;
+    void reserve(size_t n) { table.reserve(n); }
+    bool insert(const string& k, size_t v) { return table.emplace(k, v).second; }
+    bool get(const string& k) const { return table.find(k) != table.end(); }
+    bool remove(const string& k) { return table.erase(k) != 0; }
+};
+
+// Cache engines add setBudget() and access(): a get that fills the key on a
+// miss, returning whether it hit
+struct HashTableCacheEngine {
+    static constexpr const char* name = "HashTable CLOCK";
+    HashTable table;
+    size_t hits = 0;
+    void reserve(size_t n) { table.reserve(n); }
+    void setBudget(size_t n) { table.setCacheBudget(n); }
+    bool insert(const string& k, size_t v) { return table.insert(k, v); }
+    bool get(const string& k) const { return table.get(k).has_value(); }
+    bool remove(const string& k) { return table.remove(k); }
+    bool access(const string& k, size_t v) {
+        if (table.get(k)) return ++hits;
+        table.insert(k, v);
+        return false;
+    }
+};
+
+// Textbook exact LRU: recency list plus an index keyed by views of the list's keys
+struct ListLruEngine {
+    static constexpr const char* name = "list+map LRU";
+    using Entry = pair<string, size_t>;
+    list<Entry> order; // most recent first
+    unordered_map<string_view, list<Entry>::iterator> index;
+    size_t budget = 0;
+    size_t hits = 0;
+    void reserve(size_t n) { index.reserve(n); }
+    void setBudget(size_t n) {
+        budget = n;
+        index.reserve(n);
+    }
+    bool insert(const string& k, size_t v) {
+        if (index.count(k)) return false;
+        if (budget && index.size() >= budget) {
+            index.erase(order.back().first);
+            order.pop_back();
+        }
+        order.emplace_front(k, v);
+        index.emplace(order.front().first, order.begin());
+        return true;
+    }
+    bool get(const string& k) const { return index.count(k) != 0; }
+    bool remove(const string& k) {
+        auto it = index.find(k);
+        if (it == index.end()) return false;
+        auto node = it->second;
+        index.erase(it);
+        order.erase(node);
+        return true;
+    }
+    bool access(const string& k, size_t v) {
+        auto it = index.find(k);
+        if (it != index.end()) {
+            order.splice(order.begin(), order, it->second);
+            return ++hits;
+        }
+        insert(k, v);
+        return false;
+    }
+};
+
+template<typename Engine>
+concept CacheEngine = requires(Engine& e, const string& k) {
+    e.setBudget(size_t{});
+    e.access(k, size_t{});
+    e.hits;
+};
+
+// -----------------------------------------------------------------------------
+// Workload description
+// -----------------------------------------------------------------------------
+enum class OpKind : uint8_t { GET, INSERT, REMOVE, ACCESS };
+
+struct Op {
+    OpKind kind;
+    uint32_t key; // index into Workload::keys
+};
+
+struct Workload {
+    size_t preload = 0;   // keys[0, preload) are inserted before timing
+    bool presize = false; // reserve(preload + inserts) before building
+    size_t cacheEntries = 0; // entry budget for cache engines
+    vector<Op> setup;        // untimed ops applied after the preload
+    vector<string> keys;
+    vector<Op> ops;
+};
+
+struct Result {
+    double nsPerOp = 0;
+    double opsPerSec = 0;
+    double p50 = 0, p99 = 0, p999 = 0;
+    double bytesPerEntry = 0;
+    long peakRssKb = 0;
+    size_t entries = 0;
+    double hitRate = -1; // cache workloads only
+};
+
+struct Options {
+    size_t n = 100000;
+    size_t ops = 1000000;
+    string filter;
+    vector<size_t> keyLens = {4, 16, 64, 256, 1024};
+    string csvPath;
+    string jsonPath;
+};
+
+// Key i of length len: a decimal id padded with deterministic filler so keys
+// are unique and equally long
+static string makeKey(size_t i, size_t len, mt19937_64& rng) {
+    string id = to_string(i) + ":";
+    string key;
+    key.reserve(max(len, id.size()));
+    key += id;
+    while (key.size() < len) {
+        key += static_cast<char>('a' + rng() % 26);
+    }
+    return key;
+}
+
+// URL-like key i of length len: a long prefix every key shares, a
+// zero-padded id, then a shared query string, so keys differ only in the
+// middle and are all the same length (the worst case for comparing keys)
+static string makeUrlKey(size_t i, size_t len, mt19937_64&) {
+    static const string prefix = "https://shop.example.com/api/v2/catalog/items/";
+    static const string query = "/reviews?sort=newest&page=1&lang=en-US&currency=USD&fields=author,rating,body";
+    string id = to_string(i);
+    string key = prefix + string(id.size() < 10 ? 10 - id.size() : 0, '0') + id;
+    key += query.substr(0, len > key.size() ? len - key.size() : 0);
+    while (key.size() < len) key += '&';
+    return key;
+}
+
+using KeyMaker = string (*)(size_t, size_t, mt19937_64&);
+
+// Zipfian sampler over [0, n) with skew theta, via the inverse CDF
+class ZipfSampler {
+    vector<double> cdf;
+public:
+    ZipfSampler(size_t n, double theta) : cdf(n) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += 1.0 / pow(static_cast<double>(i + 1), theta);
+            cdf[i] = sum;
+        }
+        for (auto& c : cdf) c /= sum;
+    }
+    size_t operator()(mt19937_64& rng) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+};
+
+// Lookups over n preloaded keys; hitRatio of them hit, the rest miss
+static Workload lookupWorkload(const Options& o, size_t keyLen, double hitRatio, bool zipf,
+                               KeyMaker keyOf = makeKey) {
+    Workload w;
+    w.preload = o.n;
+    w.presize = true;
+    mt19937_64 rng(42);
+    for (size_t i = 0; i < 2 * o.n; ++i) w.keys.push_back(keyOf(i, keyLen, rng));
+
+    ZipfSampler zipfian(zipf ? o.n : 1, 0.99);
+    uniform_int_distribution<size_t> uniform(0, o.n - 1);
+    bernoulli_distribution hit(hitRatio);
+    for (size_t i = 0; i < o.ops; ++i) {
+        size_t k = zipf ? zipfian(rng) : uniform(rng);
+        if (!hit(rng)) k += o.n; // same rank in the never-inserted half
+        w.ops.push_back({OpKind::GET, static_cast<uint32_t>(k)});
+    }
+    return w;
+}
+
+// Zipfian hits with popularity shuffled across keys, so hot keys are spread
+// through insertion order; the untimed setup replays lookups from the same
+// distribution for engines that learn from them
+static Workload hotKeyWorkload(const Options& o, size_t keyLen) {
+    Workload w;
+    w.preload = o.n;
+    mt19937_64 rng(29);
+    for (size_t i = 0; i < o.n; ++i) w.keys.push_back(makeKey(i, keyLen, rng));
+
+    vector<uint32_t> rankToKey(o.n);
+    for (size_t i = 0; i < o.n; ++i) rankToKey[i] = static_cast<uint32_t>(i);
+    shuffle(rankToKey.begin(), rankToKey.end(), rng);
+    ZipfSampler zipfian(o.n, 0.99);
+    for (size_t i = 0; i < o.ops / 4; ++i) w.setup.push_back({OpKind::GET, rankToKey[zipfian(rng)]});
+    for (size_t i = 0; i < o.ops; ++i) w.ops.push_back({OpKind::GET, rankToKey[zipfian(rng)]});
+    return w;
+}
+
+// Insert n fresh keys, either into a presized table or growing from empty
+static Workload insertWorkload(const Options& o, size_t keyLen, bool presize) {
+    Workload w;
+    w.presize = presize;
+    mt19937_64 rng(7);
+    for (size_t i = 0; i < o.n; ++i) {
+        w.keys.push_back(makeKey(i, keyLen, rng));
+        w.ops.push_back({OpKind::INSERT, static_cast<uint32_t>(i)});
+    }
+    return w;
+}
+
+// Lookups, 80% misses, after n untimed remove+insert churn steps: inserts
+// keep taking ESS buckets and leaving tombstones behind, so probe sequences
+// for misses grow long, the case the Bloom filter is for
+static Workload tombstoneWorkload(const Options& o, size_t keyLen) {
+    Workload w;
+    w.preload = o.n;
+    w.presize = true;
+    mt19937_64 rng(13);
+    for (size_t i = 0; i < 3 * o.n; ++i) w.keys.push_back(makeKey(i, keyLen, rng));
+
+    vector<uint32_t> live(o.n);
+    for (size_t i = 0; i < o.n; ++i) live[i] = static_cast<uint32_t>(i);
+    for (size_t i = 0; i < o.n; ++i) {
+        size_t slot = rng() % live.size();
+        w.setup.push_back({OpKind::REMOVE, live[slot]});
+        live[slot] = static_cast<uint32_t>(o.n + i);
+        w.setup.push_back({OpKind::INSERT, live[slot]});
+    }
+    bernoulli_distribution hit(0.2);
+    for (size_t i = 0; i < o.ops; ++i) {
+        uint32_t k = hit(rng) ? live[rng() % o.n] : static_cast<uint32_t>(2 * o.n + rng() % o.n);
+        w.ops.push_back({OpKind::GET, k});
+    }
+    return w;
+}
+
+// Steady-state churn: remove a random live key and insert a fresh one
+static Workload churnWorkload(const Options& o, size_t keyLen) {
+    Workload w;
+    w.preload = o.n;
+    w.presize = true;
+    mt19937_64 rng(11);
+    size_t fresh = o.ops / 2;
+    for (size_t i = 0; i < o.n + fresh; ++i) w.keys.push_back(makeKey(i, keyLen, rng));
+
+    vector<uint32_t> live(o.n);
+    for (size_t i = 0; i < o.n; ++i) live[i] = static_cast<uint32_t>(i);
+    for (size_t i = 0; i < fresh; ++i) {
+        size_t slot = rng() % live.size();
+        w.ops.push_back({OpKind::REMOVE, live[slot]});
+        live[slot] = static_cast<uint32_t>(o.n + i);
+        w.ops.push_back({OpKind::INSERT, live[slot]});
+    }
+    return w;
+}
+
+// Zipfian accesses over n keys through a cache holding a fraction of them;
+// every miss fills the key, evicting once the budget is reached
+static Workload cacheWorkload(const Options& o, size_t keyLen, double budgetFraction) {
+    Workload w;
+    w.cacheEntries = max<size_t>(1, static_cast<size_t>(static_cast<double>(o.n) * budgetFraction));
+    mt19937_64 rng(23);
+    for (size_t i = 0; i < o.n; ++i) w.keys.push_back(makeKey(i, keyLen, rng));
+
+    // Shuffle ranks so popular keys are not clustered by id
+    vector<uint32_t> rankToKey(o.n);
+    for (size_t i = 0; i < o.n; ++i) rankToKey[i] = static_cast<uint32_t>(i);
+    shuffle(rankToKey.begin(), rankToKey.end(), rng);
+    ZipfSampler zipfian(o.n, 0.99);
+    for (size_t i = 0; i < o.ops; ++i) {
+        w.ops.push_back({OpKind::ACCESS, rankToKey[zipfian(rng)]});
+    }
+    return w;
+}
+
+template<typename Engine>
+static size_t apply(Engine& e, const Workload& w, const Op& op) {
+    switch (op.kind) {
+        case OpKind::GET: return e.get(w.keys[op.key]);
+        case OpKind::INSERT: return e.insert(w.keys[op.key], static_cast<size_t>(op.key) << 1);
+        case OpKind::REMOVE: return e.remove(w.keys[op.key]);
+        case OpKind::ACCESS:
+            if constexpr (CacheEngine<Engine>) {
+                return e.access(w.keys[op.key], static_cast<size_t>(op.key) << 1);
+            }
+            return 0;
+    }
+    return 0;
+}
+
+template<typename Engine>
+static void build(Engine& e, const Workload& w) {
+    if constexpr (CacheEngine<Engine>) {
+        if (w.cacheEntries) e.setBudget(w.cacheEntries);
+    }
+    size_t inserts = 0;
+    for (const auto& op : w.ops) inserts += op.kind == OpKind::INSERT;
+    if (w.presize) e.reserve(w.preload + inserts);
+    for (size_t i = 0; i < w.preload; ++i) e.insert(w.keys[i], i << 1);
+    for (const auto& op : w.setup) apply(e, w, op);
+    if constexpr (requires { e.afterSetup(); }) e.afterSetup();
+}
+
+template<typename Engine>
+static Result runCase(const Workload& w) {
+    Result r;
+    size_t checksum = 0;
+
+    // Throughput pass
+    {
+        Engine e;
+        size_t before = g_liveBytes;
+        build(e, w);
+        auto start = chrono::steady_clock::now();
+        for (const auto& op : w.ops) checksum += apply(e, w, op);
+        auto stop = chrono::steady_clock::now();
+        double ns = chrono::duration<double, nano>(stop - start).count();
+        r.nsPerOp = ns / static_cast<double>(w.ops.size());
+        r.opsPerSec = 1e9 / r.nsPerOp;
+
+        size_t live = 0;
+        for (size_t i = 0; i < w.keys.size(); ++i) live += e.get(w.keys[i]);
+        r.entries = live;
+        r.bytesPerEntry = live ? static_cast<double>(g_liveBytes - before) / static_cast<double>(live) : 0;
+        if constexpr (CacheEngine<Engine>) {
+            if (w.cacheEntries) r.hitRate = static_cast<double>(e.hits) / static_cast<double>(w.ops.size());
+        }
+    }
+
+    // Latency pass on a fresh table, every op timed individually
+    {
+        Engine e;
+        build(e, w);
+        vector<double> lat;
+        lat.reserve(w.ops.size());
+        for (const auto& op : w.ops) {
+            auto start = chrono::steady_clock::now();
+            checksum += apply(e, w, op);
+            lat.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start).count());
+        }
+        sort(lat.begin(), lat.end());
+        auto pct = [&](double p) { return lat[min(lat.size() - 1, static_cast<size_t>(p * lat.size()))]; };
+        r.p50 = pct(0.50);
+        r.p99 = pct(0.99);
+        r.p999 = pct(0.999);
+    }
+
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    r.peakRssKb = ru.ru_maxrss;
+    g_sink = checksum;
+    return r;
+}
+
+// Run one case in a child process so its peak RSS is not polluted by others
+template<typename Engine>
+static bool runIsolated(const function<Workload()>& make, Result& out) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    pid_t pid = fork();
+    if (pid == 0) {
+        ::close(fds[0]);
+        Workload w = make();
+        Result r = runCase<Engine>(w);
+        ssize_t n = ::write(fds[1], &r, sizeof(r));
+        ::close(fds[1]);
+        _exit(n == static_cast<ssize_t>(sizeof(r)) ? 0 : 1);
+    }
+    ::close(fds[1]);
+    ssize_t n = ::read(fds[0], &out, sizeof(out));
+    ::close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return n == static_cast<ssize_t>(sizeof(out)) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+struct Row {
+    string engine;
+    string workload;
+    size_t keyLen;
+    Result r;
+};
+
+static vector<Row> g_rows;
+
+template<typename Engine>
+static void runEngine(const string& workload, size_t keyLen, const function<Workload()>& make) {
+    Result r;
+    if (!runIsolated<Engine>(make, r)) {
+        cerr << "case failed: " << Engine::name << " " << workload << endl;
+        return;
+    }
+    g_rows.push_back({Engine::name, workload, keyLen, r});
+    const Row& row = g_rows.back();
+    printf("%-20s %-22s %6zu %10.1f %12.0f %9.0f %9.0f %9.0f %10.1f %10ld", row.engine.c_str(),
+           row.workload.c_str(), row.keyLen, r.nsPerOp, r.opsPerSec, r.p50, r.p99, r.p999, r.bytesPerEntry,
+           r.peakRssKb);
+    if (r.hitRate >= 0) printf(" %6.1f%%", 100.0 * r.hitRate);
+    printf("\n");
+    fflush(stdout);
+}
+
+static void runWorkload(const Options& o, const string& workload, size_t keyLen, const function<Workload()>& make) {
+    if (!o.filter.empty() && workload.find(o.filter) == string::npos) return;
+    runEngine<HashTableEngine>(workload, keyLen, make);
+    runEngine<HashTableBloomEngine>(workload, keyLen, make);
+    runEngine<CuckooEngine>(workload, keyLen, make);
+    runEngine<ChainedEngine>(workload, keyLen, make);
+    runEngine<UnorderedMapEngine>(workload, keyLen, make);
+}
+
+static void runLayoutWorkload(const Options& o, const string& workload, size_t keyLen,
+                              const function<Workload()>& make) {
+    if (!o.filter.empty() && workload.find(o.filter) == string::npos) return;
+    runEngine<HashTableEngine>(workload, keyLen, make);
+    runEngine<HashTableReoptEngine>(workload, keyLen, make);
+}
+
+static void runCacheWorkload(const Options& o, const string& workload, size_t keyLen,
+                             const function<Workload()>& make) {
+    if (!o.filter.empty() && workload.find(o.filter) == string::npos) return;
+    runEngine<HashTableCacheEngine>(workload, keyLen, make);
+    runEngine<ListLruEngine>(workload, keyLen, make);
+}
+
+static void writeCSV(const string& path) {
+    ofstream out(path);
+    out << "engine,workload,key_len,entries,ns_per_op,ops_per_sec,p50_ns,p99_ns,p999_ns,bytes_per_entry,peak_rss_kb,"
+           "index_bits,hit_rate\n";
+    for (const auto& row : g_rows) {
+        out << row.engine << "," << row.workload << "," << row.keyLen << "," << row.r.entries << ","
+            << row.r.nsPerOp << "," << row.r.opsPerSec << "," << row.r.p50 << "," << row.r.p99 << ","
+            << row.r.p999 << "," << row.r.bytesPerEntry << "," << row.r.peakRssKb << "," << HASHTABLE_INDEX_BITS
+            << ",";
+        if (row.r.hitRate >= 0) out << row.r.hitRate;
+        out << "\n";
+    }
+}
+
+static void writeJSON(const string& path) {
+    ofstream out(path);
+    out << "[\n";
+    for (size_t i = 0; i < g_rows.size(); ++i) {
+        const auto& row = g_rows[i];
+        if (i > 0) out << ",\n";
+        out << "  {\"engine\": \"" << row.engine << "\", \"workload\": \"" << row.workload
+            << "\", \"key_len\": " << row.keyLen << ", \"entries\": " << row.r.entries
+            << ", \"ns_per_op\": " << row.r.nsPerOp << ", \"ops_per_sec\": " << row.r.opsPerSec
+            << ", \"p50_ns\": " << row.r.p50 << ", \"p99_ns\": " << row.r.p99 << ", \"p999_ns\": " << row.r.p999
+            << ", \"bytes_per_entry\": " << row.r.bytesPerEntry << ", \"peak_rss_kb\": " << row.r.peakRssKb
+            << ", \"index_bits\": " << HASHTABLE_INDEX_BITS;
+        if (row.r.hitRate >= 0) out << ", \"hit_rate\": " << row.r.hitRate;
+        out << "}";
+    }
+    out << "\n]\n";
+}
+
+static Options parseArgs(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        string val = argv[i + 1];
+        if (flag == "--n") o.n = stoul(val);
+        else if (flag == "--ops") o.ops = stoul(val);
+        else if (flag == "--filter") o.filter = val;
+        else if (flag == "--csv") o.csvPath = val;
+        else if (flag == "--json") o.jsonPath = val;
+        else if (flag == "--keylens") {
+            o.keyLens.clear();
+            size_t pos = 0;
+            while (pos < val.size()) {
+                size_t comma = val.find(',', pos);
+                if (comma == string::npos) comma = val.size();
+                o.keyLens.push_back(stoul(val.substr(pos, comma - pos)));
+                pos = comma + 1;
+            }
+        }
+    }
+    return o;
+}
+
+int main(int argc, char** argv) {
+    Options o = parseArgs(argc, argv);
+
+    printf("HashTable index width: %d bits (max capacity %zu)\n", HASHTABLE_INDEX_BITS, HashTable::MAX_CAPACITY);
+    printf("%-20s %-22s %6s %10s %12s %9s %9s %9s %10s %10s %7s\n", "engine", "workload", "keylen", "ns/op",
+           "ops/s", "p50", "p99", "p99.9", "bytes/ent", "rss_kb", "hit");
+
+    for (size_t len : o.keyLens) {
+        runWorkload(o, "get/uniform/hit100", len, [&] { return lookupWorkload(o, len, 1.0, false); });
+        runWorkload(o, "get/uniform/hit50", len, [&] { return lookupWorkload(o, len, 0.5, false); });
+        runWorkload(o, "get/uniform/hit0", len, [&] { return lookupWorkload(o, len, 0.0, false); });
+        runWorkload(o, "get/zipf/hit100", len, [&] { return lookupWorkload(o, len, 1.0, true); });
+        runWorkload(o, "get/zipf/hit20", len, [&] { return lookupWorkload(o, len, 0.2, true); });
+        runWorkload(o, "get/tombstones/hit20", len, [&] { return tombstoneWorkload(o, len); });
+        runWorkload(o, "get/url/hit100", len, [&] { return lookupWorkload(o, len, 1.0, false, makeUrlKey); });
+        runWorkload(o, "get/url/hit0", len, [&] { return lookupWorkload(o, len, 0.0, false, makeUrlKey); });
+        runLayoutWorkload(o, "get/zipf-hot/hit100", len, [&] { return hotKeyWorkload(o, len); });
+        runWorkload(o, "insert/grow", len, [&] { return insertWorkload(o, len, false); });
+        runWorkload(o, "insert/presized", len, [&] { return insertWorkload(o, len, true); });
+        runWorkload(o, "churn/remove+insert", len, [&] { return churnWorkload(o, len); });
+        runCacheWorkload(o, "cache/zipf/budget1%", len, [&] { return cacheWorkload(o, len, 0.01); });
+        runCacheWorkload(o, "cache/zipf/budget10%", len, [&] { return cacheWorkload(o, len, 0.10); });
+    }
+
+    if (!o.csvPath.empty()) writeCSV(o.csvPath);
+    if (!o.jsonPath.empty()) writeJSON(o.jsonPath);
+    return 0;
+}
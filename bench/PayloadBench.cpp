@@ -0,0 +1,91 @@
+/** PayloadBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Resize cost versus value size for the PayloadHashTable storage modes.
+ *  Each mode inserts n keys twice, once growing from empty and once into a
+ *  presized table.  The difference is the cost attributable to resizing.
+ *  - inline:     PayloadHashTable INLINE (values up to 8 bytes in the bucket)
+ *  - pooled:     PayloadHashTable POOLED (values in a stable pool, handles move)
+ *  - contiguous: values kept in one array that is reallocated as it grows, i.e.
+ *                what storing large values inline would cost on every resize
+ *
+ *  Usage: HashTablePayloadBench [n]
+**/
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../PayloadHashTable.h"
+
+using namespace std;
+
+template<size_t BYTES>
+struct Blob {
+    array<unsigned char, BYTES> data{};
+    Blob() = default;
+    explicit Blob(size_t seed) { data.fill(static_cast<unsigned char>(seed)); }
+};
+
+// Reference model for inline large values: the payloads share one array that
+// moves wholesale when it grows, as inline buckets would on resize
+template<typename T>
+struct ContiguousTable {
+    HashTable index;
+    vector<T> values;
+    void reserve(size_t n) {
+        index.reserve(n);
+        values.reserve(n);
+    }
+    void insert(const string& key, const T& value) {
+        index[key] = values.size();
+        values.push_back(value);
+    }
+};
+
+template<typename Table, typename T>
+static double timeInserts(const vector<string>& keys, bool presize) {
+    Table table;
+    if (presize) table.reserve(keys.size());
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) table.insert(keys[i], T(i));
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / static_cast<double>(keys.size());
+}
+
+template<typename Table, typename T>
+static void row(const char* mode, size_t bytes, const vector<string>& keys) {
+    double grow = timeInserts<Table, T>(keys, false);
+    double presized = timeInserts<Table, T>(keys, true);
+    printf("%s,%zu,%zu,%.1f,%.1f,%.1f\n", mode, bytes, keys.size(), grow, presized, grow - presized);
+}
+
+template<size_t BYTES>
+static void sizeClass(const vector<string>& keys) {
+    using T = Blob<BYTES>;
+    if constexpr (fitsInline<T>) {
+        row<PayloadHashTable<T, ValueStorage::INLINE>, T>("inline", BYTES, keys);
+    }
+    row<PayloadHashTable<T, ValueStorage::POOLED>, T>("pooled", BYTES, keys);
+    row<ContiguousTable<T>, T>("contiguous", BYTES, keys);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 200000;
+    vector<string> keys;
+    for (size_t i = 0; i < n; ++i) keys.push_back("payload:" + to_string(i));
+
+    printf("mode,value_bytes,n,grow_ns_per_insert,presized_ns_per_insert,resize_ns_per_insert\n");
+    sizeClass<8>(keys);
+    sizeClass<64>(keys);
+    sizeClass<128>(keys);
+    sizeClass<256>(keys);
+    sizeClass<512>(keys);
+    return 0;
+}
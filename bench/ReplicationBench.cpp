@@ -0,0 +1,269 @@
+/** ReplicationBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Replication lag under a heavy write load.  For each case the primary
+ *  forks a replica process connected by a socketpair, then runs a write
+ *  loop (90% operator[] assignments, 10% removes, keys uniform over the
+ *  key space) while answering the replica's pulls between writes.  The
+ *  replica pulls in a loop and notes the version it had applied after each
+ *  pull; afterwards it sends that timeline back, and each version's lag is
+ *  the time from its write until the replica had applied it.
+ *
+ *  Columns: write throughput with replication (and without, for the cost
+ *  of the feed), pulls answered as deltas and as snapshots, bytes sent to
+ *  the replica against a snapshot on every pull, how much the feed
+ *  compacted away, lag percentiles in microseconds and in versions behind
+ *  when each pull arrived, and whether the replica ended up equal to the
+ *  primary.  A small feed makes a slow replica fall back to snapshots.
+ *
+ *  Usage: HashTableReplicationBench [--writes N] [--keys K] [--feed C] [--batch B]
+ *  With no --keys/--feed, runs a default list of cases.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "../HashTable.h"
+
+using namespace std;
+
+struct Case {
+    size_t keys;
+    size_t feed;  // change feed capacity, live changes
+    size_t batch; // changes per pull
+};
+
+// Point in the replica's progress: version applied by a given time
+struct Applied {
+    uint64_t version;
+    int64_t nanos; // steady_clock, shared by both processes
+};
+
+// What the replica reports back when it is done
+struct ReplicaReport {
+    uint64_t pulls, snapshots, changes, bytes, size, checksum;
+};
+
+static int64_t nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Order-independent summary of a table's contents
+static uint64_t checksum(const HashTable& t) {
+    uint64_t sum = 0;
+    for (auto [key, value] : t) sum += hash<string_view>{}(key) * 0x9E3779B97F4A7C15ull ^ value;
+    return sum;
+}
+
+static bool writeAll(int fd, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, size_t len) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        ssize_t n = ::read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Replica process: pull until the primary's final version (sent on control)
+// is applied, then write the report and timeline to results
+static void runReplica(int sock, int control, int results, size_t batch) {
+    HashTable table;
+    HashTableReplica replica(table);
+    vector<Applied> timeline;
+    uint64_t target = UINT64_MAX, pulls = 0;
+    while (replica.pull(sock, sock, batch)) {
+        ++pulls;
+        timeline.push_back({replica.version(), nowNanos()});
+        if (target == UINT64_MAX) {
+            pollfd pfd{control, POLLIN, 0};
+            if (poll(&pfd, 1, 0) > 0 && !readAll(control, &target, sizeof(target))) break;
+        }
+        if (replica.upToDate() && replica.version() >= target) break;
+    }
+    // Hang up first: the primary is blocked waiting for the next pull, not reading results
+    close(sock);
+    ReplicaReport report{pulls, replica.snapshots(), replica.changesApplied(), replica.bytesReceived(),
+                         table.size(), checksum(table)};
+    const uint64_t count = timeline.size();
+    writeAll(results, &report, sizeof(report));
+    writeAll(results, &count, sizeof(count));
+    writeAll(results, timeline.data(), timeline.size() * sizeof(Applied));
+}
+
+static const string& keyOf(const vector<string>& keys, size_t i) {
+    return keys[i % keys.size()];
+}
+
+// The write loop alone, no feed attached
+static double writesPerSecond(const vector<string>& keys, const vector<uint32_t>& picks) {
+    HashTable primary;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < picks.size(); ++i) {
+        if (i % 10 == 9) primary.remove(keyOf(keys, picks[i]));
+        else primary[keyOf(keys, picks[i])] = i;
+    }
+    return static_cast<double>(picks.size()) / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static double percentile(vector<double>& v, double q) {
+    if (v.empty()) return 0;
+    size_t at = min(v.size() - 1, static_cast<size_t>(q * static_cast<double>(v.size())));
+    nth_element(v.begin(), v.begin() + static_cast<ptrdiff_t>(at), v.end());
+    return v[at];
+}
+
+static void runCase(const Case& c, size_t writes) {
+    vector<string> keys;
+    for (size_t i = 0; i < c.keys; ++i) keys.push_back("user:" + to_string(i * 7919 % (c.keys * 8)));
+    mt19937_64 rng(42);
+    vector<uint32_t> picks(writes);
+    for (auto& pick : picks) pick = static_cast<uint32_t>(rng() % c.keys);
+    const double baseline = writesPerSecond(keys, picks);
+
+    int sock[2], control[2], results[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sock) != 0 || pipe(control) != 0 || pipe(results) != 0) {
+        perror("socketpair/pipe");
+        return;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(sock[0]);
+        close(control[1]);
+        close(results[0]);
+        runReplica(sock[1], control[0], results[1], c.batch);
+        _exit(0);
+    }
+    close(sock[1]);
+    close(control[0]);
+    close(results[1]);
+
+    HashTableChangeFeed feed(c.feed);
+    HashTable primary;
+    primary.attachFeed(&feed);
+    vector<int64_t> writtenAt{0}; // writtenAt[v] = when version v was written
+    writtenAt.reserve(writes + 1);
+    vector<uint64_t> heads;       // feed version when each pull was answered
+    pollfd pfd{sock[0], POLLIN, 0};
+    auto serve = [&] {
+        heads.push_back(feed.version());
+        return primary.serveReplica(sock[0], sock[0]);
+    };
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < writes; ++i) {
+        if (i % 10 == 9) primary.remove(keyOf(keys, picks[i]));
+        else primary[keyOf(keys, picks[i])] = i;
+        const int64_t now = nowNanos();
+        while (writtenAt.size() <= feed.version()) writtenAt.push_back(now);
+        if (i % 64 == 0 && poll(&pfd, 1, 0) > 0) serve();
+    }
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    const uint64_t finalVersion = feed.version();
+    writeAll(control[1], &finalVersion, sizeof(finalVersion));
+    while (serve()) {
+    }
+    heads.pop_back(); // the read that found the replica gone
+
+    ReplicaReport report{};
+    uint64_t count = 0;
+    readAll(results[0], &report, sizeof(report));
+    readAll(results[0], &count, sizeof(count));
+    vector<Applied> timeline(count);
+    readAll(results[0], timeline.data(), count * sizeof(Applied));
+    waitpid(pid, nullptr, 0);
+    close(sock[0]);
+    close(control[1]);
+    close(results[0]);
+
+    // Pull i arrives holding what pull i - 1 applied
+    vector<double> behind;
+    for (size_t i = 0; i < heads.size(); ++i) {
+        const uint64_t had = i == 0 || i - 1 >= timeline.size() ? 0 : timeline[i - 1].version;
+        behind.push_back(static_cast<double>(heads[i] - min(had, heads[i])));
+    }
+    vector<double> lagMicros;
+    lagMicros.reserve(finalVersion);
+    size_t at = 0;
+    for (uint64_t v = 1; v <= finalVersion; ++v) {
+        while (at < timeline.size() && timeline[at].version < v) ++at;
+        if (at == timeline.size()) break;
+        lagMicros.push_back(static_cast<double>(timeline[at].nanos - writtenAt[v]) / 1e3);
+    }
+
+    // Bytes a snapshot of the final table takes, to compare against the deltas
+    uint64_t snapshotBytes = 9 + 3 * sizeof(uint64_t);
+    for (auto [key, value] : primary) snapshotBytes += sizeof(uint32_t) + key.size() + sizeof(uint64_t);
+    const bool match = report.size == primary.size() && report.checksum == checksum(primary);
+
+    printf("%zu,%zu,%zu,%zu,%.0f,%.0f,%llu,%llu,%llu,%llu,%.2f,%.1f,%.0f,%.0f,%.0f,%.0f,%.0f,%s\n", writes, c.keys,
+           c.feed, c.batch, baseline, static_cast<double>(writes) / seconds,
+           static_cast<unsigned long long>(report.pulls - report.snapshots),
+           static_cast<unsigned long long>(report.snapshots), static_cast<unsigned long long>(report.bytes),
+           static_cast<unsigned long long>(report.pulls * snapshotBytes),
+           static_cast<double>(feed.superseded()) / static_cast<double>(max<uint64_t>(finalVersion, 1)),
+           percentile(lagMicros, 0.5), percentile(lagMicros, 0.99), percentile(lagMicros, 0.999),
+           lagMicros.empty() ? 0.0 : *max_element(lagMicros.begin(), lagMicros.end()), percentile(behind, 0.5),
+           percentile(behind, 0.99), match ? "yes" : "NO");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    size_t writes = 1000000;
+    Case custom{0, HashTableChangeFeed::DEFAULT_CHANGES, HashTableReplica::DEFAULT_BATCH};
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        size_t value = stoul(argv[i + 1]);
+        if (arg == "--writes") writes = value;
+        else if (arg == "--keys") custom.keys = value;
+        else if (arg == "--feed") custom.feed = value;
+        else if (arg == "--batch") custom.batch = value;
+        else {
+            fprintf(stderr, "Usage: %s [--writes N] [--keys K] [--feed C] [--batch B]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    vector<Case> cases;
+    if (custom.keys > 0) {
+        cases.push_back(custom);
+    } else {
+        // Hot keys compact well; a wide key space with a small feed or small
+        // batches leaves the replica behind the feed and forces snapshots
+        cases = {{1000, 1 << 20, 65536},
+                 {100000, 1 << 20, 65536},
+                 {100000, 1 << 20, 1024},
+                 {1000000, 1 << 20, 65536},
+                 {1000000, 16384, 1024}};
+    }
+
+    printf("writes,keys,feed,batch,base_writes_per_s,repl_writes_per_s,delta_pulls,snapshot_pulls,bytes_sent,"
+           "bytes_if_snapshots,compacted,lag_p50_us,lag_p99_us,lag_p999_us,lag_max_us,behind_p50,behind_p99,match\n");
+    for (const auto& c : cases) runCase(c, writes);
+    return 0;
+}
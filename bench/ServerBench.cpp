@@ -0,0 +1,234 @@
+/** ServerBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Load generator for HashTableServer (or anything else speaking RESP).  The
+ *  keys are loaded first with pipelined SETs.  Then, for each pipeline depth
+ *  P, C client threads each open a connection and repeatedly send P requests
+ *  at once (GET of a uniformly random key with probability R, SET
+ *  otherwise) and wait for all P replies.  A round trip is one such burst;
+ *  its latency is reported per burst, so at depth P it covers P requests.
+ *
+ *  Usage: HashTableServerBench [--unix PATH | --port N] [--clients C]
+ *             [--pipeline P ...] [--requests N] [--keys K]
+ *             [--value-size V] [--get-ratio R]
+**/
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../HashTableResp.h"
+
+using namespace std;
+
+struct Target {
+    string unixPath;
+    uint16_t port = 6380;
+};
+
+static int connectTo(const Target& target) {
+    int fd;
+    if (!target.unixPath.empty()) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, target.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(target.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+        int one = 1;
+        if (fd >= 0) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    if (fd < 0) {
+        perror("connect");
+        exit(1);
+    }
+    return fd;
+}
+
+static void sendAll(int fd, const string& bytes) {
+    for (size_t sent = 0; sent < bytes.size();) {
+        ssize_t n = send(fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            perror("send");
+            exit(1);
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+// Read until `replies` replies have arrived; returns how many were null bulks (misses)
+static size_t awaitReplies(int fd, string& in, size_t replies) {
+    size_t misses = 0;
+    size_t at = 0;
+    char chunk[64 * 1024];
+    while (replies > 0) {
+        size_t length = HashTableResp::replyLength(string_view(in).substr(at));
+        if (length > 0) {
+            if (in.compare(at, 5, "$-1\r\n") == 0) ++misses;
+            if (in[at] == '-') {
+                fprintf(stderr, "server error: %.*s", static_cast<int>(length), in.data() + at);
+                exit(1);
+            }
+            at += length;
+            --replies;
+            continue;
+        }
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            fprintf(stderr, "connection closed with %zu replies outstanding\n", replies);
+            exit(1);
+        }
+        in.append(chunk, static_cast<size_t>(n));
+    }
+    in.erase(0, at);
+    return misses;
+}
+
+static string keyOf(size_t i) {
+    char key[24];
+    snprintf(key, sizeof(key), "key:%012zu", i);
+    return key;
+}
+
+static void preload(const Target& target, size_t keys, const string& value) {
+    int fd = connectTo(target);
+    string out, in;
+    constexpr size_t GROUP = 1000;
+    for (size_t first = 0; first < keys; first += GROUP) {
+        out.clear();
+        const size_t count = min(GROUP, keys - first);
+        for (size_t i = first; i < first + count; ++i) {
+            string key = keyOf(i);
+            string_view args[] = {"SET", key, value};
+            HashTableResp::appendCommand(out, args);
+        }
+        sendAll(fd, out);
+        awaitReplies(fd, in, count);
+    }
+    close(fd);
+}
+
+struct ClientResult {
+    vector<double> latencies; // microseconds per burst
+    size_t gets = 0;
+    size_t misses = 0;
+};
+
+static void runClient(const Target& target, size_t requests, size_t pipeline, size_t keys, const string& value,
+                      double getRatio, uint64_t seed, ClientResult& result) {
+    int fd = connectTo(target);
+    mt19937_64 rng(seed);
+    uniform_int_distribution<size_t> pickKey(0, keys - 1);
+    uniform_real_distribution<double> pickOp(0, 1);
+    string out, in;
+    result.latencies.reserve(requests / pipeline + 1);
+    for (size_t done = 0; done < requests;) {
+        const size_t burst = min(pipeline, requests - done);
+        out.clear();
+        for (size_t i = 0; i < burst; ++i) {
+            string key = keyOf(pickKey(rng));
+            if (pickOp(rng) < getRatio) {
+                string_view args[] = {"GET", key};
+                HashTableResp::appendCommand(out, args);
+                ++result.gets;
+            } else {
+                string_view args[] = {"SET", key, value};
+                HashTableResp::appendCommand(out, args);
+            }
+        }
+        auto start = chrono::steady_clock::now();
+        sendAll(fd, out);
+        result.misses += awaitReplies(fd, in, burst);
+        result.latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+        done += burst;
+    }
+    close(fd);
+}
+
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    Target target;
+    size_t clients = 4, requests = 1000000, keys = 100000, valueSize = 32;
+    double getRatio = 0.9;
+    vector<size_t> pipelines;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--unix" && i + 1 < argc) target.unixPath = argv[++i];
+        else if (arg == "--port" && i + 1 < argc) target.port = static_cast<uint16_t>(stoul(argv[++i]));
+        else if (arg == "--clients" && i + 1 < argc) clients = stoul(argv[++i]);
+        else if (arg == "--requests" && i + 1 < argc) requests = static_cast<size_t>(stod(argv[++i]));
+        else if (arg == "--keys" && i + 1 < argc) keys = static_cast<size_t>(stod(argv[++i]));
+        else if (arg == "--value-size" && i + 1 < argc) valueSize = stoul(argv[++i]);
+        else if (arg == "--get-ratio" && i + 1 < argc) getRatio = stod(argv[++i]);
+        else if (arg == "--pipeline") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') pipelines.push_back(stoul(argv[++i]));
+        }
+    }
+    if (pipelines.empty()) pipelines = {1, 4, 16, 64, 256};
+    clients = max<size_t>(clients, 1);
+    keys = max<size_t>(keys, 1);
+
+    const string value(valueSize, 'v');
+    preload(target, keys, value);
+
+    printf("pipeline,clients,requests,seconds,kops_per_s,burst_p50_us,burst_p99_us,burst_p999_us,get_hit_rate\n");
+    for (size_t pipeline : pipelines) {
+        pipeline = max<size_t>(pipeline, 1);
+        vector<ClientResult> results(clients);
+        vector<thread> threads;
+        auto start = chrono::steady_clock::now();
+        for (size_t c = 0; c < clients; ++c) {
+            threads.emplace_back(runClient, cref(target), requests / clients, pipeline, keys, cref(value), getRatio,
+                                 c + 1, ref(results[c]));
+        }
+        for (auto& t : threads) t.join();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        vector<double> latencies;
+        size_t gets = 0, misses = 0;
+        for (const auto& r : results) {
+            latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+            gets += r.gets;
+            misses += r.misses;
+        }
+        sort(latencies.begin(), latencies.end());
+        const size_t sent = requests / clients * clients;
+        printf("%zu,%zu,%zu,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f\n", pipeline, clients, sent, seconds,
+               static_cast<double>(sent) / seconds / 1e3, percentile(latencies, 0.5), percentile(latencies, 0.99),
+               percentile(latencies, 0.999), gets ? 1.0 - static_cast<double>(misses) / static_cast<double>(gets) : 0.0);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+/** SetOpsBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Bulk set operations against the keys()-based loops they replace.  Table A
+ *  holds keys 0..n-1 and B holds n/2..3n/2-1, so half of each overlaps.  For
+ *  each operation both versions start from a fresh copy of A; the copy is
+ *  not timed.  Results are checked against each other.
+ *  - union:     mergeFrom(B)       vs  keys() of B, contains + insert into A
+ *  - intersect: intersectWith(B)   vs  keys() of A, remove those B lacks
+ *  - subtract:  subtract(B)        vs  keys() of B, remove each from A
+ *  - erase_if:  eraseIf(odd value) vs  keys() of A, get + remove
+ *
+ *  Usage: HashTableSetOpsBench [n ...] [--keylen L]
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../HashTable.h"
+
+using namespace std;
+
+static string makeKey(size_t i, size_t len) {
+    string key = "k" + to_string(i) + ":";
+    key.resize(max(len, key.size()), 'x');
+    return key;
+}
+
+static double seconds(const function<void()>& body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static void runSize(size_t n, size_t keyLen) {
+    HashTable a, b;
+    a.reserve(n);
+    b.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[makeKey(i, keyLen)] = i; // operator[] takes every value, unlike insert (9999)
+        b[makeKey(i + n / 2, keyLen)] = i + n / 2 + 1;
+    }
+
+    auto isOdd = [](string_view, size_t value) { return value % 2 == 1; };
+    struct Case {
+        const char* name;
+        function<void(HashTable&)> loop;
+        function<void(HashTable&)> native;
+    };
+    vector<Case> cases = {
+        {"union",
+         [&](HashTable& t) {
+             for (const auto& key : b.keys()) {
+                 if (!t.contains(key)) t.insert(key, *b.get(key));
+             }
+         },
+         [&](HashTable& t) { t.mergeFrom(b); }},
+        {"intersect",
+         [&](HashTable& t) {
+             for (const auto& key : t.keys()) {
+                 if (!b.contains(key)) t.remove(key);
+             }
+         },
+         [&](HashTable& t) { t.intersectWith(b); }},
+        {"subtract",
+         [&](HashTable& t) {
+             for (const auto& key : b.keys()) t.remove(key);
+         },
+         [&](HashTable& t) { t.subtract(b); }},
+        {"erase_if",
+         [&](HashTable& t) {
+             for (const auto& key : t.keys()) {
+                 if (isOdd(key, *t.get(key))) t.remove(key);
+             }
+         },
+         [&](HashTable& t) { t.eraseIf(isOdd); }},
+    };
+
+    for (const auto& c : cases) {
+        double loopSec, nativeSec;
+        size_t loopSize, nativeSize;
+        {
+            HashTable t = a;
+            loopSec = seconds([&] { c.loop(t); });
+            loopSize = t.size();
+        }
+        {
+            HashTable t = a;
+            nativeSec = seconds([&] { c.native(t); });
+            nativeSize = t.size();
+        }
+        printf("%zu,%zu,%s,%.3f,%.3f,%.1f,%s\n", n, keyLen, c.name, loopSec, nativeSec, loopSec / nativeSec,
+               loopSize == nativeSize ? "yes" : "NO");
+        fflush(stdout);
+    }
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes;
+    size_t keyLen = 16;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--keylen" && i + 1 < argc) keyLen = stoul(argv[++i]);
+        else sizes.push_back(stoul(arg));
+    }
+    if (sizes.empty()) sizes = {10000000};
+
+    printf("n,key_len,op,keys_loop_s,native_s,speedup,sizes_match\n");
+    for (size_t n : sizes) runSize(n, keyLen);
+    return 0;
+}
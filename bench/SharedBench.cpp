@@ -0,0 +1,209 @@
+/** SharedBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  P reader processes looking keys up in the same N-key table, three ways:
+ *  - copies: every process builds its own HashTable with insert()
+ *  - shared: one SharedHashTable segment built by the parent; the readers
+ *            attach to it by name
+ *  - shared+writer: the same, while a writer process keeps assigning new
+ *    values through the seqlock for as long as the readers run
+ *  Each reader does M lookups of uniformly random keys, every one a hit,
+ *  then reports its lookups per CPU second (readers may share cores) and
+ *  its memory from /proc/self/smaps_rollup:
+ *  RSS counts shared pages in full in every process that touched them, PSS
+ *  splits them between those processes, so summed PSS is the real footprint.
+ *
+ *  Usage: HashTableSharedBench [--keys N] [--procs P] [--lookups M]
+**/
+
+#include <atomic>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "../HashTable.h"
+#include "../SharedHashTable.h"
+
+using namespace std;
+
+// Keys are "user:" and 12 digits, 17 bytes: past the inline string buffer,
+// so a HashTable copy keeps them on the heap like real keys of that size
+static constexpr size_t KEY_LENGTH = 17;
+
+static string_view keyOf(size_t i, char* buffer) {
+    memcpy(buffer, "user:", 5);
+    for (size_t d = KEY_LENGTH; d-- > 5; i /= 10) buffer[d] = static_cast<char>('0' + i % 10);
+    return {buffer, KEY_LENGTH};
+}
+
+// HashTable::insert refuses the value 9999, so no key gets it
+static size_t valueOf(size_t i) {
+    return 2 * i;
+}
+
+struct Report {
+    double buildSeconds = 0;
+    double lookupsPerSecond = 0;
+    double rssMB = 0, pssMB = 0;
+    uint64_t hits = 0, retries = 0;
+};
+
+// Rss and Pss of this process in MB
+static void memoryOf(Report& r) {
+    ifstream rollup("/proc/self/smaps_rollup");
+    string line;
+    while (getline(rollup, line)) {
+        double kb = 0;
+        if (sscanf(line.c_str(), "Rss: %lf", &kb) == 1) r.rssMB = kb / 1024;
+        else if (sscanf(line.c_str(), "Pss: %lf", &kb) == 1) r.pssMB = kb / 1024;
+    }
+}
+
+// CPU seconds used by this process; readers share cores, so rates are per CPU second
+static double cpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+template<typename Table>
+static void lookups(const Table& table, size_t keys, size_t count, uint64_t seed, Report& r) {
+    mt19937_64 rng(seed);
+    char buffer[KEY_LENGTH];
+    const double start = cpuSeconds();
+    for (size_t i = 0; i < count; ++i) r.hits += table.get(keyOf(rng() % keys, buffer)).has_value();
+    r.lookupsPerSecond = static_cast<double>(count) / (cpuSeconds() - start);
+    memoryOf(r); // while the table is still mapped
+}
+
+// Fork P readers running body(index, report) and collect their reports
+template<typename Body>
+static vector<Report> forkReaders(size_t procs, Body body) {
+    vector<pair<pid_t, int>> children;
+    for (size_t p = 0; p < procs; ++p) {
+        int fds[2];
+        if (pipe(fds) != 0) break;
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            Report r;
+            body(p, r);
+            ssize_t ignored = write(fds[1], &r, sizeof(r));
+            (void)ignored;
+            _exit(0);
+        }
+        close(fds[1]);
+        children.push_back({pid, fds[0]});
+    }
+    vector<Report> reports;
+    for (auto [pid, fd] : children) {
+        Report r;
+        if (read(fd, &r, sizeof(r)) == sizeof(r)) reports.push_back(r);
+        close(fd);
+        waitpid(pid, nullptr, 0);
+    }
+    return reports;
+}
+
+static void print(const char* mode, size_t keys, size_t procs, size_t count, double buildSeconds,
+                  const vector<Report>& reports, double segmentMB, uint64_t writes) {
+    Report sum;
+    for (const auto& r : reports) {
+        sum.buildSeconds += r.buildSeconds;
+        sum.lookupsPerSecond += r.lookupsPerSecond;
+        sum.rssMB += r.rssMB;
+        sum.pssMB += r.pssMB;
+        sum.hits += r.hits;
+        sum.retries += r.retries;
+    }
+    const double n = static_cast<double>(max<size_t>(reports.size(), 1));
+    printf("%s,%zu,%zu,%.2f,%.2f,%.1f,%.1f,%.1f,%.1f,%llu,%llu,%s\n", mode, keys, procs,
+           buildSeconds + sum.buildSeconds / n, sum.lookupsPerSecond / n / 1e6, sum.rssMB / n, sum.pssMB / n,
+           sum.pssMB, segmentMB, static_cast<unsigned long long>(sum.retries),
+           static_cast<unsigned long long>(writes), sum.hits == reports.size() * count && reports.size() == procs ? "yes" : "NO");
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    size_t keys = 1000000, procs = 4, count = 5000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i];
+        size_t value = stoul(argv[i + 1]);
+        if (arg == "--keys") keys = value;
+        else if (arg == "--procs") procs = value;
+        else if (arg == "--lookups") count = value;
+        else {
+            fprintf(stderr, "Usage: %s [--keys N] [--procs P] [--lookups M]\n", argv[0]);
+            return 2;
+        }
+    }
+    printf("mode,keys,procs,build_cpu_s,mlookups_per_cpu_s,rss_mb_each,pss_mb_each,pss_mb_total,segment_mb,retries,"
+           "writes,all_hit\n");
+
+    vector<Report> reports = forkReaders(procs, [&](size_t p, Report& r) {
+        const double start = cpuSeconds();
+        HashTable table;
+        char buffer[KEY_LENGTH];
+        for (size_t i = 0; i < keys; ++i) table.insert(keyOf(i, buffer), valueOf(i));
+        r.buildSeconds = cpuSeconds() - start;
+        lookups(table, keys, count, p + 1, r);
+    });
+    print("copies", keys, procs, count, 0, reports, 0, 0);
+
+    const string name = "/hashtable-bench-" + to_string(getpid());
+    for (bool withWriter : {false, true}) {
+        const double start = cpuSeconds();
+        SharedHashTable table(name, keys, keys * KEY_LENGTH);
+        if (!table.isOpen()) {
+            fprintf(stderr, "cannot create shared memory segment %s\n", name.c_str());
+            return 1;
+        }
+        char buffer[KEY_LENGTH];
+        for (size_t i = 0; i < keys; ++i) table.insert(keyOf(i, buffer), valueOf(i));
+        const double buildSeconds = cpuSeconds() - start;
+
+        // The writer is a child holding the creator's mapping, so this process
+        // can wait on the readers; it counts its writes in an anonymous shared page
+        auto* control = static_cast<atomic<uint64_t>*>(
+            mmap(nullptr, 2 * sizeof(atomic<uint64_t>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+        atomic<uint64_t>& writes = control[0];
+        atomic<uint64_t>& stop = control[1];
+        pid_t writerPid = -1;
+        if (withWriter) {
+            writerPid = fork();
+            if (writerPid == 0) {
+                mt19937_64 rng(99);
+                while (stop.load(memory_order_relaxed) == 0) {
+                    const size_t k = rng() % keys;
+                    table.assign(keyOf(k, buffer), valueOf(k));
+                    writes.fetch_add(1, memory_order_relaxed);
+                }
+                _exit(0);
+            }
+        }
+
+        reports = forkReaders(procs, [&](size_t p, Report& r) {
+            SharedHashTable reader(name);
+            lookups(reader, keys, count, p + 1, r);
+            r.retries = reader.retries();
+        });
+        stop = 1;
+        if (writerPid > 0) waitpid(writerPid, nullptr, 0);
+        print(withWriter ? "shared+writer" : "shared", keys, procs, count, buildSeconds, reports,
+              static_cast<double>(table.segmentBytes()) / (1 << 20), writes.load());
+        munmap(control, 2 * sizeof(atomic<uint64_t>));
+        SharedHashTable::unlink(name);
+    }
+    return 0;
+}
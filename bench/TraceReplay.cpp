@@ -0,0 +1,264 @@
+/** TraceReplay.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Replays a HashTableTrace file against one or more table configurations,
+ *  so they can be compared on recorded traffic instead of a synthetic mix.
+ *  Each configuration starts from an empty table (or, with --prefill, one
+ *  holding every key the trace reads before writing it) and runs the trace
+ *  twice: once untimed per op for ns/op and ops/s, once with every op timed
+ *  for the p50/p99/p99.9 latencies.  Every configuration must see the same
+ *  number of hits; a mismatch means the engines disagree.
+ *
+ *  A configuration is an engine followed by comma-separated options:
+ *    ht | cuckoo | chained | std
+ *                           HashTable, CuckooHashTable, ChainedHashTable,
+ *                           std::unordered_map
+ *    load=L                 presize for at most load L at the end (L <= 0.5
+ *                           for ht, which resizes at 0.5)
+ *    bloom=B                HashTable Bloom filter, B bits per key
+ *    hash=sip               HashTable on keyed SipHash from the start
+ *    trace                  HashTable recording its own trace, to measure
+ *                           what tracing costs
+ *
+ *  Usage: HashTableTraceReplay TRACE [--prefill] [CONFIG ...]
+ *  Default configurations: ht ht,load=0.25 ht,hash=sip ht,bloom=10 ht,trace cuckoo chained std
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "../ChainedHashTable.h"
+#include "../CuckooHashTable.h"
+#include "../HashTable.h"
+
+using namespace std;
+
+struct Config {
+    string name;
+    string engine = "ht";
+    double load = 0;
+    size_t bloomBits = 0;
+    bool sipHash = false;
+    bool trace = false;
+};
+
+static bool parseConfig(const string& text, Config& config) {
+    config = Config{};
+    config.name = text;
+    size_t at = 0;
+    bool first = true;
+    while (at <= text.size()) {
+        size_t comma = text.find(',', at);
+        if (comma == string::npos) comma = text.size();
+        string part = text.substr(at, comma - at);
+        at = comma + 1;
+        if (first) {
+            if (part != "ht" && part != "cuckoo" && part != "chained" && part != "std") return false;
+            config.engine = part;
+            first = false;
+        } else if (part.rfind("load=", 0) == 0) {
+            config.load = stod(part.substr(5));
+        } else if (part.rfind("bloom=", 0) == 0) {
+            config.bloomBits = stoul(part.substr(6));
+        } else if (part == "hash=sip") {
+            config.sipHash = true;
+        } else if (part == "trace") {
+            config.trace = true;
+        } else {
+            return false;
+        }
+    }
+    return config.engine == "ht" || (config.bloomBits == 0 && !config.sipHash && !config.trace);
+}
+
+// The trace with its keys made up once, outside the timed loops
+struct Prepared {
+    vector<string> keys;      // one per distinct key
+    vector<uint32_t> keyOf;   // per op, index into keys
+    vector<TraceOp> ops;
+    vector<uint32_t> prefill; // keys whose first op reads them
+};
+
+static Prepared prepare(const HashTableTraceData& data) {
+    Prepared p;
+    unordered_map<uint64_t, uint32_t> seen; // (hash, length) -> key index
+    for (const auto& r : data.records) {
+        const uint64_t id = r.keyHash ^ (static_cast<uint64_t>(r.keyLength) * 0x9E3779B97F4A7C15ull);
+        auto [it, added] = seen.try_emplace(id, static_cast<uint32_t>(p.keys.size()));
+        const TraceOp op = static_cast<TraceOp>(r.op);
+        if (added) {
+            p.keys.push_back(HashTableTrace::keyFor(r));
+            if (op == TraceOp::GET || op == TraceOp::REMOVE) p.prefill.push_back(it->second);
+        }
+        p.keyOf.push_back(it->second);
+        p.ops.push_back(op);
+    }
+    return p;
+}
+
+struct Result {
+    double nsPerOp = 0;
+    double p50 = 0, p99 = 0, p999 = 0;
+    size_t hits = 0;
+    size_t size = 0;
+};
+
+using StdMap = unordered_map<string, size_t>;
+
+template<typename Table>
+static Table makeTable(const Config& config, const Prepared& p) {
+    Table t;
+    if constexpr (is_same_v<Table, StdMap>) {
+        if (config.load > 0) {
+            t.max_load_factor(static_cast<float>(config.load));
+            t.reserve(p.keys.size());
+        }
+    } else if constexpr (is_same_v<Table, HashTable>) {
+        // reserve(n) gives capacity bit_ceil(2n + 1), so n = keys / (2 load) caps the load at `load`
+        if (config.load > 0) t.reserve(static_cast<size_t>(ceil(static_cast<double>(p.keys.size()) / (2 * config.load))));
+        if (config.bloomBits > 0) t.setBloomFilter(config.bloomBits);
+        if (config.sipHash) t.useKeyedHash();
+    } else {
+        if (config.load > 0) t.reserve(static_cast<size_t>(ceil(static_cast<double>(p.keys.size()) * 0.95 / config.load)));
+    }
+    return t;
+}
+
+// One op; returns 1 for a GET or REMOVE that found its key
+template<typename Table>
+static size_t apply(Table& t, TraceOp op, const string& key) {
+    if constexpr (is_same_v<Table, StdMap>) {
+        switch (op) {
+            case TraceOp::INSERT: t.emplace(key, 1); return 0;
+            case TraceOp::GET: return t.find(key) != t.end();
+            case TraceOp::REMOVE: return t.erase(key);
+            case TraceOp::ASSIGN: ++t[key]; return 0;
+        }
+    } else {
+        switch (op) {
+            case TraceOp::INSERT: t.insert(key, 1); return 0;
+            case TraceOp::GET: return t.get(key).has_value();
+            case TraceOp::REMOVE: return t.remove(key);
+            case TraceOp::ASSIGN: ++t[key]; return 0;
+        }
+    }
+    return 0;
+}
+
+template<typename Table>
+static Result replay(const Config& config, const Prepared& p, bool prefill) {
+    Result r;
+    vector<double> latencies(p.ops.size());
+    string tracePath;
+    for (int pass = 0; pass < 2; ++pass) {
+        Table t = makeTable<Table>(config, p);
+        if (prefill) {
+            for (uint32_t k : p.prefill) apply(t, TraceOp::INSERT, p.keys[k]);
+        }
+        optional<HashTableTrace> trace;
+        if constexpr (is_same_v<Table, HashTable>) {
+            if (config.trace) {
+                tracePath = "/tmp/hashtable-replay-" + to_string(getpid()) + ".trace";
+                trace.emplace(tracePath, p.ops.size());
+                t.attachTrace(&*trace);
+            }
+        }
+        size_t hits = 0;
+        if (pass == 0) {
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < p.ops.size(); ++i) hits += apply(t, p.ops[i], p.keys[p.keyOf[i]]);
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            r.nsPerOp = ns / static_cast<double>(max<size_t>(p.ops.size(), 1));
+            r.hits = hits;
+            r.size = t.size();
+        } else {
+            for (size_t i = 0; i < p.ops.size(); ++i) {
+                auto start = chrono::steady_clock::now();
+                hits += apply(t, p.ops[i], p.keys[p.keyOf[i]]);
+                latencies[i] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+            }
+        }
+    }
+    if (!tracePath.empty()) unlink(tracePath.c_str());
+    sort(latencies.begin(), latencies.end());
+    auto pct = [&](double q) {
+        return latencies.empty() ? 0.0 : latencies[min(latencies.size() - 1, static_cast<size_t>(q * static_cast<double>(latencies.size())))];
+    };
+    r.p50 = pct(0.5);
+    r.p99 = pct(0.99);
+    r.p999 = pct(0.999);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s TRACE [--prefill] [CONFIG ...]\n", argv[0]);
+        return 2;
+    }
+    bool prefill = false;
+    vector<Config> configs;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--prefill") {
+            prefill = true;
+            continue;
+        }
+        Config config;
+        if (!parseConfig(arg, config)) {
+            fprintf(stderr, "bad configuration '%s'\n", arg.c_str());
+            return 2;
+        }
+        configs.push_back(config);
+    }
+    if (configs.empty()) {
+        for (const char* spec : {"ht", "ht,load=0.25", "ht,hash=sip", "ht,bloom=10", "ht,trace", "cuckoo", "chained", "std"}) {
+            configs.emplace_back();
+            parseConfig(spec, configs.back());
+        }
+    }
+
+    optional<HashTableTraceData> data = HashTableTrace::load(argv[1]);
+    if (!data) {
+        fprintf(stderr, "%s is not a readable trace\n", argv[1]);
+        return 1;
+    }
+    const Prepared p = prepare(*data);
+    size_t counts[5] = {};
+    for (TraceOp op : p.ops) {
+        if (static_cast<size_t>(op) < 5) ++counts[static_cast<size_t>(op)];
+    }
+    double spanSeconds = 0;
+    if (!data->records.empty()) {
+        spanSeconds = static_cast<double>(data->records.back().ticks - data->records.front().ticks) * data->tickNanos / 1e9;
+    }
+    printf("# %zu ops (%llu overwritten), %zu distinct keys; insert %zu, get %zu, remove %zu, operator[] %zu; "
+           "recorded over %.3f s\n",
+           p.ops.size(), static_cast<unsigned long long>(data->overwritten), p.keys.size(),
+           counts[static_cast<size_t>(TraceOp::INSERT)], counts[static_cast<size_t>(TraceOp::GET)],
+           counts[static_cast<size_t>(TraceOp::REMOVE)], counts[static_cast<size_t>(TraceOp::ASSIGN)], spanSeconds);
+
+    printf("config,ops,ns_per_op,mops_per_s,p50_ns,p99_ns,p999_ns,hits,final_size\n");
+    for (const auto& config : configs) {
+        Result r;
+        if (config.engine == "ht") r = replay<HashTable>(config, p, prefill);
+        else if (config.engine == "cuckoo") r = replay<CuckooHashTable>(config, p, prefill);
+        else if (config.engine == "chained") r = replay<ChainedHashTable>(config, p, prefill);
+        else r = replay<StdMap>(config, p, prefill);
+        printf("%s,%zu,%.1f,%.2f,%.0f,%.0f,%.0f,%zu,%zu\n", config.name.c_str(), p.ops.size(), r.nsPerOp,
+               1e3 / r.nsPerOp, r.p50, r.p99, r.p999, r.hits, r.size);
+        fflush(stdout);
+    }
+    return 0;
+}
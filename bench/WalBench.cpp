@@ -0,0 +1,78 @@
+/** WalBench.cpp
+ *
+ *  Charlie Must
+ *  CS3100 Data Structures and Algorithms
+ *  Dr. James Anderson
+ *  Fall 2025
+ *  project4-HashTable
+ *
+ *  Durable-insert throughput of a HashTable with an attached write-ahead log
+ *  for several group-commit sizes and sync policies.
+ *
+ *  Usage: HashTableWalBench [log directory] [inserts per run]
+**/
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../HashTable.h"
+
+using namespace std;
+
+struct WalRun {
+    string label;
+    SyncPolicy policy;
+    size_t groupSize;
+};
+
+static double runInserts(const string& logPath, const WalRun& run, size_t count, size_t& syncs) {
+    ::remove(logPath.c_str());
+    HashTable ht(count * 2);
+    HashTableLog wal(logPath, run.policy, run.groupSize);
+    ht.attachLog(&wal);
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        ht.insert("key:" + to_string(i), i);
+    }
+    ht.syncLog();
+    auto stop = chrono::steady_clock::now();
+
+    syncs = wal.syncs();
+    ht.attachLog(nullptr);
+    return chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+    string dir = argc > 1 ? argv[1] : ".";
+    size_t count = argc > 2 ? stoul(argv[2]) : 20000;
+    string logPath = dir + "/wal_bench.log";
+
+    vector<WalRun> runs = {
+        {"every_op/group=1", SyncPolicy::EVERY_OP, 1},
+        {"every_op/group=8", SyncPolicy::EVERY_OP, 8},
+        {"every_op/group=64", SyncPolicy::EVERY_OP, 64},
+        {"every_op/group=512", SyncPolicy::EVERY_OP, 512},
+        {"every_op/group=4096", SyncPolicy::EVERY_OP, 4096},
+        {"interval/10ms", SyncPolicy::INTERVAL, 1},
+        {"never", SyncPolicy::NEVER, 1},
+    };
+
+    cout << "policy,inserts,seconds,ops_per_sec,fdatasyncs" << endl;
+    for (const auto& run : runs) {
+        size_t syncs = 0;
+        double secs = runInserts(logPath, run, count, syncs);
+        cout << run.label << "," << count << "," << secs << ","
+             << static_cast<size_t>(count / secs) << "," << syncs << endl;
+    }
+
+    // Recovery sanity check: replay the last log into a fresh table
+    HashTable recovered;
+    size_t replayed = recovered.recover(dir + "/wal_bench.snapshot", logPath);
+    cout << "recovered " << replayed << " records, size " << recovered.size() << endl;
+
+    ::remove(logPath.c_str());
+    return 0;
+}